@@ -441,7 +441,7 @@ void wiz_light(struct chunk *c, bool full)
 					if (!square_isfloor(c, yy, xx) || 
 						square_isvisibletrap(c, yy, xx)) {
 						square_memorize(c, yy, xx);
-						square_mark(cave, yy, xx);
+						square_mark(c, yy, xx);
 					}
 				}
 			}
@@ -538,177 +538,457 @@ void cave_illuminate(struct chunk *c, bool daytime)
 }
 
 /**
- * Size of the circular queue used by "update_flow()"
+ * A grid waiting in a flow field's queue
  */
-#define FLOW_MAX 2048
+struct flow_entry {
+	int idx;
+	int next;
+};
 
-/*
- * Hack -- provide some "speed" for the "flow" code
- * This entry is the "current index" for the "when" field
- * Note that a "when" value of "zero" means "not used".
- *
- * Note that the "cost" indexes from 1 to 127 are for
- * "old" data, and from 128 to 255 are for "new" data.
- *
- * This means that as long as the player does not "teleport",
- * then any monster up to 128 + z_info->max_flow_depth will be
- * able to track down the player, and in general, will be
- * able to track down either the player or a position recently
- * occupied by the player.
+/**
+ * Allocate a flow field for a chunk, counting steps up to "depth", and have
+ * the chunk tell it about changes to its terrain
  */
-static int flow_save = 0;
-
+struct flow *flow_new(struct chunk *c, int depth)
+{
+	struct flow *f = mem_zalloc(sizeof(*f));
+	int i, n = c->height * c->width;
+
+	assert(depth > 0 && depth < FLOW_FAR);
+
+	f->height = c->height;
+	f->width = c->width;
+	f->depth = depth;
+	f->dist = mem_alloc(n * sizeof(u16b));
+	for (i = 0; i < n; i++)
+		f->dist[i] = FLOW_FAR;
+	f->mark = mem_zalloc(n * sizeof(u32b));
+	f->head = mem_alloc(depth * sizeof(int));
+	for (i = 0; i < depth; i++)
+		f->head[i] = -1;
+
+	f->next = c->flows;
+	c->flows = f;
+
+	return f;
+}
 
+/**
+ * Free a flow field, and take it off its chunk's list
+ */
+void flow_free(struct chunk *c, struct flow *f)
+{
+	struct flow **link = &c->flows;
+
+	while (*link != f)
+		link = &(*link)->next;
+	*link = f->next;
+
+	mem_free(f->dist);
+	mem_free(f->mark);
+	mem_free(f->entry);
+	mem_free(f->head);
+	mem_free(f->changed);
+	mem_free(f->left);
+	mem_free(f->left_dist);
+	mem_free(f->grids);
+	mem_free(f);
+}
 
 /**
- * Forget the "flow" information ready for a complete update
+ * Tell every flow field on a chunk that (y, x) has started or stopped
+ * blocking the flow, so that the next update repairs the field around it
  */
-void cave_forget_flow(struct chunk *c)
+void flow_note_change(struct chunk *c, int y, int x)
 {
-	int x, y;
+	struct flow *f;
 
-	/* Nothing to forget */
-	if (!flow_save) return;
+	for (f = c->flows; f; f = f->next) {
+		/* Nothing to repair yet */
+		if (!f->sourced) continue;
 
-	/* Check the entire dungeon */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			/* Forget the old data */
-			c->squares[y][x].cost = 0;
-			c->squares[y][x].when = 0;
+		if (f->changed_n == f->changed_max) {
+			f->changed_max = f->changed_max ? 2 * f->changed_max : 16;
+			f->changed = mem_realloc(f->changed,
+									 f->changed_max * sizeof(int));
 		}
+		f->changed[f->changed_n++] = y * f->width + x;
 	}
+}
 
-	/* Start over */
-	flow_save = 0;
+/**
+ * Queue grid idx at distance d
+ */
+static void flow_push(struct flow *f, int d, int idx)
+{
+	if (f->entry_n == f->entry_max) {
+		f->entry_max = f->entry_max ? 2 * f->entry_max : 256;
+		f->entry = mem_realloc(f->entry,
+							   f->entry_max * sizeof(struct flow_entry));
+	}
+	f->entry[f->entry_n].idx = idx;
+	f->entry[f->entry_n].next = f->head[d];
+	f->head[d] = f->entry_n++;
 }
 
+/**
+ * Take the next grid queued at distance d, or -1 if there are none
+ */
+static int flow_pop(struct flow *f, int d)
+{
+	int e = f->head[d];
 
-/*
- * Hack -- fill in the "cost" field of every grid that the player can
- * "reach" with the number of steps needed to reach that grid.  This
- * also yields the "distance" of the player from every grid.
- *
- * In addition, mark the "when" of the grids that can reach the player
- * with the incremented value of "flow_save".
- *
- * Hack -- use the local "flow_y" and "flow_x" arrays as a "circular
- * queue" of cave grids.
+	if (e < 0) return -1;
+	f->head[d] = f->entry[e].next;
+	return f->entry[e].idx;
+}
+
+/**
+ * The grid next to idx in direction d, or -1 if it is off the chunk
+ */
+static int flow_next(struct chunk *c, struct flow *f, int idx, int d)
+{
+	int y = idx / f->width + ddy_ddd[d];
+	int x = idx % f->width + ddx_ddd[d];
+
+	if (!square_in_bounds(c, y, x)) return -1;
+	return y * f->width + x;
+}
+
+/**
+ * Whether the flow can't enter grid idx; walls and rubble (anything with
+ * TF_NO_FLOW) block it, but the source is always reached
+ */
+static bool flow_blocked(struct chunk *c, struct flow *f, int idx)
+{
+	if (idx == f->source.y * f->width + f->source.x) return false;
+	return tf_has(f_info[c->squares[0][idx].feat].flags, TF_NO_FLOW);
+}
+
+/**
+ * Process the queued grids in order of distance, passing shorter distances
+ * on to their neighbours.
  *
  * We do not need a priority queue because the cost from grid to grid
- * is always "one" (even along diagonals) and we process them in order.
+ * is always "one" (even along diagonals), so a queue for each distance will
+ * do; a grid queued again at a shorter distance is skipped at the longer.
  */
-void cave_update_flow(struct chunk *c)
+static void flow_settle(struct chunk *c, struct flow *f)
 {
-	int py = player->py;
-	int px = player->px;
+	int d, i, idx;
 
-	int ty, tx;
+	for (d = 0; d < f->depth; d++) {
+		while ((idx = flow_pop(f, d)) >= 0) {
+			if (f->dist[idx] != d) continue;
 
-	int y, x;
+			/* Limit flow depth */
+			if (d + 1 >= f->depth) continue;
 
-	int n, d;
+			for (i = 0; i < 8; i++) {
+				int next = flow_next(c, f, idx, i);
 
-	int flow_n;
+				if (next < 0 || flow_blocked(c, f, next)) continue;
+				if (f->dist[next] <= d + 1) continue;
 
-	int flow_tail = 0;
-	int flow_head = 0;
+				f->dist[next] = d + 1;
+				flow_push(f, d + 1, next);
+			}
+		}
+	}
+	f->entry_n = 0;
+}
 
-	byte flow_y[FLOW_MAX];
-	byte flow_x[FLOW_MAX];
+/**
+ * Queue grid idx to be checked by flow_cut(), unless it is out of reach or
+ * already queued
+ */
+static void flow_queue_cut(struct flow *f, int idx)
+{
+	if (f->dist[idx] == FLOW_FAR || f->mark[idx] == f->mark_stamp) return;
+	f->mark[idx] = f->mark_stamp;
+	flow_push(f, f->dist[idx], idx);
+}
 
+/**
+ * Take out of reach every queued grid which is now blocked or no longer has
+ * a neighbour one step nearer the source, then do the same for the grids one
+ * step further away which might have depended on it.  Going in order of
+ * distance means a grid's nearer neighbours have all been checked before it.
+ */
+static void flow_cut(struct chunk *c, struct flow *f)
+{
+	int source = f->source.y * f->width + f->source.x;
+	int d, i, idx;
 
-	/*** Cycle the flow ***/
+	for (d = 0; d < f->depth; d++) {
+		while ((idx = flow_pop(f, d)) >= 0) {
+			if (idx == source) continue;
 
-	/* Cycle the flow */
-	if (flow_save++ == 255)
-	{
-		/* Cycle the flow */
-		for (y = 0; y < c->height; y++)
-		{
-			for (x = 0; x < c->width; x++)
-			{
-				int w = c->squares[y][x].when;
-				c->squares[y][x].when = (w >= 128) ? (w - 128) : 0;
+			/* Still one step further than some neighbour */
+			if (d > 0 && !flow_blocked(c, f, idx)) {
+				for (i = 0; i < 8; i++) {
+					int next = flow_next(c, f, idx, i);
+
+					if (next >= 0 && f->dist[next] == d - 1) break;
+				}
+				if (i < 8) continue;
+			}
+
+			/* Remember what it was, in case it stays out of reach */
+			if (f->left_n == f->left_max) {
+				f->left_max = f->left_max ? 2 * f->left_max : 64;
+				f->left = mem_realloc(f->left, f->left_max * sizeof(int));
+				f->left_dist = mem_realloc(f->left_dist,
+										   f->left_max * sizeof(u16b));
+			}
+			f->left[f->left_n] = idx;
+			f->left_dist[f->left_n++] = d;
+			f->dist[idx] = FLOW_FAR;
+
+			/* Check the grids which may have been reached through it */
+			for (i = 0; i < 8; i++) {
+				int next = flow_next(c, f, idx, i);
+
+				if (next >= 0 && f->dist[next] == d + 1)
+					flow_queue_cut(f, next);
 			}
 		}
+	}
+	f->entry_n = 0;
+}
+
+/**
+ * Give grid idx a distance one more than its nearest neighbour in reach, and
+ * queue it to pass that on
+ */
+static void flow_reach(struct chunk *c, struct flow *f, int idx)
+{
+	int i, best = FLOW_FAR;
 
-		/* Restart */
-		flow_save = 128;
+	if (flow_blocked(c, f, idx)) return;
+
+	for (i = 0; i < 8; i++) {
+		int next = flow_next(c, f, idx, i);
+
+		if (next >= 0 && f->dist[next] != FLOW_FAR &&
+			f->dist[next] + 1 < best)
+			best = f->dist[next] + 1;
 	}
 
-	/* Local variable */
-	flow_n = flow_save;
+	if (best < f->depth && best < f->dist[idx]) {
+		f->dist[idx] = best;
+		flow_push(f, best, idx);
+	}
+}
 
+/**
+ * Bring a flow field up to date, so that every grid which can be reached
+ * from (y, x) in fewer than the field's depth of steps has the number of
+ * steps needed, and every other grid is out of reach.
+ *
+ * The previous distances are repaired rather than thrown away:
+ * - distances from the new source which are shorter than the old ones are
+ *   passed outwards from it;
+ * - grids which can no longer have their old distance, because they were
+ *   reached through the old source or through terrain which now blocks the
+ *   flow, are taken out of reach by flow_cut();
+ * - those grids, and grids which no longer block the flow (even if the first
+ *   step reached them the long way round), are given distances again from
+ *   their neighbours, and pass them on.
+ * The result is the same as a breadth-first search from scratch, but only
+ * the grids whose distance changes (and their neighbours) are visited.
+ *
+ * Grids which were in reach before the update and are not after it are left
+ * in f->left, with their old distances in f->left_dist.
+ */
+void flow_update(struct chunk *c, struct flow *f, int y, int x)
+{
+	int source = y * f->width + x;
+	int old = f->source.y * f->width + f->source.x;
+	int i, n;
+
+	assert(f->height == c->height && f->width == c->width);
+	assert(square_in_bounds(c, y, x));
+
+	f->left_n = 0;
+	f->mark_stamp++;
+
+	/* Count from the new source */
+	f->source = loc(x, y);
+	if (f->dist[source] != 0) {
+		f->dist[source] = 0;
+		flow_push(f, 0, source);
+		flow_settle(c, f);
+	}
 
-	/*** Player Grid ***/
+	/* Cut off what was reached through the old source or the changes */
+	if (f->sourced && old != source)
+		flow_queue_cut(f, old);
+	for (i = 0; i < f->changed_n; i++)
+		if (flow_blocked(c, f, f->changed[i]))
+			flow_queue_cut(f, f->changed[i]);
+	flow_cut(c, f);
+
+	/* Reach the cut grids, and any newly opened ones, by other ways */
+	for (i = 0; i < f->left_n; i++)
+		flow_reach(c, f, f->left[i]);
+	for (i = 0; i < f->changed_n; i++)
+		flow_reach(c, f, f->changed[i]);
+	flow_settle(c, f);
+
+	/* Keep the list of grids which are still out of reach */
+	for (i = n = 0; i < f->left_n; i++) {
+		if (f->dist[f->left[i]] != FLOW_FAR) continue;
+		f->left[n] = f->left[i];
+		f->left_dist[n++] = f->left_dist[i];
+	}
+	f->left_n = n;
 
-	/* Save the time-stamp */
-	c->squares[py][px].when = flow_n;
+	f->changed_n = 0;
+	f->sourced = true;
+}
 
-	/* Save the flow cost */
-	c->squares[py][px].cost = 0;
+/**
+ * Steps from the source to (y, x), or -1 if the grid is out of reach
+ */
+int flow_dist(const struct flow *f, int y, int x)
+{
+	int idx;
 
-	/* Enqueue that entry */
-	flow_y[flow_head] = py;
-	flow_x[flow_head] = px;
+	if (!f) return -1;
+	idx = y * f->width + x;
+	if (f->dist[idx] == FLOW_FAR) return -1;
+	return f->dist[idx];
+}
 
-	/* Advance the queue */
-	++flow_tail;
+/**
+ * List the grids in reach, nearest first, by walking out from the source
+ * one step at a time.  The list belongs to the field and lasts until the
+ * next call.
+ */
+const struct loc *flow_grids(struct flow *f, int *n)
+{
+	int side = 2 * f->depth - 1;
+	int i, d, k = 0;
 
+	if (!f->grids)
+		f->grids = mem_alloc(side * side * sizeof(struct loc));
 
-	/*** Process Queue ***/
+	if (f->sourced) {
+		f->mark_stamp++;
+		f->mark[f->source.y * f->width + f->source.x] = f->mark_stamp;
+		f->grids[k++] = f->source;
+	}
 
-	/* Now process the queue */
-	while (flow_head != flow_tail)
-	{
-		/* Extract the next entry */
-		ty = flow_y[flow_head];
-		tx = flow_x[flow_head];
+	for (i = 0; i < k; i++) {
+		int idx = f->grids[i].y * f->width + f->grids[i].x;
 
-		/* Forget that entry (with wrap) */
-		if (++flow_head == FLOW_MAX) flow_head = 0;
+		for (d = 0; d < 8; d++) {
+			int ty = f->grids[i].y + ddy_ddd[d];
+			int tx = f->grids[i].x + ddx_ddd[d];
+			int next = ty * f->width + tx;
 
-		/* Child cost */
-		n = c->squares[ty][tx].cost + 1;
+			if (ty < 0 || tx < 0 || ty >= f->height || tx >= f->width)
+				continue;
+			if (f->dist[next] != f->dist[idx] + 1) continue;
+			if (f->mark[next] == f->mark_stamp) continue;
 
-		/* Hack -- Limit flow depth */
-		if (n == z_info->max_flow_depth) continue;
+			f->mark[next] = f->mark_stamp;
+			f->grids[k++] = loc(tx, ty);
+		}
+	}
 
-		/* Add the "children" */
-		for (d = 0; d < 8; d++)
-		{
-			int old_head = flow_tail;
+	*n = k;
+	return f->grids;
+}
 
-			/* Child location */
-			y = ty + ddy_ddd[d];
-			x = tx + ddx_ddd[d];
-			if (!square_in_bounds(c, y, x)) continue;
+/**
+ * Steps to the player when the noise last reached (y, x), or 0 if it has
+ * not been reached since the scent was last forgotten
+ */
+int cave_scent_cost(struct chunk *c, int y, int x)
+{
+	int idx = y * c->width + x;
 
-			/* Ignore "pre-stamped" entries */
-			if (c->squares[y][x].when == flow_n) continue;
+	if (!c->noise) return 0;
+	if (c->noise->dist[idx] != FLOW_FAR) return c->noise->dist[idx];
+	if (c->scent->when[idx] <= c->scent->base) return 0;
+	return c->scent->cost[idx];
+}
 
-			/* Ignore "walls" and "rubble" */
-			if (tf_has(f_info[c->squares[y][x].feat].flags, TF_NO_FLOW))
-				continue;
+/**
+ * How recently the noise reached (y, x), as a count of updates since the
+ * scent was last forgotten; 0 means never, and grids the noise reaches now
+ * (including the player's) have the largest value
+ */
+u32b cave_scent_when(struct chunk *c, int y, int x)
+{
+	int idx = y * c->width + x;
+	u32b when;
+
+	if (!c->noise) return 0;
+	if (c->noise->dist[idx] != FLOW_FAR)
+		when = c->scent->stamp;
+	else
+		when = c->scent->when[idx];
+	if (when <= c->scent->base) return 0;
+	return when - c->scent->base;
+}
 
-			/* Save the time-stamp */
-			c->squares[y][x].when = flow_n;
+/**
+ * Forget the player's scent; the noise itself is kept, and repaired as the
+ * terrain changes
+ */
+void cave_forget_flow(struct chunk *c)
+{
+	if (c->scent)
+		c->scent->base = c->scent->stamp;
+}
 
-			/* Save the flow cost */
-			c->squares[y][x].cost = n;
+/**
+ * Update the noise flow from the player, so that the "cost" of every grid
+ * the player can reach is the number of steps needed to reach it (monsters
+ * "hear" the player through this), and leave the scent on grids the noise
+ * no longer reaches (monsters follow older marks as "scent").
+ */
+void cave_update_flow(struct chunk *c)
+{
+	struct flow *f;
+	struct scent *s;
+	int i;
 
-			/* Enqueue that entry */
-			flow_y[flow_tail] = y;
-			flow_x[flow_tail] = x;
+	if (!c->noise) {
+		c->noise = flow_new(c, z_info->max_flow_depth);
+		c->scent = mem_zalloc(sizeof(*c->scent));
+		c->scent->when = mem_zalloc(c->height * c->width * sizeof(u32b));
+		c->scent->cost = mem_zalloc(c->height * c->width * sizeof(u16b));
+	}
+	f = c->noise;
+	s = c->scent;
 
-			/* Advance the queue */
-			if (++flow_tail == FLOW_MAX) flow_tail = 0;
+	flow_update(c, f, player->py, player->px);
 
-			/* Hack -- Overflow by forgetting new entry */
-			if (flow_tail == flow_head) flow_tail = old_head;
-		}
+	/* The grids left behind were last reached by the previous update */
+	for (i = 0; i < f->left_n; i++) {
+		s->when[f->left[i]] = s->stamp;
+		s->cost[f->left[i]] = f->left_dist[i];
 	}
+	s->stamp++;
+}
+
+/**
+ * Update the chunk's flow from a single grid, such as a monster looking for
+ * somewhere to run to, and return it.  The field is shared by every caller,
+ * so it is only good until the next call.
+ */
+struct flow *cave_near_flow(struct chunk *c, int y, int x, int depth)
+{
+	if (!c->near)
+		c->near = flow_new(c, depth);
+	assert(c->near->depth == depth);
+
+	flow_update(c, c->near, y, x);
+	return c->near;
 }
 
 /**
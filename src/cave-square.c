@@ -779,6 +779,11 @@ void square_set_feat(struct chunk *c, int y, int x, int feat)
 	/* Make the change */
 	c->squares[y][x].feat = feat;
 
+	/* Flow fields need repairing where the flow is newly blocked or open */
+	if (tf_has(f_info[current_feat].flags, TF_NO_FLOW) !=
+		tf_has(f_info[feat].flags, TF_NO_FLOW))
+		flow_note_change(c, y, x);
+
 	/* Make the new terrain feel at home */
 	if (character_dungeon) {
 		/* Remove traps if necessary */
@@ -21,6 +21,7 @@
 #include "cmds.h"
 #include "init.h"
 #include "monster.h"
+#include "mon-util.h"
 #include "player-calcs.h"
 #include "player-timed.h"
 
@@ -431,7 +432,24 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
  */
 void forget_view(struct chunk *c)
 {
-	int x, y;
+	int x, y, i;
+
+	/* Only the grids from the last view need forgetting */
+	if (c->view_grids) {
+		for (i = 0; i < c->view_n; i++) {
+			y = c->view_grids[i].y;
+			x = c->view_grids[i].x;
+			if (!square_isview(c, y, x))
+				continue;
+			sqinfo_off(c->squares[y][x].info, SQUARE_VIEW);
+			sqinfo_off(c->squares[y][x].info, SQUARE_SEEN);
+			square_light_spot(c, y, x);
+			if (c->squares[y][x].mon > 0)
+				update_mon_later(c->squares[y][x].mon);
+		}
+		c->view_n = 0;
+		return;
+	}
 
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
@@ -442,23 +460,50 @@ void forget_view(struct chunk *c)
 			square_light_spot(c, y, x);
 		}
 	}
+	update_monsters_later();
 }
 
 
 
 /**
  * Mark the currently seen grids, then wipe in preparation for recalculating
+ *
+ * If the chunk remembers its last view, only those grids can carry the
+ * view flags, so only they are visited; otherwise (first view of a new or
+ * reloaded chunk) the whole grid is scanned and the view list is created.
  */
 static void mark_wasseen(struct chunk *c) 
 {
-	int x, y;
+	int x, y, i;
+
+	if (c->view_grids) {
+		for (i = 0; i < c->view_n; i++) {
+			y = c->view_grids[i].y;
+			x = c->view_grids[i].x;
+			if (square_isseen(c, y, x))
+				sqinfo_on(c->squares[y][x].info, SQUARE_WASSEEN);
+			sqinfo_off(c->squares[y][x].info, SQUARE_VIEW);
+			sqinfo_off(c->squares[y][x].info, SQUARE_SEEN);
+		}
+		return;
+	}
+
+	/* Nothing can be viewed from further away than max_sight */
+	i = 2 * z_info->max_sight + 1;
+	c->view_grids = mem_zalloc(i * i * sizeof(struct loc));
+	c->view_n = 0;
+
 	/* Save the old "view" grids for later */
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
+			if (!square_isview(c, y, x) && !square_isseen(c, y, x))
+				continue;
 			if (square_isseen(c, y, x))
 				sqinfo_on(c->squares[y][x].info, SQUARE_WASSEEN);
 			sqinfo_off(c->squares[y][x].info, SQUARE_VIEW);
 			sqinfo_off(c->squares[y][x].info, SQUARE_SEEN);
+			if (c->view_n < i * i)
+				c->view_grids[c->view_n++] = loc(x, y);
 		}
 	}
 }
@@ -473,8 +518,7 @@ static void add_monster_lights(struct chunk *c, struct loc from)
 	for (k = 1; k < cave_monster_max(c); k++) {
 		/* Check the k'th monster */
 		struct monster *m = cave_monster(c, k);
-
-		bool in_los = los(c, from.y, from.x, m->fy, m->fx);
+		bool in_los;
 
 		/* Skip dead monsters */
 		if (!m->race)
@@ -484,6 +528,13 @@ static void add_monster_lights(struct chunk *c, struct loc from)
 		if (!rf_has(m->race->flags, RF_HAS_LIGHT))
 			continue;
 
+		/* Skip monsters too far away to light anything in view; a diagonal
+		 * step can bring distance() down by two */
+		if (distance(from.y, from.x, m->fy, m->fx) > z_info->max_sight + 2)
+			continue;
+
+		in_los = los(c, from.y, from.x, m->fy, m->fx);
+
 		/* Light a 3x3 box centered on the monster */
 		for (i = -1; i <= 1; i++)
 			for (j = -1; j <= 1; j++) {
@@ -539,6 +590,10 @@ static void update_one(struct chunk *c, int y, int x, int blind)
 		square_light_spot(c, y, x);
 
 	sqinfo_off(c->squares[y][x].info, SQUARE_WASSEEN);
+
+	/* Any monster here may have come into or gone out of view */
+	if (c->squares[y][x].mon > 0)
+		update_mon_later(c->squares[y][x].mon);
 }
 
 /**
@@ -645,10 +700,19 @@ static void update_view_one(struct chunk *c, int y, int x, int radius, int py, i
 
 /**
  * Update the player's current view
+ *
+ * Only grids within max_sight of the player can enter the view, so only
+ * that box is traced; grids which were in the previous view but lie outside
+ * the box are visited from the chunk's view list so they can be redrawn as
+ * they leave the view.
  */
 void update_view(struct chunk *c, struct player *p)
 {
-	int x, y;
+	int x, y, i;
+	int y1 = MAX(p->py - z_info->max_sight, 0);
+	int x1 = MAX(p->px - z_info->max_sight, 0);
+	int y2 = MIN(p->py + z_info->max_sight, c->height - 1);
+	int x2 = MIN(p->px + z_info->max_sight, c->width - 1);
 
 	int radius;
 
@@ -668,14 +732,26 @@ void update_view(struct chunk *c, struct player *p)
 		sqinfo_on(c->squares[p->py][p->px].info, SQUARE_SEEN);
 
 	/* View squares we have LOS to */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
+	for (y = y1; y <= y2; y++)
+		for (x = x1; x <= x2; x++)
 			update_view_one(c, y, x, radius, p->py, p->px);
 
-	/* Complete the algorithm */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
+	/* Complete the algorithm for old view grids we have moved away from */
+	for (i = 0; i < c->view_n; i++) {
+		y = c->view_grids[i].y;
+		x = c->view_grids[i].x;
+		if (y < y1 || y > y2 || x < x1 || x > x2)
 			update_one(c, y, x, p->timed[TMD_BLIND]);
+	}
+
+	/* Complete the algorithm for the rest, remembering the new view */
+	c->view_n = 0;
+	for (y = y1; y <= y2; y++)
+		for (x = x1; x <= x2; x++) {
+			update_one(c, y, x, p->timed[TMD_BLIND]);
+			if (square_isview(c, y, x))
+				c->view_grids[c->view_n++] = loc(x, y);
+		}
 }
 
 
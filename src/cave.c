@@ -24,6 +24,7 @@
 #include "game-world.h"
 #include "init.h"
 #include "monster.h"
+#include "mon-move.h"
 #include "obj-ignore.h"
 #include "obj-pile.h"
 #include "obj-tval.h"
@@ -136,19 +137,18 @@ void set_terrain(void)
  * Allocate a new chunk of the world
  */
 struct chunk *cave_new(int height, int width) {
-	int y, x;
+	int y;
 
 	struct chunk *c = mem_zalloc(sizeof *c);
 	c->height = height;
 	c->width = width;
 	c->feat_count = mem_zalloc((z_info->f_max + 1) * sizeof(int));
 
+	/* One block for all the grids, with a pointer to the start of each row */
 	c->squares = mem_zalloc(c->height * sizeof(struct square*));
-	for (y = 0; y < c->height; y++) {
-		c->squares[y] = mem_zalloc(c->width * sizeof(struct square));
-		for (x = 0; x < c->width; x++)
-			c->squares[y][x].info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
-	}
+	c->squares[0] = mem_zalloc(c->height * c->width * sizeof(struct square));
+	for (y = 1; y < c->height; y++)
+		c->squares[y] = c->squares[0] + y * c->width;
 
 	c->objects = mem_zalloc(OBJECT_LIST_SIZE * sizeof(struct object*));
 	c->obj_max = OBJECT_LIST_SIZE - 1;
@@ -169,24 +169,43 @@ void cave_free(struct chunk *c) {
 
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
-			mem_free(c->squares[y][x].info);
 			if (c->squares[y][x].trap)
 				square_free_trap(c, y, x);
 			if (c->squares[y][x].obj)
 				object_pile_free(c->squares[y][x].obj);
 		}
-		mem_free(c->squares[y]);
 	}
+	mem_free(c->squares[0]);
 	mem_free(c->squares);
 
 	mem_free(c->feat_count);
+	mem_free(c->view_grids);
+	while (c->flows)
+		flow_free(c, c->flows);
+	if (c->scent) {
+		mem_free(c->scent->when);
+		mem_free(c->scent->cost);
+		mem_free(c->scent);
+	}
 	mem_free(c->objects);
+	monster_schedule_flush(c);
 	mem_free(c->monsters);
 	if (c->name)
 		string_free(c->name);
 	mem_free(c);
 }
 
+/**
+ * Turn off the given info flags in every grid of a chunk
+ */
+void cave_info_diff(struct chunk *c, const bitflag *flags) {
+	struct square *square = c->squares[0];
+	int i, n = c->height * c->width;
+
+	for (i = 0; i < n; i++)
+		sqinfo_diff(square[i].info, flags);
+}
+
 
 /**
  * Standard "find me a location" function
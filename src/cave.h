@@ -131,16 +131,75 @@ struct grid_data {
 	bool trapborder;
 };
 
+/**
+ * A single grid.  All the grids of a chunk live in one block, row by row, so
+ * the info flags are stored in the grid rather than allocated separately.
+ */
 struct square {
 	byte feat;
-	bitflag *info;
-	byte cost;
-	byte when;
+	bitflag info[SQUARE_SIZE];
 	s16b mon;
 	struct object *obj;
 	struct trap *trap;
 };
 
+/**
+ * A flow field: the number of steps from a source grid to every grid within
+ * a maximum depth, as breadth-first search would find them.
+ *
+ * Rather than searching again from scratch, each update repairs the previous
+ * distances: grids which lost their shortest path (because the source moved
+ * or terrain changed) are found by walking outwards from the change, then
+ * those grids and any newly opened ones are given distances again from their
+ * neighbours.  So the work done depends on how much of the field changed,
+ * not on its size.  Grids which drop out of the field are listed so that
+ * the caller can remember them.
+ */
+struct flow {
+	int height;
+	int width;
+	int depth;		/* Grids this many steps away are out of reach */
+	struct loc source;	/* Grid the steps are counted from */
+	bool sourced;		/* The field has been updated at least once */
+	u16b *dist;		/* Steps from the source, or FLOW_FAR */
+
+	u32b *mark;		/* Grids queued by the current repair */
+	u32b mark_stamp;	/* Stamp of the current repair */
+	struct flow_entry *entry;	/* Grids queued by distance */
+	int entry_n;
+	int entry_max;
+	int *head;		/* First entry at each distance */
+
+	int *changed;		/* Grids (y * width + x) whose terrain changed
+				 * since the last update */
+	int changed_n;
+	int changed_max;
+
+	int *left;		/* Grids which the last update took out of reach */
+	u16b *left_dist;	/* Their distances before that update */
+	int left_n;
+	int left_max;
+
+	struct loc *grids;	/* Grids in reach, as listed by flow_grids() */
+
+	struct flow *next;	/* Next flow field on the same chunk */
+};
+
+#define FLOW_FAR 0xFFFF
+
+/**
+ * Where the player has been: the update of the noise flow which last reached
+ * each grid, and how far away the player was then.  Grids still within the
+ * noise flow count as reached by the latest update.  Forgetting the scent
+ * just moves the base stamp, so that every older mark reads as unset.
+ */
+struct scent {
+	u32b *when;		/* Stamp of the update which last reached the grid */
+	u16b *cost;		/* Steps to the player when it was last reached */
+	u32b stamp;		/* Stamp of the latest update */
+	u32b base;		/* Marks at or below this stamp are forgotten */
+};
+
 struct chunk {
 	char *name;
 	s32b created_at;
@@ -157,7 +216,15 @@ struct chunk {
 	u16b feeling_squares; /* How many feeling squares the player has visited */
 	int *feat_count;
 
-	struct square **squares;
+	struct square **squares;	/* Row pointers into a single block of grids */
+
+	struct loc *view_grids;	/* Grids marked SQUARE_VIEW by update_view() */
+	int view_n;
+
+	struct flow *flows;	/* Every flow field on the chunk */
+	struct flow *noise;	/* Flow from the player, for monsters to hear */
+	struct scent *scent;	/* Older noise, for monsters to track */
+	struct flow *near;	/* Flow from one monster, for places to run to */
 
 	struct object **objects;
 	u16b obj_max;
@@ -166,6 +233,7 @@ struct chunk {
 	u16b mon_max;
 	u16b mon_cnt;
 	int mon_current;
+	struct monster_schedule *mon_sched;
 };
 
 /*** Feature Indexes (see "lib/gamedata/terrain.txt") ***/
@@ -225,8 +293,17 @@ void square_light_spot(struct chunk *c, int y, int x);
 void light_room(int y1, int x1, bool light);
 void wiz_light(struct chunk *c, bool full);
 void cave_illuminate(struct chunk *c, bool daytime);
+struct flow *flow_new(struct chunk *c, int depth);
+void flow_free(struct chunk *c, struct flow *f);
+void flow_note_change(struct chunk *c, int y, int x);
+void flow_update(struct chunk *c, struct flow *f, int y, int x);
+int flow_dist(const struct flow *f, int y, int x);
+const struct loc *flow_grids(struct flow *f, int *n);
+int cave_scent_cost(struct chunk *c, int y, int x);
+u32b cave_scent_when(struct chunk *c, int y, int x);
 void cave_update_flow(struct chunk *c);
 void cave_forget_flow(struct chunk *c);
+struct flow *cave_near_flow(struct chunk *c, int y, int x, int depth);
 
 /* cave-square.c */
 /**
@@ -363,6 +440,7 @@ void square_unmark(struct chunk *c, int y, int x);
 void set_terrain(void);
 struct chunk *cave_new(int height, int width);
 void cave_free(struct chunk *c);
+void cave_info_diff(struct chunk *c, const bitflag *flags);
 void scatter(struct chunk *c, int *yp, int *xp, int y, int x, int d, bool need_los);
 
 struct monster *cave_monster(struct chunk *c, int idx);
@@ -156,6 +156,21 @@ struct command *cmdq_peek(void)
 	return &cmd_queue[prev_cmd_idx(cmd_head)];
 }
 
+/**
+ * Fill `cmds` with up to `max` of the commands waiting in the queue, oldest
+ * first, and return how many were filled in.
+ */
+int cmdq_list(struct command **cmds, int max)
+{
+	int idx, n = 0;
+
+	for (idx = cmd_tail; idx != cmd_head && n < max;
+		 idx = (idx + 1) % CMD_QUEUE_SIZE)
+		cmds[n++] = &cmd_queue[idx];
+
+	return n;
+}
+
 
 /**
  * Insert the given command into the command queue.
@@ -239,6 +239,11 @@ const char *cmd_verb(cmd_code cmd);
  */
 struct command *cmdq_peek(void);
 
+/**
+ * Lists the commands waiting in the queue, oldest first.
+ */
+int cmdq_list(struct command **cmds, int max);
+
 /**
  * A function called by the game to get a command from the UI.
  */
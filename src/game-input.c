@@ -18,6 +18,7 @@
 
 #include "angband.h"
 #include "cmd-core.h"
+#include "game-journal.h"
 
 bool (*get_string_hook)(const char *prompt, char *buf, size_t len);
 int (*get_quantity_hook)(const char *prompt, int max);
@@ -46,11 +47,14 @@ bool (*map_is_visible_hook)(void);
  */
 bool get_string(const char *prompt, char *buf, size_t len)
 {
+	bool ok = false;
+
 	/* Ask the UI for it */
 	if (get_string_hook)
-		return get_string_hook(prompt, buf, len);
-	else
-		return false;
+		ok = get_string_hook(prompt, buf, len);
+
+	journal_note_string(ok, buf);
+	return ok;
 }
 
 /**
@@ -62,11 +66,14 @@ bool get_string(const char *prompt, char *buf, size_t len)
  */
 int get_quantity(const char *prompt, int max)
 {
+	int amt = 0;
+
 	/* Ask the UI for it */
 	if (get_quantity_hook)
-		return get_quantity_hook(prompt, max);
-	else
-		return 0;
+		amt = get_quantity_hook(prompt, max);
+
+	journal_note_quantity(amt);
+	return amt;
 }
 
 /**
@@ -80,11 +87,14 @@ int get_quantity(const char *prompt, int max)
  */
 bool get_check(const char *prompt)
 {
+	bool ok = false;
+
 	/* Ask the UI for it */
 	if (get_check_hook)
-		return get_check_hook(prompt);
-	else
-		return false;
+		ok = get_check_hook(prompt);
+
+	journal_note_check(ok);
+	return ok;
 }
 
 /**
@@ -96,11 +106,14 @@ bool get_check(const char *prompt)
  */
 bool get_com(const char *prompt, char *command)
 {
+	bool ok = false;
+
 	/* Ask the UI for it */
 	if (get_com_hook)
-		return get_com_hook(prompt, command);
-	else
-		return false;
+		ok = get_com_hook(prompt, command);
+
+	journal_note_com(ok, ok ? *command : 0);
+	return ok;
 }
 
 
@@ -113,11 +126,14 @@ bool get_com(const char *prompt, char *command)
  */
 bool get_rep_dir(int *dir, bool allow_none)
 {
+	bool ok = false;
+
 	/* Ask the UI for it */
 	if (get_rep_dir_hook)
-		return get_rep_dir_hook(dir, allow_none);
-	else
-		return false;
+		ok = get_rep_dir_hook(dir, allow_none);
+
+	journal_note_rep_dir(ok, ok ? *dir : 0);
+	return ok;
 }
 
 /**
@@ -128,11 +144,14 @@ bool get_rep_dir(int *dir, bool allow_none)
  */
 bool get_aim_dir(int *dir)
 {
+	bool ok = false;
+
 	/* Ask the UI for it */
 	if (get_aim_dir_hook)
-		return get_aim_dir_hook(dir);
-	else
-		return false;
+		ok = get_aim_dir_hook(dir);
+
+	journal_note_aim_dir(ok, ok ? *dir : 0);
+	return ok;
 }
 
 /**
@@ -141,11 +160,14 @@ bool get_aim_dir(int *dir)
 int get_spell_from_book(const char *verb, struct object *book,
 		const char *error, bool (*spell_filter)(int spell))
 {
+	int spell = -1;
+
 	/* Ask the UI for it */
 	if (get_spell_from_book_hook)
-		return get_spell_from_book_hook(verb, book, error, spell_filter);
-	else
-		return -1;
+		spell = get_spell_from_book_hook(verb, book, error, spell_filter);
+
+	journal_note_spell(spell);
+	return spell;
 }
 
 /**
@@ -155,11 +177,14 @@ int get_spell(const char *verb, item_tester book_filter,
 						cmd_code cmd, const char *error,
 						bool (*spell_filter)(int spell))
 {
+	int spell = -1;
+
 	/* Ask the UI for it */
 	if (get_spell_hook)
-		return get_spell_hook(verb, book_filter, cmd, error, spell_filter);
-	else
-		return -1;
+		spell = get_spell_hook(verb, book_filter, cmd, error, spell_filter);
+
+	journal_note_spell(spell);
+	return spell;
 }
 
 /**
@@ -180,11 +205,14 @@ int get_spell(const char *verb, item_tester book_filter,
 bool get_item(struct object **choice, const char *pmt, const char *str,
 			  cmd_code cmd, item_tester tester, int mode)
 {
+	bool ok = false;
+
 	/* Ask the UI for it */
 	if (get_item_hook)
-		return get_item_hook(choice, pmt, str, cmd, tester, mode);
-	else
-		return false;
+		ok = get_item_hook(choice, pmt, str, cmd, tester, mode);
+
+	journal_note_item(ok, ok ? *choice : NULL);
+	return ok;
 }
 
 /**
@@ -0,0 +1,1147 @@
+/**
+ * \file game-journal.c
+ * \brief Record the player's input to a game, and play it back
+ *
+ * Copyright (c) 2016 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ *
+ * Everything the game does follows from its state, the random number
+ * generator and the player's input.  The journal records a snapshot of the
+ * first two at the start of a session, then all of the third, so that a
+ * session can be played again without the UI (see main-replay.c).
+ *
+ * The player's input reaches the game in three ways, each of which gets its
+ * own kind of record:
+ * - "steps", the commands the UI puts in the queue each time the game asks
+ *   for some (along with the target and panel, which the UI can change);
+ * - "answers", the replies to prompts made through game-input.c while a
+ *   command is running;
+ * - "interrupts", keypresses which cancel a repeated command, rest or run.
+ * Input the UI gathers for itself, before it queues a command, is covered by
+ * the command's arguments and so isn't recorded.  Changes the UI makes to
+ * the game directly (options, debug commands) aren't recorded at all; the
+ * state hash at each checkpoint shows where a replay has drifted.
+ *
+ * The file starts with "AJNL", a version byte and the snapshot, which is a
+ * savefile.  Records follow, each a type byte and a little-endian payload.
+ */
+
+#include "angband.h"
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-event.h"
+#include "game-input.h"
+#include "game-journal.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-move.h"
+#include "monster.h"
+#include "player-calcs.h"
+#include "player-timed.h"
+#include "player-util.h"
+#include "savefile.h"
+#include "store.h"
+#include "target.h"
+
+#define JOURNAL_MAGIC "AJNL"
+#define JOURNAL_VERSION 2
+
+/**
+ * Most commands a step can queue; the queue itself holds fewer
+ */
+#define JOURNAL_STEP_MAX 32
+
+/**
+ * Record types
+ */
+enum {
+	JR_STEP = 1,
+	JR_ANSWER,
+	JR_INTERRUPT,
+	JR_CHECK
+};
+
+/**
+ * Answer types, one for each game-input.c prompt
+ */
+enum {
+	JA_STRING = 1,
+	JA_QUANTITY,
+	JA_CHECK,
+	JA_COM,
+	JA_REP_DIR,
+	JA_AIM_DIR,
+	JA_SPELL,
+	JA_ITEM
+};
+
+/**
+ * Where an object was found
+ */
+enum {
+	JI_NONE = 0,
+	JI_GEAR,
+	JI_FLOOR,
+	JI_STORE
+};
+
+/**
+ * What the target is
+ */
+enum {
+	JT_NONE = 0,
+	JT_MONSTER,
+	JT_GRID
+};
+
+bool arg_journal;			/* Command arg -- Record a journal */
+
+static ang_file *journal_file;
+
+/**
+ * The record being built
+ */
+static byte *rec_buf;
+static size_t rec_len;
+static size_t rec_size;
+
+/**
+ * How deep we are in UI input; only input given to running commands is
+ * recorded
+ */
+static int input_depth;
+
+/**
+ * Input steps so far
+ */
+static u32b journal_steps;
+
+/**
+ * Checks for interrupts so far, so that an interrupt can say which check
+ * it came in
+ */
+static u32b interrupt_checks;
+
+/**
+ * The journal being replayed
+ */
+static byte *replay_buf;
+static size_t replay_len;
+static size_t replay_pos;
+static bool replay_verify;
+static struct journal_stats replay_stats;
+
+/**
+ * The panel at the last step, standing in for the UI's
+ */
+static int replay_panel[4];
+
+
+/**
+ * ------------------------------------------------------------------------
+ * State hash
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Add a 32-bit value to an FNV-1a hash, a byte at a time
+ */
+static u32b hash_u32(u32b h, u32b v)
+{
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		h ^= (v >> (i * 8)) & 0xFF;
+		h *= 16777619UL;
+	}
+
+	return h;
+}
+
+/**
+ * Hash the parts of the game state that show a replay has gone astray:
+ * the random number generator, the turn, the player and the monsters.
+ * Rand_value is left out, as it is only scratch space for seeded runs.
+ */
+u32b journal_state_hash(void)
+{
+	u32b h = 2166136261UL;
+	struct object *obj;
+	int i;
+
+	h = hash_u32(h, state_i);
+	for (i = 0; i < RAND_DEG; i++)
+		h = hash_u32(h, STATE[i]);
+
+	h = hash_u32(h, turn);
+	h = hash_u32(h, player->depth);
+	h = hash_u32(h, player->py);
+	h = hash_u32(h, player->px);
+	h = hash_u32(h, player->chp);
+	h = hash_u32(h, player->csp);
+	h = hash_u32(h, player->exp);
+	h = hash_u32(h, player->au);
+	h = hash_u32(h, player->energy);
+	for (i = 0; i < TMD_MAX; i++)
+		h = hash_u32(h, player->timed[i]);
+	for (obj = player->gear; obj; obj = obj->next)
+		h = hash_u32(h, (obj->kind->kidx << 8) ^ obj->number);
+
+	if (!cave) return h;
+
+	h = hash_u32(h, cave->obj_max);
+	h = hash_u32(h, cave_monster_max(cave));
+	for (i = 1; i < cave_monster_max(cave); i++) {
+		struct monster *mon = cave_monster(cave, i);
+
+		if (!mon->race) continue;
+		h = hash_u32(h, mon->race->ridx);
+		h = hash_u32(h, (mon->fy << 8) | mon->fx);
+		h = hash_u32(h, mon->hp);
+		h = hash_u32(h, monster_current_energy(mon));
+	}
+
+	return h;
+}
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Recording
+ * ------------------------------------------------------------------------ */
+
+static void rec_u8(byte v)
+{
+	if (rec_len == rec_size) {
+		rec_size = rec_size ? rec_size * 2 : 256;
+		rec_buf = mem_realloc(rec_buf, rec_size);
+	}
+	rec_buf[rec_len++] = v;
+}
+
+static void rec_u16(u16b v)
+{
+	rec_u8(v & 0xFF);
+	rec_u8(v >> 8);
+}
+
+static void rec_u32(u32b v)
+{
+	rec_u16(v & 0xFFFF);
+	rec_u16(v >> 16);
+}
+
+static void rec_string(const char *str)
+{
+	size_t i, len = str ? MIN(strlen(str), 0xFFFF) : 0;
+
+	rec_u16(len);
+	for (i = 0; i < len; i++)
+		rec_u8(str[i]);
+}
+
+/**
+ * Write out the record built so far
+ */
+static void rec_write(void)
+{
+	if (!file_write(journal_file, (const char *)rec_buf, rec_len)) {
+		/* Give up rather than leave a journal with holes in it */
+		file_close(journal_file);
+		journal_file = NULL;
+		msg("Could not write to the journal; it has been stopped.");
+	}
+	rec_len = 0;
+}
+
+/**
+ * Record where an object is, so it can be found again
+ */
+static void rec_object(struct object *obj)
+{
+	struct object *o;
+	int i, n;
+
+	if (obj) {
+		/* Carried */
+		for (o = player->gear, n = 0; o; o = o->next, n++)
+			if (o == obj) {
+				rec_u8(JI_GEAR);
+				rec_u16(n);
+				rec_u16(0);
+				return;
+			}
+
+		/* On the floor, or remembered there */
+		if (obj->oidx && obj->oidx <= cave->obj_max &&
+			cave->objects[obj->oidx] == obj) {
+			rec_u8(JI_FLOOR);
+			rec_u16(obj->oidx);
+			rec_u16(0);
+			return;
+		}
+		if (obj->oidx && cave_k && obj->oidx <= cave_k->obj_max &&
+			cave_k->objects[obj->oidx] == obj) {
+			rec_u8(JI_FLOOR);
+			rec_u16(obj->oidx);
+			rec_u16(1);
+			return;
+		}
+
+		/* In a store */
+		for (i = 0; stores && i < MAX_STORES; i++)
+			for (o = stores[i].stock, n = 0; o; o = o->next, n++)
+				if (o == obj) {
+					rec_u8(JI_STORE);
+					rec_u16(i);
+					rec_u16(n);
+					return;
+				}
+	}
+
+	rec_u8(JI_NONE);
+	rec_u16(0);
+	rec_u16(0);
+}
+
+/**
+ * Record the current target
+ */
+static void rec_target(void)
+{
+	struct monster *mon = target_get_monster();
+	int x, y;
+
+	target_get(&x, &y);
+	if (!target_is_set()) {
+		rec_u8(JT_NONE);
+		rec_u16(0);
+		rec_u16(0);
+	} else if (mon) {
+		rec_u8(JT_MONSTER);
+		rec_u16(mon->midx);
+		rec_u16(0);
+	} else {
+		rec_u8(JT_GRID);
+		rec_u16(y);
+		rec_u16(x);
+	}
+}
+
+/**
+ * Record a checkpoint for the state as it is now
+ */
+static void rec_check(void)
+{
+	rec_u8(JR_CHECK);
+	rec_u32(journal_steps);
+	rec_u32(turn);
+	rec_u32(journal_state_hash());
+	rec_write();
+}
+
+/**
+ * Start recording to a journal next to `savefile_path`.
+ *
+ * The game is saved to a snapshot which goes at the head of the journal,
+ * for a replay to start from.  This is called as the game starts, once the
+ * level exists but before the player enters it.
+ */
+bool journal_start(const char *savefile_path)
+{
+	char path[1024], base[1024];
+	char *data = NULL;
+	size_t len = 0, size = 0;
+	ang_file *f;
+	int n;
+
+	journal_stop();
+
+	strnfmt(path, sizeof(path), "%s.jnl", savefile_path);
+	strnfmt(base, sizeof(base), "%s.jnl-base", savefile_path);
+
+	/* Take the snapshot */
+	if (!savefile_save(base)) return false;
+	f = file_open(base, MODE_READ, FTYPE_RAW);
+	if (!f) return false;
+	do {
+		if (len == size) {
+			size = size ? size * 2 : 65536;
+			data = mem_realloc(data, size);
+		}
+		n = file_read(f, data + len, size - len);
+		if (n > 0) len += n;
+	} while (n > 0);
+	file_close(f);
+	file_delete(base);
+
+	/* Write the header and the snapshot */
+	journal_file = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (!journal_file) {
+		mem_free(data);
+		return false;
+	}
+	rec_len = 0;
+	for (n = 0; n < 4; n++)
+		rec_u8(JOURNAL_MAGIC[n]);
+	rec_u8(JOURNAL_VERSION);
+	rec_u32(len);
+	rec_write();
+	if (journal_file && !file_write(journal_file, data, len)) {
+		file_close(journal_file);
+		journal_file = NULL;
+	}
+	mem_free(data);
+	if (!journal_file) return false;
+	file_flush(journal_file);
+
+	journal_steps = 0;
+	interrupt_checks = 0;
+
+	return true;
+}
+
+/**
+ * Finish the journal with a last checkpoint
+ */
+void journal_stop(void)
+{
+	if (!journal_file) return;
+
+	rec_check();
+	if (journal_file) file_close(journal_file);
+	journal_file = NULL;
+
+	mem_free(rec_buf);
+	rec_buf = NULL;
+	rec_len = rec_size = 0;
+}
+
+/**
+ * Whether input should go into the journal
+ */
+static bool journal_recording(void)
+{
+	return journal_file && !input_depth;
+}
+
+/**
+ * Note that the UI has started gathering input for itself
+ */
+void journal_input_begin(void)
+{
+	input_depth++;
+}
+
+/**
+ * Note that the UI has finished gathering input
+ */
+void journal_input_end(void)
+{
+	input_depth--;
+}
+
+/**
+ * Record the commands the UI has queued, which are about to be run in
+ * context `ctx`
+ */
+void journal_step(cmd_context ctx)
+{
+	struct command *cmds[JOURNAL_STEP_MAX];
+	int min_y = 0, min_x = 0, max_y = 0, max_x = 0;
+	int i, j, n;
+
+	if (!journal_recording()) return;
+
+	/* Check the state every so often */
+	if (ctx == CMD_GAME && !(journal_steps % JOURNAL_CHECK_STEPS))
+		rec_check();
+	if (!journal_file) return;
+
+	rec_u8(JR_STEP);
+	rec_u8(ctx);
+	rec_u8(player->upkeep->playing ? 1 : 0);
+	rec_target();
+	get_panel(&min_y, &min_x, &max_y, &max_x);
+	rec_u16(min_y);
+	rec_u16(min_x);
+	rec_u16(max_y);
+	rec_u16(max_x);
+
+	n = cmdq_list(cmds, N_ELEMENTS(cmds));
+	rec_u8(n);
+	for (i = 0; i < n; i++) {
+		struct command *cmd = cmds[i];
+		int nargs = 0;
+
+		rec_u16(cmd->code);
+		rec_u16(cmd->nrepeats);
+		for (j = 0; j < CMD_MAX_ARGS; j++)
+			if (cmd->arg[j].name[0]) nargs++;
+		rec_u8(nargs);
+
+		for (j = 0; j < CMD_MAX_ARGS; j++) {
+			struct cmd_arg *arg = &cmd->arg[j];
+
+			if (!arg->name[0]) continue;
+			rec_u8(arg->type);
+			rec_string(arg->name);
+			switch (arg->type) {
+				case arg_STRING: rec_string(arg->data.string); break;
+				case arg_CHOICE: rec_u32(arg->data.choice); break;
+				case arg_ITEM: rec_object(arg->data.obj); break;
+				case arg_NUMBER: rec_u32(arg->data.number); break;
+				case arg_DIRECTION:
+				case arg_TARGET: rec_u32(arg->data.direction); break;
+				case arg_POINT:
+					rec_u16(arg->data.point.x);
+					rec_u16(arg->data.point.y);
+					break;
+				case arg_NONE: break;
+			}
+		}
+	}
+	rec_write();
+	if (journal_file) file_flush(journal_file);
+
+	if (ctx == CMD_GAME) journal_steps++;
+}
+
+/**
+ * Note that the UI has checked for an interrupt
+ */
+void journal_interrupt_check(void)
+{
+	interrupt_checks++;
+}
+
+/**
+ * Note that the player has interrupted what they were doing
+ */
+void journal_interrupt(void)
+{
+	if (!journal_recording()) return;
+
+	rec_u8(JR_INTERRUPT);
+	rec_u32(interrupt_checks);
+	rec_write();
+}
+
+/**
+ * Start an answer record
+ */
+static bool rec_answer(byte kind)
+{
+	if (!journal_recording()) return false;
+
+	rec_u8(JR_ANSWER);
+	rec_u8(kind);
+	return true;
+}
+
+void journal_note_string(bool answered, const char *buf)
+{
+	if (!rec_answer(JA_STRING)) return;
+	rec_u8(answered);
+	if (answered) rec_string(buf);
+	rec_write();
+}
+
+void journal_note_quantity(int amt)
+{
+	if (!rec_answer(JA_QUANTITY)) return;
+	rec_u32(amt);
+	rec_write();
+}
+
+void journal_note_check(bool answered)
+{
+	if (!rec_answer(JA_CHECK)) return;
+	rec_u8(answered);
+	rec_write();
+}
+
+void journal_note_com(bool answered, char command)
+{
+	if (!rec_answer(JA_COM)) return;
+	rec_u8(answered);
+	rec_u8(command);
+	rec_write();
+}
+
+void journal_note_rep_dir(bool answered, int dir)
+{
+	if (!rec_answer(JA_REP_DIR)) return;
+	rec_u8(answered);
+	rec_u32(dir);
+	rec_write();
+}
+
+/**
+ * The UI may have chosen a new target while asking for an aim, so that is
+ * recorded as well
+ */
+void journal_note_aim_dir(bool answered, int dir)
+{
+	if (!rec_answer(JA_AIM_DIR)) return;
+	rec_u8(answered);
+	rec_u32(dir);
+	rec_target();
+	rec_write();
+}
+
+void journal_note_spell(int spell)
+{
+	if (!rec_answer(JA_SPELL)) return;
+	rec_u32(spell);
+	rec_write();
+}
+
+void journal_note_item(bool answered, struct object *obj)
+{
+	if (!rec_answer(JA_ITEM)) return;
+	rec_u8(answered);
+	rec_object(answered ? obj : NULL);
+	rec_write();
+}
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Replay
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Give up on a replay which no longer matches the game
+ */
+static void replay_fail(const char *why)
+{
+	quit_fmt("Replay %s at step %d (turn %ld, journal offset %lu)", why,
+			 replay_stats.steps, (long)turn, (unsigned long)replay_pos);
+}
+
+static int replay_peek(void)
+{
+	return replay_pos < replay_len ? replay_buf[replay_pos] : 0;
+}
+
+static byte jnl_u8(void)
+{
+	if (replay_pos >= replay_len) replay_fail("ran off the end of the journal");
+	return replay_buf[replay_pos++];
+}
+
+static u16b jnl_u16(void)
+{
+	u16b v = jnl_u8();
+	return v | (jnl_u8() << 8);
+}
+
+static u32b jnl_u32(void)
+{
+	u32b v = jnl_u16();
+	return v | ((u32b)jnl_u16() << 16);
+}
+
+/**
+ * Read a string into `buf`, or into a new string if `buf` is NULL
+ */
+static char *jnl_string(char *buf, size_t size)
+{
+	size_t i, len = jnl_u16();
+
+	if (!buf) {
+		size = len + 1;
+		buf = mem_alloc(size);
+	}
+	for (i = 0; i < len; i++) {
+		char c = jnl_u8();
+		if (i + 1 < size) buf[i] = c;
+	}
+	if (size) buf[MIN(len, size - 1)] = '\0';
+
+	return buf;
+}
+
+static struct object *jnl_object(void)
+{
+	int where = jnl_u8();
+	int a = jnl_u16();
+	int b = jnl_u16();
+	struct object *obj = NULL;
+
+	switch (where) {
+		case JI_GEAR:
+			for (obj = player->gear; obj && a; obj = obj->next) a--;
+			break;
+		case JI_FLOOR: {
+			struct chunk *c = b ? cave_k : cave;
+			if (c && a <= c->obj_max) obj = c->objects[a];
+			break;
+		}
+		case JI_STORE:
+			if (stores && a < MAX_STORES)
+				for (obj = stores[a].stock; obj && b; obj = obj->next) b--;
+			break;
+	}
+
+	if (where != JI_NONE && !obj)
+		replay_fail("lost track of an object");
+	return obj;
+}
+
+/**
+ * Read a target, and make it the current one if it isn't already
+ */
+static void jnl_target(void)
+{
+	int kind = jnl_u8();
+	int a = jnl_u16();
+	int b = jnl_u16();
+	struct monster *mon = target_get_monster();
+	int x, y;
+
+	target_get(&x, &y);
+	switch (kind) {
+		case JT_NONE:
+			if (target_is_set()) target_set_monster(NULL);
+			break;
+		case JT_MONSTER:
+			if (!target_is_set() || !mon || mon->midx != a)
+				target_set_monster(cave_monster(cave, a));
+			break;
+		case JT_GRID:
+			if (!target_is_set() || mon || y != a || x != b)
+				target_set_location(a, b);
+			break;
+	}
+}
+
+/**
+ * Compare a checkpoint with the game's state
+ */
+static void replay_check(void)
+{
+	u32b step, when, hash;
+
+	jnl_u8();
+	step = jnl_u32();
+	when = jnl_u32();
+	hash = jnl_u32();
+
+	replay_stats.checks++;
+	if (!replay_verify) return;
+
+	if (when != (u32b)turn || hash != journal_state_hash())
+		quit_fmt("Replay diverged by step %lu: turn %ld, hash %08lx; "
+				 "journal has turn %lu, hash %08lx", (unsigned long)step,
+				 (long)turn, (unsigned long)journal_state_hash(),
+				 (unsigned long)when, (unsigned long)hash);
+	replay_stats.verified++;
+}
+
+/**
+ * Queue up the commands from a step record
+ */
+static void replay_apply_step(void)
+{
+	int i, j, n;
+	bool playing;
+
+	jnl_u8();
+	jnl_u8();
+	playing = jnl_u8() ? true : false;
+	jnl_target();
+	for (i = 0; i < 4; i++)
+		replay_panel[i] = (s16b)jnl_u16();
+
+	n = jnl_u8();
+	for (i = 0; i < n; i++) {
+		struct command cmd = { 0 };
+		int nargs;
+
+		cmd.code = jnl_u16();
+		cmd.nrepeats = (s16b)jnl_u16();
+		nargs = jnl_u8();
+		for (j = 0; j < nargs; j++) {
+			int type = jnl_u8();
+			char name[20], *str;
+			int x, y;
+
+			jnl_string(name, sizeof(name));
+			switch (type) {
+				case arg_STRING:
+					str = jnl_string(NULL, 0);
+					cmd_set_arg_string(&cmd, name, str);
+					mem_free(str);
+					break;
+				case arg_CHOICE:
+					cmd_set_arg_choice(&cmd, name, (s32b)jnl_u32());
+					break;
+				case arg_ITEM:
+					cmd_set_arg_item(&cmd, name, jnl_object());
+					break;
+				case arg_NUMBER:
+					cmd_set_arg_number(&cmd, name, (s32b)jnl_u32());
+					break;
+				case arg_DIRECTION:
+					cmd_set_arg_direction(&cmd, name, (s32b)jnl_u32());
+					break;
+				case arg_TARGET:
+					cmd_set_arg_target(&cmd, name, (s32b)jnl_u32());
+					break;
+				case arg_POINT:
+					x = (s16b)jnl_u16();
+					y = (s16b)jnl_u16();
+					cmd_set_arg_point(&cmd, name, x, y);
+					break;
+				default:
+					replay_fail("found a bad command argument");
+			}
+		}
+
+		if (cmdq_push_copy(&cmd))
+			replay_fail("overflowed the command queue");
+		replay_stats.commands++;
+	}
+
+	/* The UI may have quit */
+	if (!playing) player->upkeep->playing = false;
+}
+
+/**
+ * Check that the next record is an answer of the given kind, and skip to
+ * its payload
+ */
+static void replay_answer(byte kind)
+{
+	if (jnl_u8() != JR_ANSWER || jnl_u8() != kind)
+		replay_fail("expected an answer the journal doesn't have");
+	replay_stats.answers++;
+}
+
+static bool replay_get_string(const char *prompt, char *buf, size_t len)
+{
+	bool ok;
+
+	replay_answer(JA_STRING);
+	ok = jnl_u8() ? true : false;
+	if (ok) jnl_string(buf, len);
+	return ok;
+}
+
+static int replay_get_quantity(const char *prompt, int max)
+{
+	replay_answer(JA_QUANTITY);
+	return (s32b)jnl_u32();
+}
+
+static bool replay_get_check(const char *prompt)
+{
+	replay_answer(JA_CHECK);
+	return jnl_u8() ? true : false;
+}
+
+static bool replay_get_com(const char *prompt, char *command)
+{
+	bool ok;
+	char c;
+
+	replay_answer(JA_COM);
+	ok = jnl_u8() ? true : false;
+	c = jnl_u8();
+	if (ok) *command = c;
+	return ok;
+}
+
+static bool replay_get_rep_dir(int *dir, bool allow_none)
+{
+	bool ok;
+	int d;
+
+	replay_answer(JA_REP_DIR);
+	ok = jnl_u8() ? true : false;
+	d = (s32b)jnl_u32();
+	if (ok) *dir = d;
+	return ok;
+}
+
+static bool replay_get_aim_dir(int *dir)
+{
+	bool ok;
+	int d;
+
+	replay_answer(JA_AIM_DIR);
+	ok = jnl_u8() ? true : false;
+	d = (s32b)jnl_u32();
+	jnl_target();
+	if (ok) *dir = d;
+	return ok;
+}
+
+static int replay_get_spell_from_book(const char *verb, struct object *book,
+									  const char *error,
+									  bool (*spell_filter)(int spell))
+{
+	replay_answer(JA_SPELL);
+	return (s32b)jnl_u32();
+}
+
+static int replay_get_spell(const char *verb, item_tester book_filter,
+							cmd_code cmd, const char *error,
+							bool (*spell_filter)(int spell))
+{
+	replay_answer(JA_SPELL);
+	return (s32b)jnl_u32();
+}
+
+static bool replay_get_item(struct object **choice, const char *pmt,
+							const char *str, cmd_code cmd,
+							item_tester tester, int mode)
+{
+	bool ok;
+	struct object *obj;
+
+	replay_answer(JA_ITEM);
+	ok = jnl_u8() ? true : false;
+	obj = jnl_object();
+	if (ok) *choice = obj;
+	return ok;
+}
+
+static void replay_get_panel(int *min_y, int *min_x, int *max_y, int *max_x)
+{
+	*min_y = replay_panel[0];
+	*min_x = replay_panel[1];
+	*max_y = replay_panel[2];
+	*max_x = replay_panel[3];
+}
+
+static bool replay_panel_contains(unsigned int y, unsigned int x)
+{
+	return (int)y >= replay_panel[0] && (int)x >= replay_panel[1] &&
+		(int)y < replay_panel[2] && (int)x < replay_panel[3];
+}
+
+static bool replay_map_is_visible(void)
+{
+	return true;
+}
+
+/**
+ * Stand in for check_for_player_interrupt()
+ */
+static void replay_check_interrupt(game_event_type type, game_event_data *data,
+								   void *user)
+{
+	interrupt_checks++;
+	if (replay_peek() == JR_INTERRUPT &&
+		replay_pos + 5 <= replay_len) {
+		size_t pos = replay_pos;
+		u32b check;
+
+		jnl_u8();
+		check = jnl_u32();
+		if (check == interrupt_checks) {
+			event_signal(EVENT_INPUT_FLUSH);
+			disturb(player, 0);
+			msg("Cancelled.");
+		} else {
+			replay_pos = pos;
+		}
+	}
+}
+
+/**
+ * Stand in for new_level_display_update(), doing the updates it asks of the
+ * game
+ */
+static void replay_new_level(game_event_type type, game_event_data *data,
+							 void *user)
+{
+	player->upkeep->only_partial = true;
+	player->upkeep->update |= (PU_BONUS | PU_HP | PU_SPELLS | PU_TORCH);
+	update_stuff(player);
+	player->upkeep->update |= (PU_FORGET_VIEW | PU_UPDATE_VIEW | PU_DISTANCE);
+	player->upkeep->update |= (PU_FORGET_FLOW | PU_UPDATE_FLOW);
+	update_stuff(player);
+	player->upkeep->only_partial = false;
+}
+
+static void replay_enter_store(game_event_type type, game_event_data *data,
+							   void *user);
+
+/**
+ * Stand in for use_store(), running the store steps from the journal
+ */
+static void replay_use_store(game_event_type type, game_event_data *data,
+							 void *user)
+{
+	struct store *store = store_at(cave, player->py, player->px);
+
+	if (!store) return;
+
+	forget_view(cave);
+
+	while (replay_peek() == JR_STEP && replay_pos + 1 < replay_len &&
+		   replay_buf[replay_pos + 1] == CMD_STORE) {
+		replay_apply_step();
+		cmdq_pop(CMD_STORE);
+		notice_stuff(player);
+		handle_stuff(player);
+	}
+
+	/* Take a turn */
+	player->upkeep->energy_use = z_info->move_energy;
+}
+
+/**
+ * Stand in for leave_store()
+ */
+static void replay_leave_store(game_event_type type, game_event_data *data,
+							   void *user)
+{
+	cmd_disable_repeat();
+	player->upkeep->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
+
+	/* The game clears the store handlers after each visit */
+	event_add_handler(EVENT_ENTER_STORE, replay_enter_store, NULL);
+}
+
+/**
+ * Stand in for enter_store()
+ */
+static void replay_enter_store(game_event_type type, game_event_data *data,
+							   void *user)
+{
+	event_add_handler(EVENT_USE_STORE, replay_use_store, NULL);
+	event_add_handler(EVENT_LEAVE_STORE, replay_leave_store, NULL);
+}
+
+/**
+ * Load the journal at `path` and the game it starts from, and take over
+ * the UI's hooks so that input comes from the journal.  If `verify` is set,
+ * every checkpoint is compared with the game's state.
+ */
+bool journal_replay_start(const char *path, bool verify)
+{
+	char base[1024];
+	size_t size = 0, len;
+	ang_file *f;
+	int n;
+
+	/* Read the whole journal */
+	f = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!f) return false;
+	replay_len = 0;
+	do {
+		if (replay_len == size) {
+			size = size ? size * 2 : 65536;
+			replay_buf = mem_realloc(replay_buf, size);
+		}
+		n = file_read(f, (char *)replay_buf + replay_len, size - replay_len);
+		if (n > 0) replay_len += n;
+	} while (n > 0);
+	file_close(f);
+	replay_pos = 0;
+	memset(&replay_stats, 0, sizeof(replay_stats));
+	replay_verify = verify;
+
+	if (replay_len < 9 || memcmp(replay_buf, JOURNAL_MAGIC, 4)) return false;
+	replay_pos = 4;
+	if (jnl_u8() != JOURNAL_VERSION) return false;
+
+	/* Load the snapshot */
+	len = jnl_u32();
+	if (replay_pos + len > replay_len) return false;
+	path_build(base, sizeof(base), ANGBAND_DIR_USER, "replay.sav");
+	f = file_open(base, MODE_WRITE, FTYPE_RAW);
+	if (!f) return false;
+	if (!file_write(f, (const char *)replay_buf + replay_pos, len)) {
+		file_close(f);
+		return false;
+	}
+	file_close(f);
+	replay_pos += len;
+	if (!savefile_load(base, false)) return false;
+	file_delete(base);
+
+	/* Take over from the UI */
+	get_string_hook = replay_get_string;
+	get_quantity_hook = replay_get_quantity;
+	get_check_hook = replay_get_check;
+	get_com_hook = replay_get_com;
+	get_rep_dir_hook = replay_get_rep_dir;
+	get_aim_dir_hook = replay_get_aim_dir;
+	get_spell_from_book_hook = replay_get_spell_from_book;
+	get_spell_hook = replay_get_spell;
+	get_item_hook = replay_get_item;
+	get_panel_hook = replay_get_panel;
+	panel_contains_hook = replay_panel_contains;
+	map_is_visible_hook = replay_map_is_visible;
+	event_add_handler(EVENT_NEW_LEVEL_DISPLAY, replay_new_level, NULL);
+	event_add_handler(EVENT_CHECK_INTERRUPT, replay_check_interrupt, NULL);
+	event_add_handler(EVENT_ENTER_STORE, replay_enter_store, NULL);
+	interrupt_checks = 0;
+
+	/* Enter the level, as start_game() does */
+	player->upkeep->autosave = false;
+	if (!character_dungeon)
+		cave_generate(&cave, player);
+	on_new_level();
+
+	return true;
+}
+
+/**
+ * Queue the commands for the next input step, verifying any checkpoint on
+ * the way.  Returns false at the end of the journal.
+ */
+bool journal_replay_step(void)
+{
+	while (replay_pos < replay_len) {
+		switch (replay_peek()) {
+			case JR_CHECK:
+				replay_check();
+				break;
+			case JR_STEP:
+				if (replay_pos + 1 < replay_len &&
+					replay_buf[replay_pos + 1] == CMD_GAME) {
+					replay_apply_step();
+					replay_stats.steps++;
+					return true;
+				}
+				/* Fall through */
+			default:
+				replay_fail("found a record out of order");
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Verify the closing checkpoint, and report how the replay went
+ */
+void journal_replay_finish(struct journal_stats *stats)
+{
+	while (replay_peek() == JR_CHECK)
+		replay_check();
+	if (replay_pos < replay_len)
+		replay_fail("stopped before the end of the journal");
+
+	*stats = replay_stats;
+	mem_free(replay_buf);
+	replay_buf = NULL;
+	replay_len = replay_pos = 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * \file game-journal.h
+ * \brief Record the player's input to a game, and play it back
+ *
+ * Copyright (c) 2016 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_GAME_JOURNAL_H
+#define INCLUDED_GAME_JOURNAL_H
+
+#include "cmd-core.h"
+
+/**
+ * Number of input steps between state checkpoints in a journal
+ */
+#define JOURNAL_CHECK_STEPS 32
+
+/**
+ * Totals kept while replaying a journal
+ */
+struct journal_stats {
+	int steps;			/* Input steps replayed */
+	int commands;		/* Commands those steps pushed */
+	int answers;		/* Prompts answered from the journal */
+	int checks;			/* Checkpoints reached */
+	int verified;		/* Checkpoints whose state hash matched */
+};
+
+extern bool arg_journal;
+
+u32b journal_state_hash(void);
+
+bool journal_start(const char *savefile_path);
+void journal_stop(void);
+void journal_input_begin(void);
+void journal_input_end(void);
+void journal_step(cmd_context ctx);
+void journal_interrupt_check(void);
+void journal_interrupt(void);
+
+void journal_note_string(bool answered, const char *buf);
+void journal_note_quantity(int amt);
+void journal_note_check(bool answered);
+void journal_note_com(bool answered, char command);
+void journal_note_rep_dir(bool answered, int dir);
+void journal_note_aim_dir(bool answered, int dir);
+void journal_note_spell(int spell);
+void journal_note_item(bool answered, struct object *obj);
+
+bool journal_replay_start(const char *path, bool verify);
+bool journal_replay_step(void);
+void journal_replay_finish(struct journal_stats *stats);
+
+#endif /* INCLUDED_GAME_JOURNAL_H */
@@ -675,9 +675,10 @@ void on_new_level(void)
 	/* Update display */
 	event_signal(EVENT_NEW_LEVEL_DISPLAY);
 
-	/* Update player */
+	/* Update player, and all the new monsters */
 	player->upkeep->update |= (PU_BONUS | PU_HP | PU_SPELLS | PU_INVEN);
 	player->upkeep->notice |= (PN_COMBINE);
+	update_monsters_later();
 	notice_stuff(player);
 	update_stuff(player);
 	redraw_stuff(player);
@@ -707,6 +708,9 @@ static void on_leave_level(void) {
 	/* Forget the view */
 	forget_view(cave);
 
+	/* Stop scheduling the level's monsters */
+	monster_schedule_flush(cave);
+
 	/* Flush messages */
 	event_signal(EVENT_MESSAGE_FLUSH);
 }
@@ -277,7 +277,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 			sqinfo_copy(dest->squares[dest_y][dest_x].info,
 						source->squares[y][x].info);
 
-			/* Dungeon objects */
+			/* Dungeon objects move to the destination */
 			if (square_object(source, y, x)) {
 				struct object *obj;
 				dest->squares[dest_y][dest_x].obj = square_object(source, y, x);
@@ -287,6 +287,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 					obj->iy = dest_y;
 					obj->ix = dest_x;
 				}
+				source->squares[y][x].obj = NULL;
 			}
 
 			/* Monsters */
@@ -321,10 +322,11 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 					dest_mon->held_obj = source_mon->held_obj;
 			}
 
-			/* Traps */
+			/* Traps move to the destination */
 			if (source->squares[y][x].trap) {
 				struct trap *trap = source->squares[y][x].trap;
-				dest->squares[y][x].trap = trap;
+				dest->squares[dest_y][dest_x].trap = trap;
+				source->squares[y][x].trap = NULL;
 
 				/* Traverse the trap list */
 				while (trap) {
@@ -352,6 +354,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 		dest->objects[dest->obj_max + i] = source->objects[i];
 		if (dest->objects[dest->obj_max + i] != NULL)
 			dest->objects[dest->obj_max + i]->oidx = dest->obj_max + i;
+		source->objects[i] = NULL;
 	}
 	dest->obj_max += source->obj_max + 1;
 
@@ -844,17 +844,15 @@ static void cave_clear(struct chunk *c, struct player *p)
 
 
 /**
- * Generate a random level.
- *
- * Confusingly, this function also generate the town level (level 0).
- * \param c is the level we're going to end up with, in practice the global cave
- * \param p is the current player struct, in practice the global player
+ * Generate a level, with a random profile unless one is given.
  */
-void cave_generate(struct chunk **c, struct player *p)
+static void cave_generate_aux(struct chunk **c, struct player *p,
+							  const struct cave_profile *profile)
 {
 	const char *error = "no generation";
-	int i, y, x, tries = 0;
+	int i, tries = 0;
 	struct chunk *chunk;
+	bitflag gen_flags[SQUARE_SIZE];
 
 	assert(c);
 
@@ -875,7 +873,7 @@ void cave_generate(struct chunk **c, struct player *p)
 		dun->tunn = mem_zalloc(z_info->tunn_grid_max * sizeof(struct loc));
 
 		/* Choose a profile and build the level */
-		dun->profile = choose_profile(p->depth);
+		dun->profile = profile ? profile : choose_profile(p->depth);
 		chunk = dun->profile->builder(p);
 		if (!chunk) {
 			error = "Failed to find builder";
@@ -905,14 +903,12 @@ void cave_generate(struct chunk **c, struct player *p)
 		}
 
 		/* Clear generation flags. */
-		for (y = 0; y < chunk->height; y++) {
-			for (x = 0; x < chunk->width; x++) {
-				sqinfo_off(chunk->squares[y][x].info, SQUARE_WALL_INNER);
-				sqinfo_off(chunk->squares[y][x].info, SQUARE_WALL_OUTER);
-				sqinfo_off(chunk->squares[y][x].info, SQUARE_WALL_SOLID);
-				sqinfo_off(chunk->squares[y][x].info, SQUARE_MON_RESTRICT);
-			}
-		}
+		sqinfo_wipe(gen_flags);
+		sqinfo_on(gen_flags, SQUARE_WALL_INNER);
+		sqinfo_on(gen_flags, SQUARE_WALL_OUTER);
+		sqinfo_on(gen_flags, SQUARE_WALL_SOLID);
+		sqinfo_on(gen_flags, SQUARE_MON_RESTRICT);
+		cave_info_diff(chunk, gen_flags);
 
 		/* Regenerate levels that overflow their maxima */
 		if (cave_monster_max(chunk) >= z_info->level_monster_max)
@@ -977,6 +973,31 @@ void cave_generate(struct chunk **c, struct player *p)
 	(*c)->created_at = turn;
 }
 
+/**
+ * Generate a random level.
+ *
+ * Confusingly, this function also generate the town level (level 0).
+ * \param c is the level we're going to end up with, in practice the global cave
+ * \param p is the current player struct, in practice the global player
+ */
+void cave_generate(struct chunk **c, struct player *p)
+{
+	cave_generate_aux(c, p, NULL);
+}
+
+/**
+ * Generate a level with the given profile, whatever the depth would choose.
+ * This is for the benchmarks and debugging; quest monsters are still placed.
+ * \param c is the level we're going to end up with
+ * \param p is the current player struct, in practice the global player
+ * \param profile is the cave profile to build the level with
+ */
+void cave_generate_profile(struct chunk **c, struct player *p,
+						   const struct cave_profile *profile)
+{
+	cave_generate_aux(c, p, profile);
+}
+
 /**
  * The generate module, which initialises template rooms and vaults
  * Should it clean up?
@@ -240,6 +240,11 @@ struct room_template {
 extern struct dun_data *dun;
 extern struct vault *vaults;
 extern struct room_template *room_templates;
+extern struct cave_profile *cave_profiles;
+
+/* generate.c */
+void cave_generate_profile(struct chunk **c, struct player *p,
+						   const struct cave_profile *profile);
 
 /* gen-cave.c */
 struct chunk *town_gen(struct player *p);
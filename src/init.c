@@ -42,6 +42,7 @@
 #include "obj-ignore.h"
 #include "obj-list.h"
 #include "obj-make.h"
+#include "obj-pile.h"
 #include "obj-randart.h"
 #include "obj-slays.h"
 #include "obj-tval.h"
@@ -4518,6 +4519,7 @@ static struct init_module arrays_module = {
 
 extern struct init_module z_quark_module;
 extern struct init_module generate_module;
+extern struct init_module project_module;
 extern struct init_module rune_module;
 extern struct init_module obj_make_module;
 extern struct init_module ignore_module;
@@ -4534,6 +4536,7 @@ static struct init_module *modules[] = {
 	&player_module,
 	&arrays_module,
 	&generate_module,
+	&project_module,
 	&rune_module,
 	&obj_make_module,
 	&ignore_module,
@@ -4544,6 +4547,36 @@ static struct init_module *modules[] = {
 	NULL
 };
 
+/**
+ * Read the game constants and run every init module, loading the game data
+ * files.  This is the part of init_angband() that depends on lib/gamedata.
+ */
+void init_game_data(void)
+{
+	int i;
+
+	init_game_constants();
+
+	/* Initialise modules */
+	for (i = 0; modules[i]; i++)
+		if (modules[i]->init)
+			modules[i]->init();
+}
+
+/**
+ * Free everything loaded by init_game_data(), so it can be run again
+ */
+void cleanup_game_data(void)
+{
+	int i;
+
+	for (i = 0; modules[i]; i++)
+		if (modules[i]->cleanup)
+			modules[i]->cleanup();
+
+	cleanup_game_constants();
+}
+
 /**
  * Initialise Angband's data stores and allocate memory for structures,
  * etc, so that the game can get started.
@@ -4560,16 +4593,9 @@ static struct init_module *modules[] = {
  */
 bool init_angband(void)
 {
-	int i;
-
 	event_signal(EVENT_ENTER_INIT);
 
-	init_game_constants();
-
-	/* Initialise modules */
-	for (i = 0; modules[i]; i++)
-		if (modules[i]->init)
-			modules[i]->init();
+	init_game_data();
 
 	/* Initialize some other things */
 	event_signal_message(EVENT_INITSTATUS, 0, "Initializing other stuff...");
@@ -4618,6 +4644,9 @@ void cleanup_angband(void)
 	monster_list_finalize();
 	object_list_finalize();
 
+	/* Free the objects */
+	object_pool_free();
+
 	cleanup_game_constants();
 
 	/* Free the format() buffer */
@@ -158,6 +158,8 @@ extern void init_file_paths(const char *config, const char *lib, const char *dat
 extern void init_game_constants(void);
 extern void init_arrays(void);
 extern void create_needed_dirs(void);
+extern void init_game_data(void);
+extern void cleanup_game_data(void);
 extern bool init_angband(void);
 extern void cleanup_angband(void);
 
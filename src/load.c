@@ -81,6 +81,11 @@ byte trf_size = 0;
  */
 typedef struct object *(*rd_item_t)(void);
 
+/**
+ * Shorthand function pointer for the run length reader of a dungeon version
+ */
+typedef u32b (*rd_run_t)(void);
+
 /**
  * Find an ego item from its index
  */
@@ -812,6 +817,7 @@ int rd_ignore(void)
 
 	/* Read the current number of aware object auto-inscriptions */
 	rd_u16b(&inscriptions);
+	quarks_reserve(inscriptions);
 
 	/* Read the aware object autoinscriptions array */
 	for (i = 0; i < inscriptions; i++) {
@@ -829,6 +835,7 @@ int rd_ignore(void)
 
 	/* Read the current number of unaware object auto-inscriptions */
 	rd_u16b(&inscriptions);
+	quarks_reserve(inscriptions);
 
 	/* Read the unaware object autoinscriptions array */
 	for (i = 0; i < inscriptions; i++) {
@@ -946,6 +953,7 @@ int rd_misc(void)
 	rd_s16b(&player->obj_k->to_d);
 	rd_byte(&player->obj_k->dd);
 	rd_byte(&player->obj_k->ds);
+	knowledge_epoch++;
 	return 0;
 }
 
@@ -1099,6 +1107,12 @@ static int rd_stores_aux(rd_item_t rd_item_version)
 		/* XXX: refactor into store.c */
 		store->owner = store_ownerbyidx(store, own);
 
+		/* Drop any stock left from a game loaded earlier */
+		object_pile_free(store->stock_k);
+		object_pile_free(store->stock);
+		store->stock_k = store->stock = NULL;
+		store->stock_num = 0;
+
 		/* Read the items */
 		for (; num; num--) {
 			/* Read the known item */
@@ -1116,12 +1130,12 @@ static int rd_stores_aux(rd_item_t rd_item_version)
 			}
 			obj->known = known_obj;
 
-			/* Accept any valid items */
+			/* Accept any valid items, in the order they were saved; they
+			 * were stocked before then, so aren't recharged or merged */
 			if (store->stock_num < z_info->store_inven_max && obj->kind) {
-				if (store->sidx == STORE_HOME)
-					home_carry(obj);
-				else
-					store_carry(store, obj);
+				pile_insert_end(&store->stock, obj);
+				pile_insert_end(&store->stock_k, known_obj);
+				store->stock_num++;
 			}
 		}
 	}
@@ -1135,6 +1149,55 @@ static int rd_stores_aux(rd_item_t rd_item_version)
 int rd_stores(void) { return rd_stores_aux(rd_item); }
 
 
+/**
+ * Read the length of a run in a version 1 dungeon: a single byte
+ */
+static u32b rd_run_1(void)
+{
+	byte tmp8u;
+
+	rd_byte(&tmp8u);
+	return tmp8u;
+}
+
+/**
+ * Read the length of a run: seven bits at a time, with the top bit set on
+ * all but the last byte
+ */
+static u32b rd_run(void)
+{
+	u32b count = 0;
+	int shift = 0;
+	byte tmp8u;
+
+	do {
+		rd_byte(&tmp8u);
+		count |= (u32b)(tmp8u & 0x7F) << shift;
+		shift += 7;
+	} while ((tmp8u & 0x80) && (shift < 32));
+
+	return count;
+}
+
+/**
+ * Run length decode one byte for each of the given number of grids
+ */
+static void rd_grid_runs(rd_run_t rd_run_version, byte *data, size_t grids)
+{
+	size_t i = 0;
+
+	while (i < grids) {
+		u32b count = rd_run_version();
+		byte tmp8u;
+
+		rd_byte(&tmp8u);
+
+		/* Apply the run, ignoring anything past the last grid */
+		while (count-- && (i < grids))
+			data[i++] = tmp8u;
+	}
+}
+
 /**
  * Read the dungeon
  *
@@ -1152,17 +1215,17 @@ int rd_stores(void) { return rd_stores_aux(rd_item); }
  * After loading the monsters, the objects being held by monsters are
  * linked directly into those monsters.
  */
-static int rd_dungeon_aux(struct chunk **c)
+static int rd_dungeon_aux(rd_run_t rd_run_version, struct chunk **c)
 {
 	struct chunk *c1 = *c;
-	int i, n, y, x;
 
 	u16b height, width;
 
-	byte count;
 	byte tmp8u;
 	u16b tmp16u;
 	char name[100];
+	byte *data;
+	size_t i, n, grids;
 
 	/* Header info */
 	rd_string(name, sizeof(name));
@@ -1172,54 +1235,23 @@ static int rd_dungeon_aux(struct chunk **c)
 	/* We need a cave struct */
 	c1 = cave_new(height, width);
 	c1->name = string_make(name);
+	grids = c1->height * c1->width;
+	data = mem_alloc(grids);
 
-    /* Run length decoding of cave->squares[y][x].info */
+	/* Run length decoding of cave->squares[y][x].info */
 	for (n = 0; n < square_size; n++) {
-		/* Load the dungeon data */
-		for (x = y = 0; y < c1->height; ) {
-			/* Grab RLE info */
-			rd_byte(&count);
-			rd_byte(&tmp8u);
-
-			/* Apply the RLE info */
-			for (i = count; i > 0; i--) {
-				/* Extract "info" */
-				c1->squares[y][x].info[n] = tmp8u;
-
-				/* Advance/Wrap */
-				if (++x >= c1->width) {
-					/* Wrap */
-					x = 0;
-
-					/* Advance/Wrap */
-					if (++y >= c1->height) break;
-				}
-			}
-		}
+		rd_grid_runs(rd_run_version, data, grids);
+		if (n >= SQUARE_SIZE) continue;
+		for (i = 0; i < grids; i++)
+			c1->squares[i / c1->width][i % c1->width].info[n] = data[i];
 	}
 
 	/* Run length decoding of dungeon data */
-	for (x = y = 0; y < c1->height; ) {
-		/* Grab RLE info */
-		rd_byte(&count);
-		rd_byte(&tmp8u);
-
-		/* Apply the RLE info */
-		for (i = count; i > 0; i--) {
-			/* Extract "feat" */
-			square_set_feat(c1, y, x, tmp8u);
-
-			/* Advance/Wrap */
-			if (++x >= c1->width) {
-				/* Wrap */
-				x = 0;
-
-				/* Advance/Wrap */
-				if (++y >= c1->height) break;
-			}
-		}
-	}
+	rd_grid_runs(rd_run_version, data, grids);
+	for (i = 0; i < grids; i++)
+		square_set_feat(c1, i / c1->width, i % c1->width, data[i]);
 
+	mem_free(data);
 
 	/* Read "feeling" */
 	rd_byte(&tmp8u);
@@ -1338,7 +1370,7 @@ static int rd_traps_aux(struct chunk *c)
     return 0;
 }
 
-int rd_dungeon(void)
+static int rd_level_aux(rd_run_t rd_run_version)
 {
 	u16b depth;
 	u16b py, px;
@@ -1360,7 +1392,7 @@ int rd_dungeon(void)
 		return (0);
 	}
 
-	if (rd_dungeon_aux(&cave))
+	if (rd_dungeon_aux(rd_run_version, &cave))
 		return 1;
 
 	/* Ignore illegal dungeons */
@@ -1380,12 +1412,15 @@ int rd_dungeon(void)
 	character_dungeon = true;
 
 	/* Read known cave */
-	if (rd_dungeon_aux(&cave_k))
+	if (rd_dungeon_aux(rd_run_version, &cave_k))
 		return 1;
 
 	return 0;
 }
 
+int rd_dungeon_1(void) { return rd_level_aux(rd_run_1); }
+int rd_dungeon(void) { return rd_level_aux(rd_run); }
+
 
 /**
  * Read the objects - wrapper functions
@@ -1439,7 +1474,7 @@ int rd_traps(void)
 /**
  * Read the chunk list
  */
-int rd_chunks(void)
+static int rd_chunks_aux(rd_run_t rd_run_version)
 {
 	int j;
 	u16b chunk_max;
@@ -1447,12 +1482,19 @@ int rd_chunks(void)
 	if (player->is_dead)
 		return 0;
 
+	/* The savefile's chunks replace any that are already stored */
+	for (j = 0; j < chunk_list_max; j++)
+		cave_free(chunk_list[j]);
+	mem_free(chunk_list);
+	chunk_list = NULL;
+	chunk_list_max = 0;
+
 	rd_u16b(&chunk_max);
 	for (j = 0; j < chunk_max; j++) {
 		struct chunk *c;
 
 		/* Read the dungeon */
-		if (rd_dungeon_aux(&c))
+		if (rd_dungeon_aux(rd_run_version, &c))
 			return -1;
 
 		/* Read the objects */
@@ -1473,6 +1515,9 @@ int rd_chunks(void)
 	return 0;
 }
 
+int rd_chunks_1(void) { return rd_chunks_aux(rd_run_1); }
+int rd_chunks(void) { return rd_chunks_aux(rd_run); }
+
 
 int rd_history(void)
 {
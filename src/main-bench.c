@@ -0,0 +1,597 @@
+/**
+ * \file main-bench.c
+ * \brief Pseudo-UI for timing fixed-seed workloads (borrows from main-stats.c)
+ *
+ * Copyright (c) 2016 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+
+#ifdef USE_BENCH
+
+#include "buildid.h"
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "main.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "obj-pile.h"
+#include "obj-randart.h"
+#include "player.h"
+#include "player-timed.h"
+#include "project.h"
+#include "savefile.h"
+
+/**
+ * Depth of the levels used by everything but the town profile
+ */
+#define BENCH_DEPTH 30
+
+/**
+ * Number of extra monsters packed onto the level for process_monsters()
+ */
+#define BENCH_CROWD 200
+
+#define BENCH_RESULTS_MAX 32
+
+/**
+ * Timings for one workload; all times are in microseconds
+ */
+struct bench_result {
+	char name[40];
+	int iterations;
+	double total;
+	double min;
+	double max;
+	long check;
+};
+
+static struct bench_result results[BENCH_RESULTS_MAX];
+static int num_results = 0;
+
+static u32b bench_seed = 42;
+static int bench_scale = 1;
+static const char *bench_only = NULL;
+static char *bench_output = NULL;
+static int nextkey = 0;
+static int running_bench = 0;
+
+/**
+ * Current time, in microseconds from some arbitrary point
+ */
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+/**
+ * Start a new result, or return NULL if the workload has been filtered out
+ */
+static struct bench_result *bench_begin(const char *name)
+{
+	struct bench_result *r;
+
+	if (bench_only && !strstr(name, bench_only)) return NULL;
+	if (num_results >= BENCH_RESULTS_MAX) return NULL;
+
+	r = &results[num_results++];
+	my_strcpy(r->name, name, sizeof(r->name));
+	r->iterations = 0;
+	r->total = r->max = 0.0;
+	r->min = -1.0;
+	r->check = 0;
+
+	/* Every workload gets the same random numbers, whatever ran before */
+	Rand_quick = false;
+	Rand_state_init(bench_seed);
+
+	return r;
+}
+
+/**
+ * Record one iteration that started at the given time
+ */
+static void bench_lap(struct bench_result *r, double start)
+{
+	double elapsed = bench_now() - start;
+
+	r->iterations++;
+	r->total += elapsed;
+	if (r->min < 0.0 || elapsed < r->min) r->min = elapsed;
+	if (elapsed > r->max) r->max = elapsed;
+}
+
+/**
+ * Keep the player alive through whatever the workload throws at them
+ */
+static void bench_protect_player(void)
+{
+	player->chp = player->mhp;
+	player->timed[TMD_INVULN] = 1000;
+	player->timed[TMD_PARALYZED] = 0;
+}
+
+/**
+ * Roll up a character the way the birth screens would, and put them in town
+ */
+static void bench_init_character(void)
+{
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Bench");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+
+	OPT(auto_more) = true;
+	player->upkeep->autosave = false;
+
+	player->depth = 0;
+	cave_generate(&cave, player);
+}
+
+/**
+ * Make a fresh level at the given depth with the workload's seed
+ */
+static void bench_new_level(int depth)
+{
+	player->depth = depth;
+	cave_generate(&cave, player);
+	update_view(cave, player);
+	cave_update_flow(cave);
+}
+
+/**
+ * Reload everything read from lib/gamedata.  This throws away the character,
+ * so it has to run before anything else.
+ */
+static void bench_gamedata(void)
+{
+	struct bench_result *r = bench_begin("gamedata_load");
+	int i;
+
+	if (!r) return;
+
+	for (i = 0; i < 5 * bench_scale; i++) {
+		double start = bench_now();
+		cleanup_game_data();
+		init_game_data();
+		bench_lap(r, start);
+	}
+	r->check = z_info->r_max + z_info->k_max;
+}
+
+/**
+ * Generate full random artifact sets.  Each set is built from the one
+ * before, as no fresh copy of the standard artifacts is kept.
+ */
+static void bench_randart(void)
+{
+	struct bench_result *r = bench_begin("randart");
+	int i, j;
+
+	if (!r) return;
+
+	for (i = 0; i < 5 * bench_scale; i++) {
+		double start = bench_now();
+		do_randart((bench_seed + i) | RANDART_SEED_REPAIR, true);
+		bench_lap(r, start);
+		for (j = 0; j < z_info->a_max; j++)
+			r->check += a_info[j].alloc_min + a_info[j].tval;
+	}
+}
+
+/**
+ * Build levels with each cave profile in turn
+ */
+static void bench_generate(void)
+{
+	int i, j;
+
+	for (i = 0; i < z_info->profile_max; i++) {
+		const struct cave_profile *profile = &cave_profiles[i];
+		struct bench_result *r;
+		char name[40];
+
+		strnfmt(name, sizeof(name), "cave_generate/%s", profile->name);
+		r = bench_begin(name);
+		if (!r) continue;
+
+		player->depth = streq(profile->name, "town") ? 0 : BENCH_DEPTH;
+		for (j = 0; j < 10 * bench_scale; j++) {
+			double start = bench_now();
+			cave_generate_profile(&cave, player, profile);
+			bench_lap(r, start);
+			r->check += cave_monster_max(cave) + cave->obj_max;
+		}
+	}
+}
+
+static void bench_view(void)
+{
+	struct bench_result *r = bench_begin("update_view");
+	int i;
+
+	if (!r) return;
+
+	bench_new_level(BENCH_DEPTH);
+	for (i = 0; i < 2000 * bench_scale; i++) {
+		double start = bench_now();
+		update_view(cave, player);
+		bench_lap(r, start);
+	}
+	r->check = cave->view_n;
+}
+
+static void bench_flow(void)
+{
+	struct bench_result *r = bench_begin("cave_update_flow");
+	int i, d, py, px, y, x;
+
+	if (!r) return;
+
+	bench_new_level(BENCH_DEPTH);
+	py = player->py;
+	px = player->px;
+
+	/* Step the player back and forth, so every update has work to do */
+	for (d = 0; d < 8; d++) {
+		y = py + ddy_ddd[d];
+		x = px + ddx_ddd[d];
+		if (square_ispassable(cave, y, x)) break;
+	}
+	if (d == 8) {
+		y = py;
+		x = px;
+	}
+
+	for (i = 0; i < 2000 * bench_scale; i++) {
+		double start = bench_now();
+		player->py = (i % 2) ? y : py;
+		player->px = (i % 2) ? x : px;
+		cave_update_flow(cave);
+		bench_lap(r, start);
+	}
+	player->py = py;
+	player->px = px;
+	cave_update_flow(cave);
+	r->check = cave->width * cave->height;
+}
+
+/**
+ * Run game turns for monsters on a level packed with awake monsters
+ */
+static void bench_monsters(void)
+{
+	struct bench_result *r = bench_begin("process_monsters");
+	struct loc grid;
+	int i;
+
+	if (!r) return;
+
+	bench_new_level(BENCH_DEPTH);
+	grid = loc(player->px, player->py);
+	for (i = 0; i < BENCH_CROWD; i++)
+		if (!pick_and_place_distant_monster(cave, grid, 5, false,
+											BENCH_DEPTH))
+			break;
+
+	for (i = 0; i < 2000 * bench_scale; i++) {
+		double start;
+
+		bench_protect_player();
+		start = bench_now();
+		process_monsters(cave, 0);
+		reset_monsters();
+		turn++;
+		bench_lap(r, start);
+	}
+	r->check = cave_monster_count(cave);
+}
+
+/**
+ * Fire balls at grids around the player
+ */
+static void bench_project(void)
+{
+	struct bench_result *r = bench_begin("project_ball");
+	int flg = PROJECT_STOP | PROJECT_GRID | PROJECT_ITEM | PROJECT_KILL;
+	int i;
+
+	if (!r) return;
+
+	bench_new_level(BENCH_DEPTH);
+	for (i = 0; i < 2000 * bench_scale; i++) {
+		int y = player->py + rand_spread(0, z_info->max_range / 2);
+		int x = player->px + rand_spread(0, z_info->max_range / 2);
+		double start;
+
+		if (!square_in_bounds_fully(cave, y, x)) continue;
+
+		bench_protect_player();
+		start = bench_now();
+		project(-1, 2, y, x, 30, GF_FIRE, flg, 0, 0, NULL);
+		bench_lap(r, start);
+	}
+	r->check = cave_monster_count(cave);
+}
+
+/**
+ * Save and reload the game
+ */
+static void bench_savefile(void)
+{
+	struct bench_result *r = bench_begin("savefile_roundtrip");
+	char path[1024];
+	int i;
+
+	if (!r) return;
+
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, "bench.sav");
+	bench_new_level(BENCH_DEPTH);
+	for (i = 0; i < 20 * bench_scale; i++) {
+		double start = bench_now();
+		if (!savefile_save(path) || !savefile_load(path, false))
+			quit("Savefile round trip failed!");
+		bench_lap(r, start);
+	}
+	r->check = cave_monster_count(cave) + cave->obj_max;
+	file_delete(path);
+}
+
+/**
+ * Write the results as JSON
+ */
+static void bench_report(FILE *f)
+{
+	struct object_pool_stats pool;
+	int i;
+
+	object_pool_get_stats(&pool);
+
+	fprintf(f, "{\n");
+	fprintf(f, "  \"version\": \"%s\",\n", buildid);
+	fprintf(f, "  \"seed\": %lu,\n", (unsigned long)bench_seed);
+	fprintf(f, "  \"scale\": %d,\n", bench_scale);
+	fprintf(f, "  \"benchmarks\": [");
+	for (i = 0; i < num_results; i++) {
+		struct bench_result *r = &results[i];
+		double mean = r->iterations ? r->total / r->iterations : 0.0;
+
+		fprintf(f, "%s\n    {\"name\": \"%s\", \"iterations\": %d, "
+				"\"total_ms\": %.3f, \"mean_us\": %.3f, \"min_us\": %.3f, "
+				"\"max_us\": %.3f, \"check\": %ld}", i ? "," : "",
+				r->name, r->iterations, r->total / 1000.0, mean,
+				MAX(r->min, 0.0), r->max, r->check);
+	}
+	fprintf(f, "\n  ],\n");
+	fprintf(f, "  \"object_pool\": {\"slabs\": %lu, \"capacity\": %lu, "
+			"\"in_use\": %lu, \"peak\": %lu, \"allocs\": %lu, "
+			"\"frees\": %lu}\n", (unsigned long)pool.slabs,
+			(unsigned long)pool.capacity, (unsigned long)pool.in_use,
+			(unsigned long)pool.peak, (unsigned long)pool.allocs,
+			(unsigned long)pool.frees);
+	fprintf(f, "}\n");
+}
+
+static errr run_bench(void)
+{
+	FILE *f;
+
+	bench_gamedata();
+
+	/* Everything after this needs a character in the dungeon */
+	Rand_quick = false;
+	Rand_state_init(bench_seed);
+	bench_init_character();
+
+	bench_generate();
+	bench_view();
+	bench_flow();
+	bench_monsters();
+	bench_project();
+	bench_savefile();
+	bench_randart();
+
+	if (bench_output) {
+		f = fopen(bench_output, "w");
+		if (!f) quit_fmt("Couldn't open %s!", bench_output);
+		bench_report(f);
+		fclose(f);
+	} else {
+		bench_report(stdout);
+		fflush(stdout);
+	}
+
+	cleanup_angband();
+	quit(NULL);
+	exit(0);
+}
+
+typedef struct term_data term_data;
+struct term_data {
+	term t;
+};
+
+static term_data td;
+typedef struct {
+	int key;
+	errr (*func)(int v);
+} term_xtra_func;
+
+static void term_init_bench(term *t) {
+	return;
+}
+
+static void term_nuke_bench(term *t) {
+	return;
+}
+
+static errr term_xtra_clear(int v) {
+	return 0;
+}
+
+static errr term_xtra_noise(int v) {
+	return 0;
+}
+
+static errr term_xtra_fresh(int v) {
+	return 0;
+}
+
+static errr term_xtra_shape(int v) {
+	return 0;
+}
+
+static errr term_xtra_alive(int v) {
+	return 0;
+}
+
+static errr term_xtra_event(int v) {
+	if (nextkey) {
+		Term_keypress(nextkey, 0);
+		nextkey = 0;
+	}
+	if (running_bench) {
+		/* Nothing in a workload should wait for a key; escape if it does */
+		Term_keypress(ESCAPE, 0);
+		return 0;
+	}
+	running_bench = 1;
+	return run_bench();
+}
+
+static errr term_xtra_flush(int v) {
+	return 0;
+}
+
+static errr term_xtra_delay(int v) {
+	return 0;
+}
+
+static errr term_xtra_react(int v) {
+	return 0;
+}
+
+static term_xtra_func xtras[] = {
+	{ TERM_XTRA_CLEAR, term_xtra_clear },
+	{ TERM_XTRA_NOISE, term_xtra_noise },
+	{ TERM_XTRA_FRESH, term_xtra_fresh },
+	{ TERM_XTRA_SHAPE, term_xtra_shape },
+	{ TERM_XTRA_ALIVE, term_xtra_alive },
+	{ TERM_XTRA_EVENT, term_xtra_event },
+	{ TERM_XTRA_FLUSH, term_xtra_flush },
+	{ TERM_XTRA_DELAY, term_xtra_delay },
+	{ TERM_XTRA_REACT, term_xtra_react },
+	{ 0, NULL },
+};
+
+static errr term_xtra_bench(int n, int v) {
+	int i;
+	for (i = 0; xtras[i].func; i++) {
+		if (xtras[i].key == n) {
+			return xtras[i].func(v);
+		}
+	}
+	return 0;
+}
+
+static errr term_curs_bench(int x, int y) {
+	return 0;
+}
+
+static errr term_wipe_bench(int x, int y, int n) {
+	return 0;
+}
+
+static errr term_text_bench(int x, int y, int n, int a, const wchar_t *s) {
+	return 0;
+}
+
+static void term_data_link(int i) {
+	term *t = &td.t;
+
+	term_init(t, 80, 24, 256);
+
+	/* Ignore some actions for efficiency and safety */
+	t->never_bored = true;
+	t->never_frosh = true;
+
+	t->init_hook = term_init_bench;
+	t->nuke_hook = term_nuke_bench;
+
+	t->xtra_hook = term_xtra_bench;
+	t->curs_hook = term_curs_bench;
+	t->wipe_hook = term_wipe_bench;
+	t->text_hook = term_text_bench;
+
+	t->data = &td;
+
+	Term_activate(t);
+
+	angband_term[i] = t;
+}
+
+const char help_bench[] = "Benchmark mode, subopts -s(eed) -n(scale) -o(utput file) -w(orkload filter)";
+
+/**
+ * Usage:
+ *
+ * angband -mbench -- [-sNNNN] [-nNN] [-o<file>] [-w<name>]
+ *
+ *   -sNNNN   Seed the workloads with NNNN (default: 42)
+ *   -nNN     Multiply the iterations of every workload by NN (default: 1)
+ *   -o<file> Write the JSON results to <file> rather than stdout
+ *   -w<name> Only run workloads whose names contain <name>
+ */
+errr init_bench(int argc, char *argv[]) {
+	int i;
+
+	/* Skip over argv[0] */
+	for (i = 1; i < argc; i++) {
+		if (prefix(argv[i], "-s")) {
+			bench_seed = strtoul(&argv[i][2], NULL, 0);
+			continue;
+		}
+		if (prefix(argv[i], "-n")) {
+			bench_scale = MAX(atoi(&argv[i][2]), 1);
+			continue;
+		}
+		if (prefix(argv[i], "-o")) {
+			bench_output = &argv[i][2];
+			continue;
+		}
+		if (prefix(argv[i], "-w")) {
+			bench_only = &argv[i][2];
+			continue;
+		}
+		printf("init-bench: bad argument '%s'\n", argv[i]);
+	}
+
+	term_data_link(0);
+	return 0;
+}
+
+#endif /* USE_BENCH */
@@ -0,0 +1,243 @@
+/**
+ * \file main-replay.c
+ * \brief Pseudo-UI for playing back a journal (borrows from main-bench.c)
+ *
+ * Copyright (c) 2016 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+
+#ifdef USE_REPLAY
+
+#include "game-journal.h"
+#include "game-world.h"
+#include "init.h"
+#include "main.h"
+#include "player.h"
+
+static const char *replay_path = NULL;
+static bool replay_verify = false;
+static bool replay_quiet = false;
+static int nextkey = 0;
+static int running_replay = 0;
+
+/**
+ * Current time, in microseconds from some arbitrary point
+ */
+static double replay_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static errr run_replay(void)
+{
+	struct journal_stats stats;
+	s32b start_turn;
+	double start;
+
+	if (!replay_path) quit("No journal to replay; use -f<file>");
+	if (!journal_replay_start(replay_path, replay_verify))
+		quit_fmt("Couldn't load the journal %s", replay_path);
+
+	/* Play the game as the journal says, as play_game() would */
+	start_turn = turn;
+	start = replay_now();
+	while (!player->is_dead && player->upkeep->playing &&
+		   journal_replay_step())
+		run_game_loop();
+	journal_replay_finish(&stats);
+
+	if (!replay_quiet) {
+		printf("steps:     %d\n", stats.steps);
+		printf("commands:  %d\n", stats.commands);
+		printf("answers:   %d\n", stats.answers);
+		if (replay_verify)
+			printf("verified:  %d of %d checkpoints\n", stats.verified,
+				   stats.checks);
+		else
+			printf("checks:    %d (not verified)\n", stats.checks);
+		printf("turns:     %ld\n", (long)(turn - start_turn));
+		printf("time_ms:   %.3f\n", (replay_now() - start) / 1000.0);
+		fflush(stdout);
+	}
+
+	cleanup_angband();
+	quit(NULL);
+	exit(0);
+}
+
+typedef struct term_data term_data;
+struct term_data {
+	term t;
+};
+
+static term_data td;
+typedef struct {
+	int key;
+	errr (*func)(int v);
+} term_xtra_func;
+
+static void term_init_replay(term *t) {
+	return;
+}
+
+static void term_nuke_replay(term *t) {
+	return;
+}
+
+static errr term_xtra_clear(int v) {
+	return 0;
+}
+
+static errr term_xtra_noise(int v) {
+	return 0;
+}
+
+static errr term_xtra_fresh(int v) {
+	return 0;
+}
+
+static errr term_xtra_shape(int v) {
+	return 0;
+}
+
+static errr term_xtra_alive(int v) {
+	return 0;
+}
+
+static errr term_xtra_event(int v) {
+	if (nextkey) {
+		Term_keypress(nextkey, 0);
+		nextkey = 0;
+	}
+	if (running_replay) {
+		/* Nothing in a replay should wait for a key; escape if it does */
+		Term_keypress(ESCAPE, 0);
+		return 0;
+	}
+	running_replay = 1;
+	return run_replay();
+}
+
+static errr term_xtra_flush(int v) {
+	return 0;
+}
+
+static errr term_xtra_delay(int v) {
+	return 0;
+}
+
+static errr term_xtra_react(int v) {
+	return 0;
+}
+
+static term_xtra_func xtras[] = {
+	{ TERM_XTRA_CLEAR, term_xtra_clear },
+	{ TERM_XTRA_NOISE, term_xtra_noise },
+	{ TERM_XTRA_FRESH, term_xtra_fresh },
+	{ TERM_XTRA_SHAPE, term_xtra_shape },
+	{ TERM_XTRA_ALIVE, term_xtra_alive },
+	{ TERM_XTRA_EVENT, term_xtra_event },
+	{ TERM_XTRA_FLUSH, term_xtra_flush },
+	{ TERM_XTRA_DELAY, term_xtra_delay },
+	{ TERM_XTRA_REACT, term_xtra_react },
+	{ 0, NULL },
+};
+
+static errr term_xtra_replay(int n, int v) {
+	int i;
+	for (i = 0; xtras[i].func; i++) {
+		if (xtras[i].key == n) {
+			return xtras[i].func(v);
+		}
+	}
+	return 0;
+}
+
+static errr term_curs_replay(int x, int y) {
+	return 0;
+}
+
+static errr term_wipe_replay(int x, int y, int n) {
+	return 0;
+}
+
+static errr term_text_replay(int x, int y, int n, int a, const wchar_t *s) {
+	return 0;
+}
+
+static void term_data_link(int i) {
+	term *t = &td.t;
+
+	term_init(t, 80, 24, 256);
+
+	/* Ignore some actions for efficiency and safety */
+	t->never_bored = true;
+	t->never_frosh = true;
+
+	t->init_hook = term_init_replay;
+	t->nuke_hook = term_nuke_replay;
+
+	t->xtra_hook = term_xtra_replay;
+	t->curs_hook = term_curs_replay;
+	t->wipe_hook = term_wipe_replay;
+	t->text_hook = term_text_replay;
+
+	t->data = &td;
+
+	Term_activate(t);
+
+	angband_term[i] = t;
+}
+
+const char help_replay[] = "Journal replay mode, subopts -f(ile) -v(erify) -q(uiet)";
+
+/**
+ * Usage:
+ *
+ * angband -mreplay -- -f<file> [-v] [-q]
+ *
+ *   -f<file> Replay the journal in <file>, as written by angband -j
+ *   -v       Check the game's state against each checkpoint in the journal,
+ *            and stop at the first that doesn't match
+ *   -q       Don't print a summary at the end
+ */
+errr init_replay(int argc, char *argv[]) {
+	int i;
+
+	/* Skip over argv[0] */
+	for (i = 1; i < argc; i++) {
+		if (prefix(argv[i], "-f")) {
+			replay_path = &argv[i][2];
+			continue;
+		}
+		if (streq(argv[i], "-v")) {
+			replay_verify = true;
+			continue;
+		}
+		if (streq(argv[i], "-q")) {
+			replay_quiet = true;
+			continue;
+		}
+		printf("init-replay: bad argument '%s'\n", argv[i]);
+	}
+
+	term_data_link(0);
+	return 0;
+}
+
+#endif /* USE_REPLAY */
@@ -41,6 +41,8 @@
 #include "store.h"
 #include <stddef.h>
 #include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
 
 #define OBJ_FEEL_MAX	 11
 #define MON_FEEL_MAX 	 10
@@ -65,6 +67,8 @@
 static int randarts = 0;
 static int no_selling = 0;
 static u32b num_runs = 1;
+static int num_workers = 1;
+static int worker = 0;
 static bool quiet = false;
 static int nextkey = 0;
 static int running_stats = 0;
@@ -188,6 +192,9 @@ static void generate_player_for_stats()
 	player->race = races;  /* Human   */
 	player->class = classes; /* Warrior */
 
+	/* Equipment slots */
+	player_embody(player);
+
 	/* Level 1 */
 	player->max_lev = player->lev = 1;
 
@@ -221,7 +228,8 @@ static void initialize_character(void)
 		fflush(stdout);
 	}
 
-	seed = (time(NULL));
+	/* Keep parallel workers from sharing seeds */
+	seed = (time(NULL)) + worker * 0x9E3779B9;
 	Rand_quick = false;
 	Rand_state_init(seed);
 
@@ -229,7 +237,7 @@ static void initialize_character(void)
 	generate_player_for_stats();
 
 	seed_flavor = randint0(0x10000000);
-	seed_randart = randint0(0x10000000);
+	seed_randart = randint0(0x10000000) | RANDART_SEED_REPAIR;
 
 	if (randarts)
 	{
@@ -301,6 +309,9 @@ static void log_all_objects(int level)
 			for (obj = square_object(cave, y, x); obj; obj = obj->next) {
 				/*	u32b o_power = 0; */
 
+				/* Only some origins are catalogued */
+				if (obj->origin >= ORIGIN_STATS) continue;
+
 /*				o_power = object_power(obj, false, NULL, true); */
 
 				/* Capture gold amounts */
@@ -1429,6 +1440,106 @@ static int stats_write_db(u32b run)
 	return SQLITE_OK;
 }
 
+/**
+ * Send an array of counts down a pipe, or read one from a pipe and add it to
+ * the counts we already have.
+ */
+static bool stats_transfer_u32b(int fd, u32b *data, size_t n, bool send)
+{
+	u32b buf[1024];
+	size_t done = 0;
+
+	if (send) {
+		while (done < n * sizeof(u32b)) {
+			ssize_t len = write(fd, (byte *)data + done,
+								n * sizeof(u32b) - done);
+			if (len <= 0) return false;
+			done += len;
+		}
+		return true;
+	}
+
+	while (n) {
+		size_t i, want = MIN(n, N_ELEMENTS(buf));
+
+		/* Read a full block */
+		done = 0;
+		while (done < want * sizeof(u32b)) {
+			ssize_t len = read(fd, (byte *)buf + done,
+							   want * sizeof(u32b) - done);
+			if (len <= 0) return false;
+			done += len;
+		}
+
+		/* Merge it */
+		for (i = 0; i < want; i++)
+			data[i] += buf[i];
+		data += want;
+		n -= want;
+	}
+
+	return true;
+}
+
+/**
+ * Send all the collected data down a pipe, or merge a worker's data from one.
+ * Both ends walk level_data in the same order.
+ */
+static bool stats_transfer(int fd, bool send)
+{
+	int i, j, k, l;
+
+	for (i = 0; i < LEVEL_MAX; i++) {
+		struct level_data *ld = &level_data[i];
+
+		if (!stats_transfer_u32b(fd, ld->monsters, z_info->r_max, send) ||
+			!stats_transfer_u32b(fd, ld->obj_feelings, OBJ_FEEL_MAX, send) ||
+			!stats_transfer_u32b(fd, ld->mon_feelings, MON_FEEL_MAX, send))
+			return false;
+
+		/* Gold is the only wide count */
+		for (j = 0; j < ORIGIN_STATS; j++) {
+			u32b gold[2];
+
+			gold[0] = (u32b)(ld->gold[j] >> 32);
+			gold[1] = (u32b)(ld->gold[j] & 0xFFFFFFFF);
+			if (!send) gold[0] = gold[1] = 0;
+			if (!stats_transfer_u32b(fd, gold, 2, send)) return false;
+			if (!send)
+				ld->gold[j] += ((long long)gold[0] << 32) + gold[1];
+		}
+
+		for (j = 0; j < ORIGIN_STATS; j++) {
+			if (!stats_transfer_u32b(fd, ld->artifacts[j], z_info->a_max,
+									 send) ||
+				!stats_transfer_u32b(fd, ld->consumables[j],
+									 consumable_count + 1, send))
+				return false;
+
+			for (k = 0; k < wearable_count + 1; k++) {
+				struct wearables_data *w = &ld->wearables[j][k];
+
+				if (!stats_transfer_u32b(fd, &w->count, 1, send) ||
+					!stats_transfer_u32b(fd, &w->dice[0][0],
+										 TOP_DICE * TOP_SIDES, send) ||
+					!stats_transfer_u32b(fd, w->ac, TOP_AC, send) ||
+					!stats_transfer_u32b(fd, w->hit, TOP_PLUS, send) ||
+					!stats_transfer_u32b(fd, w->dam, TOP_PLUS, send) ||
+					!stats_transfer_u32b(fd, w->egos, z_info->e_max, send) ||
+					!stats_transfer_u32b(fd, w->flags, OF_MAX, send))
+					return false;
+
+				for (l = 0; l < TOP_MOD; l++)
+					if (!stats_transfer_u32b(fd, w->modifiers[l],
+											 OBJ_MOD_MAX + 1, send))
+						return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 /**
  * Call with the number of runs that have been completed.
  */
@@ -1465,42 +1576,27 @@ void progress_bar(u32b run, time_t start) {
 
 static void stats_cleanup_angband_run(void)
 {
+	int i;
+
 	if (player->history) mem_free(player->history);
+	player->history = NULL;
+	for (i = 0; i < player->body.count; i++)
+		string_free(player->body.slots[i].name);
+	mem_free(player->body.slots);
+	string_free(player->body.name);
+	memset(&player->body, 0, sizeof(player->body));
 }
 
-static errr run_stats(void)
+/**
+ * Make the given number of runs through the dungeon
+ */
+static void stats_do_runs(u32b runs, struct artifact *a_info_save)
 {
 	u32b run;
-	struct artifact *a_info_save;
 	unsigned int i;
-	int err;
-	bool status; 
-
-	time_t start;
-
-	prep_output_dir();
-	create_indices();
-	alloc_memory();
-	if (randarts) {
-		a_info_save = mem_zalloc(z_info->a_max * sizeof(struct artifact));
-		for (i = 0; i < z_info->a_max; i++) {
-			if (!a_info[i].name) continue;
-
-			memcpy(&a_info_save[i], &a_info[i], sizeof(struct artifact));
-		}
-	}
-
-	if (!quiet) printf("Creating the database and dumping info...\n");
-	status = stats_prep_db();
-	if (!status) quit("Couldn't prepare database!");
+	time_t start = time(NULL);
 
-	if (!quiet) {
-		printf("Beginning %d runs...\n", num_runs);
-		fflush(stdout);
-	}
-
-	start = time(NULL);
-	for (run = 1; run <= num_runs; run++) {
+	for (run = 1; run <= runs; run++) {
 		if (!quiet) progress_bar(run - 1, start);
 
 		if (randarts)
@@ -1513,9 +1609,9 @@ static errr run_stats(void)
 		descend_dungeon();
 		stats_cleanup_angband_run();
 
-		/* Checkpoint every so many runs */
-		if (run % RUNS_PER_CHECKPOINT == 0) {
-			err = stats_write_db(run);
+		/* Checkpoint every so many runs (the workers' data stays private) */
+		if (num_workers == 1 && run % RUNS_PER_CHECKPOINT == 0) {
+			int err = stats_write_db(run);
 			if (err) {
 				stats_db_close();
 				quit_fmt("Problems writing to database!  sqlite3 errno %d.",
@@ -1524,18 +1620,117 @@ static errr run_stats(void)
 		}
 
 		if (quiet && run % 1000 == 0) {
-			printf("Finished %d runs.\n", run);
+			if (num_workers > 1)
+				printf("Worker %d finished %d runs.\n", worker, run);
+			else
+				printf("Finished %d runs.\n", run);
+			fflush(stdout);
+		}
+	}
+
+	if (!quiet) progress_bar(runs, start);
+}
+
+/**
+ * Split the runs between forked workers, each with its own copy of the game
+ * state and its own seeds, then merge the data they collected.
+ */
+static void stats_do_parallel_runs(struct artifact *a_info_save)
+{
+	pid_t *pids = mem_zalloc(num_workers * sizeof(pid_t));
+	int *fds = mem_zalloc(num_workers * sizeof(int));
+	bool failed = false;
+
+	/* Start the workers */
+	for (worker = 0; worker < num_workers; worker++) {
+		u32b runs = num_runs / num_workers +
+			((u32b)worker < num_runs % num_workers ? 1 : 0);
+		int pipefd[2];
+
+		if (pipe(pipefd)) quit("Couldn't create a pipe for a worker!");
+
+		fflush(stdout);
+		pids[worker] = fork();
+		if (pids[worker] < 0) quit("Couldn't start a worker!");
+
+		if (pids[worker] == 0) {
+			/* Only the parent talks to the database and the terminal */
+			close(pipefd[0]);
+			quiet = true;
+			stats_do_runs(runs, a_info_save);
+			_exit(stats_transfer(pipefd[1], true) ? 0 : 1);
+		}
+
+		close(pipefd[1]);
+		fds[worker] = pipefd[0];
+	}
+
+	/* Collect their data in turn */
+	for (worker = 0; worker < num_workers; worker++) {
+		int status;
+
+		if (!stats_transfer(fds[worker], false))
+			failed = true;
+		close(fds[worker]);
+		if (waitpid(pids[worker], &status, 0) < 0 || !WIFEXITED(status) ||
+			WEXITSTATUS(status))
+			failed = true;
+
+		if (!quiet) {
+			printf("\rMerged %d/%d workers.", worker + 1, num_workers);
 			fflush(stdout);
 		}
 	}
+	worker = 0;
+
+	mem_free(fds);
+	mem_free(pids);
+
+	if (failed) {
+		stats_db_close();
+		quit("A stats worker failed!");
+	}
+}
+
+static errr run_stats(void)
+{
+	struct artifact *a_info_save = NULL;
+	unsigned int i;
+	int err;
+	bool status; 
+
+	prep_output_dir();
+	create_indices();
+	alloc_memory();
+	if (randarts) {
+		a_info_save = mem_zalloc(z_info->a_max * sizeof(struct artifact));
+		for (i = 0; i < z_info->a_max; i++) {
+			if (!a_info[i].name) continue;
+
+			memcpy(&a_info_save[i], &a_info[i], sizeof(struct artifact));
+		}
+	}
+
+	if (!quiet) printf("Creating the database and dumping info...\n");
+	status = stats_prep_db();
+	if (!status) quit("Couldn't prepare database!");
+
+	if (!quiet) {
+		printf("Beginning %d runs...\n", num_runs);
+		fflush(stdout);
+	}
+
+	if (num_workers > 1)
+		stats_do_parallel_runs(a_info_save);
+	else
+		stats_do_runs(num_runs, a_info_save);
 
 	if (!quiet) {
-		progress_bar(num_runs, start);
 		printf("\nSaving the data...\n");
 		fflush(stdout);
 	}
 
-	err = stats_write_db(run);
+	err = stats_write_db(num_runs + 1);
 	stats_db_close();
 	if (err) quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
 
@@ -1670,17 +1865,18 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling)";
+const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling) -j(# of workers)";
 
 /**
  * Usage:
  *
- * angband -mstats -- [-q] [-r] [-nNNNN] [-s]
+ * angband -mstats -- [-q] [-r] [-nNNNN] [-s] [-jNN]
  *
  *   -q      Quiet mode (turn off progress messages)
  *   -r      Turn on randarts
  *   -nNNNN  Make NNNN runs through the dungeon (default: 1)
  *   -s      Turn on no-selling
+ *   -jNN    Split the runs between NN worker processes (default: 1)
  */
 
 errr init_stats(int argc, char *argv[]) {
@@ -1704,6 +1900,10 @@ errr init_stats(int argc, char *argv[]) {
 			no_selling = 1;
 			continue;
 		}
+		if (prefix(argv[i], "-j")) {
+			num_workers = MAX(atoi(&argv[i][2]), 1);
+			continue;
+		}
 		printf("init-stats: bad argument '%s'\n", argv[i]);
 	}
 
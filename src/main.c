@@ -17,6 +17,7 @@
  */
 
 #include "angband.h"
+#include "game-journal.h"
 #include "init.h"
 #include "mon-power.h"
 #include "savefile.h"
@@ -71,6 +72,13 @@ static const struct module modules[] =
 #ifdef USE_STATS
 	{ "stats", help_stats, init_stats },
 #endif /* USE_STATS */
+
+#ifdef USE_BENCH
+	{ "bench", help_bench, init_bench },
+#endif /* USE_BENCH */
+#ifdef USE_REPLAY
+	{ "replay", help_replay, init_replay },
+#endif /* USE_REPLAY */
 };
 
 /**
@@ -369,6 +377,10 @@ int main(int argc, char *argv[])
 				arg_rebalance = true;
 				break;
 
+			case 'j':
+				arg_journal = true;
+				break;
+
 			case 'g':
 				/* Default graphics tile */
 				/* in graphics.txt, 2 corresponds to adam bolt's tiles */
@@ -434,6 +446,7 @@ int main(int argc, char *argv[])
 				puts("  -l             Lists all savefiles you can play");
 				puts("  -w             Resurrect dead character (marks savefile)");
 				puts("  -r             Rebalance monsters");
+				puts("  -j             Record a journal of this session next to the savefile");
 				puts("  -g             Request graphics mode");
 				puts("  -x<opt>        Debug options; see -xhelp");
 				puts("  -u<who>        Use your <who> savefile");
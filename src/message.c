@@ -24,29 +24,48 @@
 #include "init.h"
 #include "player.h"
 
+/**
+ * Number of messages kept in the history
+ */
+#define MESSAGE_MAX 2048
+
+/**
+ * Bytes of message text kept per message in the history, on average; older
+ * messages are dropped early if the text overflows this
+ */
+#define MESSAGE_TEXT_AVG 64
+
+/**
+ * A message in the history; the text lives in the message queue's arena
+ */
 typedef struct _message_t
 {
-	char *str;
-	struct _message_t *newer;
-	struct _message_t *older;
+	u32b offset;
 	u16b type;
 	u16b count;
 } message_t;
 
-typedef struct _msgcolor_t
-{
-	u16b type;
-	byte color;
-	struct _msgcolor_t *next;
-} msgcolor_t;
-
+/**
+ * The message history, kept as a ring of message records over a ring of text.
+ *
+ * Records are stored oldest first from `tail`, so the message of age `age` is
+ * found directly at `tail + count - 1 - age`.  Text is written into the arena
+ * one string after the other, going back to the start when the next string
+ * won't fit before the end; each new string claims the space held by the
+ * oldest messages, which are dropped.
+ */
 typedef struct _msgqueue_t
 {
-	message_t *head;
-	message_t *tail;
-	msgcolor_t *colors;
+	message_t *msgs;
+	u32b tail;
 	u32b count;
 	u32b max;
+
+	char *text;
+	u32b text_head;
+	u32b text_size;
+
+	byte colors[MSG_MAX];
 } msgqueue_t;
 
 static msgqueue_t *messages = NULL;
@@ -62,7 +81,10 @@ static msgqueue_t *messages = NULL;
 void messages_init(void)
 {
 	messages = mem_zalloc(sizeof(msgqueue_t));
-	messages->max = 2048;
+	messages->max = MESSAGE_MAX;
+	messages->msgs = mem_zalloc(messages->max * sizeof(message_t));
+	messages->text_size = messages->max * MESSAGE_TEXT_AVG;
+	messages->text = mem_zalloc(messages->text_size);
 }
 
 /**
@@ -70,25 +92,10 @@ void messages_init(void)
  */
 void messages_free(void)
 {
-	msgcolor_t *c = messages->colors;
-	msgcolor_t *nextc;
-	message_t *m = messages->head;
-	message_t *nextm;
-
-	while (m) {
-		nextm = m->older;
-		mem_free(m->str);
-		mem_free(m);
-		m = nextm;
-	}
-
-	while (c) {
-		nextc = c->next;
-		mem_free(c);
-		c = nextc;
-	}
-
+	mem_free(messages->text);
+	mem_free(messages->msgs);
 	mem_free(messages);
+	messages = NULL;
 }
 
 /**
@@ -103,6 +110,55 @@ u16b messages_num(void)
  * ------------------------------------------------------------------------
  * Functions for individual messages
  * ------------------------------------------------------------------------ */
+/**
+ * Returns the message of age `age`.
+ */
+static message_t *message_get(u16b age)
+{
+	if (age >= messages->count)
+		return NULL;
+
+	return &messages->msgs[(messages->tail + messages->count - 1 - age) %
+						   messages->max];
+}
+
+/**
+ * Forget the oldest message.
+ */
+static void message_drop_oldest(void)
+{
+	messages->tail = (messages->tail + 1) % messages->max;
+	messages->count--;
+}
+
+/**
+ * Find room in the arena for `len` bytes of text, dropping the oldest messages
+ * whose text is in the way, and return the offset of that room.
+ */
+static u32b message_text_alloc(u32b len)
+{
+	u32b start = messages->text_head;
+
+	/* Wrap round, dropping everything left over from the last time round */
+	if (start + len > messages->text_size) {
+		while (messages->count &&
+			   message_get(messages->count - 1)->offset >= start)
+			message_drop_oldest();
+		start = 0;
+	}
+
+	/* Drop messages whose text starts in the space wanted */
+	while (messages->count) {
+		u32b offset = message_get(messages->count - 1)->offset;
+
+		if (offset < start || offset >= start + len) break;
+		message_drop_oldest();
+	}
+
+	messages->text_head = start + len;
+	return start;
+}
+
 /**
  * Save a new message into the memory buffer, with text `str` and type `type`.
  * The type should be one of the MSG_ constants defined in message.h.
@@ -113,55 +169,36 @@ u16b messages_num(void)
  */
 void message_add(const char *str, u16b type)
 {
-	message_t *m;
+	message_t *m = message_get(0);
+	size_t len = strlen(str);
+	u32b offset;
 
-	if (messages->head &&
-	    messages->head->type == type &&
-	    !strcmp(messages->head->str, str)) {
-		messages->head->count++;
+	/* Coalesce repeats in place */
+	if (m && m->type == type && !strcmp(messages->text + m->offset, str)) {
+		m->count++;
 		return;
 	}
 
-	m = mem_zalloc(sizeof(message_t));
-	m->str = string_make(str);
-	m->type = type;
-	m->count = 1;
-	m->older = messages->head;
-
-	if (messages->head)
-		messages->head->newer = m;
+	/* Keep the text to a size the arena can always hold */
+	if (len >= messages->text_size / 2)
+		len = messages->text_size / 2 - 1;
 
-	messages->head = m;
-	messages->count++;
+	/* Claim space for the text before the record, as it may drop messages */
+	offset = message_text_alloc(len + 1);
+	memcpy(messages->text + offset, str, len);
+	messages->text[offset + len] = '\0';
 
-	if (!messages->tail)
-		messages->tail = m;
+	/* Drop the oldest message if the history is full */
+	if (messages->count == messages->max)
+		message_drop_oldest();
 
-	if (messages->count > messages->max) {
-		message_t *old_tail = messages->tail;
-
-		messages->tail = old_tail->newer;
-		messages->tail->older = NULL;
-		mem_free(old_tail->str);
-		mem_free(old_tail);
-		messages->count--;
-	}
-}
-
-/**
- * Returns the message of age `age`.
- */
-static message_t *message_get(u16b age)
-{
-	message_t *m = messages->head;
-
-	while (m && age--)
-		m = m->older;
-
-	return m;
+	m = &messages->msgs[(messages->tail + messages->count) % messages->max];
+	messages->count++;
+	m->offset = offset;
+	m->type = type;
+	m->count = 1;
 }
 
-
 /**
  * Returns the text of the message of age `age`.  The age of the most recently
  * saved message is 0, the one before that is of age 1, etc.
@@ -172,7 +209,7 @@ static message_t *message_get(u16b age)
 const char *message_str(u16b age)
 {
 	message_t *m = message_get(age);
-	return (m ? m->str : "");
+	return (m ? messages->text + m->offset : "");
 }
 
 /**
@@ -222,28 +259,8 @@ byte message_color(u16b age)
  */
 void message_color_define(u16b type, byte color)
 {
-	msgcolor_t *mc;
-
-	if (!messages->colors)
-	{
-		messages->colors = mem_zalloc(sizeof(msgcolor_t));
-		messages->colors->type = type;
-		messages->colors->color = color;
-	}
-
-	mc = messages->colors;
-	while (mc->next)
-	{
-		if (mc->type == type)
-		{
-			mc->color = color;
-		}
-		mc = mc->next;
-	}
-
-	mc->next = mem_zalloc(sizeof(msgcolor_t));
-	mc->next->type = type;
-	mc->next->color = color;
+	if (type < MSG_MAX)
+		messages->colors[type] = color;
 }
 
 /**
@@ -251,19 +268,10 @@ void message_color_define(u16b type, byte color)
  */
 byte message_type_color(u16b type)
 {
-	msgcolor_t *mc;
 	byte color = COLOUR_WHITE;
 
-	if (messages)
-	{
-		mc = messages->colors;
-
-		while (mc && mc->type != type)
-			mc = mc->next;
-
-		if (mc && (mc->color != COLOUR_DARK))
-			color = mc->color;
-	}
+	if (messages && type < MSG_MAX && messages->colors[type] != COLOUR_DARK)
+		color = messages->colors[type];
 
 	return color;
 }
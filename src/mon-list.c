@@ -18,6 +18,7 @@
  */
 
 #include "game-world.h"
+#include "init.h"
 #include "mon-desc.h"
 #include "mon-list.h"
 #include "project.h"
@@ -43,6 +44,10 @@ monster_list_t *monster_list_new(void)
 
 	list->entries_size = size;
 
+	/* Map from race index to (entry index + 1), so collection can find the
+	 * entry for a race without searching the list */
+	list->race_entry = mem_zalloc((z_info->r_max + 1) * sizeof(u16b));
+
 	return list;
 }
 
@@ -59,6 +64,7 @@ void monster_list_free(monster_list_t *list)
 		list->entries = NULL;
 	}
 
+	mem_free(list->race_entry);
 	mem_free(list);
 	list = NULL;
 }
@@ -114,16 +120,22 @@ static bool monster_list_can_update(const monster_list_t *list)
  */
 void monster_list_reset(monster_list_t *list)
 {
+	int i;
+
 	if (list == NULL || list->entries == NULL)
 		return;
 
+	/* Only the races used by the last collection need forgetting */
+	for (i = 0; i < list->distinct_entries; i++)
+		list->race_entry[list->entries[i].race->ridx] = 0;
+
 	if ((int)list->entries_size < cave_monster_max(cave)) {
 		list->entries = mem_realloc(list->entries, sizeof(list->entries[0])
 									* cave_monster_max(cave));
 		list->entries_size = cave_monster_max(cave);
 	}
 
-	memset(list->entries, 0, list->entries_size * sizeof(monster_list_entry_t));
+	memset(list->entries, 0, list->distinct_entries * sizeof(monster_list_entry_t));
 	memset(list->total_entries, 0, MONSTER_LIST_SECTION_MAX * sizeof(u16b));
 	memset(list->total_monsters, 0, MONSTER_LIST_SECTION_MAX * sizeof(u16b));
 	list->distinct_entries = 0;
@@ -132,7 +144,8 @@ void monster_list_reset(monster_list_t *list)
 }
 
 /**
- * Collect monster information from the current cave's monster list.
+ * Collect monster information from the current cave's monster list. The list
+ * must have been reset (or be newly allocated) since it was last collected.
  */
 void monster_list_collect(monster_list_t *list)
 {
@@ -156,25 +169,19 @@ void monster_list_collect(monster_list_t *list)
 			mflag_has(mon->mflag, MFLAG_UNAWARE))
 			continue;
 
-		/* Find or add a list entry. */
-		for (j = 0; j < (int)list->entries_size; j++) {
-			if (list->entries[j].race == NULL) {
-				/* We found an empty slot, so add this race here. */
-				entry = &list->entries[j];
-				memset(entry, 0, sizeof(monster_list_entry_t));
-				entry->race = mon->race;
-				break;
-			}
-			else if (list->entries[j].race == mon->race) {
-				/* We found a matching race and we'll use that. */
-				entry = &list->entries[j];
-				break;
-			}
+		/* Find or add the list entry for this race. */
+		j = list->race_entry[mon->race->ridx];
+		if (j) {
+			entry = &list->entries[j - 1];
+		} else {
+			if (list->distinct_entries >= list->entries_size)
+				continue;
+			entry = &list->entries[list->distinct_entries++];
+			memset(entry, 0, sizeof(monster_list_entry_t));
+			entry->race = mon->race;
+			list->race_entry[mon->race->ridx] = list->distinct_entries;
 		}
 
-		if (entry == NULL)
-			continue;
-
 		/* Always collect the latest monster attribute so that flicker
 		 * animation works. If this is 0, it needs to be replaced by 
 		 * the standard glyph in the UI */
@@ -201,10 +208,7 @@ void monster_list_collect(monster_list_t *list)
 	}
 
 	/* Collect totals for easier calculations of the list. */
-	for (i = 0; i < (int)list->entries_size; i++) {
-		if (list->entries[i].race == NULL)
-			continue;
-
+	for (i = 0; i < list->distinct_entries; i++) {
 		if (list->entries[i].count[MONSTER_LIST_SECTION_LOS] > 0)
 			list->total_entries[MONSTER_LIST_SECTION_LOS]++;
 
@@ -215,7 +219,6 @@ void monster_list_collect(monster_list_t *list)
 			list->entries[i].count[MONSTER_LIST_SECTION_LOS];
 		list->total_monsters[MONSTER_LIST_SECTION_ESP] +=
 			list->entries[i].count[MONSTER_LIST_SECTION_ESP];
-		list->distinct_entries++;
 	}
 
 	list->creation_turn = turn;
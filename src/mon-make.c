@@ -23,6 +23,7 @@
 #include "mon-desc.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-timed.h"
 #include "mon-util.h"
 #include "obj-make.h"
@@ -39,6 +40,23 @@ s16b num_repro;
 static s16b alloc_race_size;
 static struct alloc_entry *alloc_race_table;
 
+/**
+ * Running totals of the "prob3" field of the monster allocation table, so a
+ * race can be picked by binary search.  The totals only depend on the
+ * current restriction hook, the player's depth and the time of year, so
+ * they are rebuilt only when one of those changes.
+ */
+static long *alloc_race_total;
+static bool alloc_race_total_valid;
+static int alloc_race_total_depth;
+static bool alloc_race_total_seasonal;
+
+/**
+ * Number of picks to try before giving up on rejecting unavailable uniques
+ * and picking from the exact list of available races instead
+ */
+#define MON_NUM_TRIES 10
+
 static void init_race_allocs(void) {
 	int i;
 	struct monster_race *race;
@@ -78,6 +96,8 @@ static void init_race_allocs(void) {
 
 	/* Allocate the alloc_race_table */
 	alloc_race_table = mem_zalloc(alloc_race_size * sizeof(alloc_entry));
+	alloc_race_total = mem_zalloc(alloc_race_size * sizeof(long));
+	alloc_race_total_valid = false;
 
 	/* Get the table entry */
 	table = alloc_race_table;
@@ -119,6 +139,7 @@ static void init_race_allocs(void) {
 }
 
 static void cleanup_race_allocs(void) {
+	mem_free(alloc_race_total);
 	mem_free(alloc_race_table);
 }
 
@@ -278,6 +299,10 @@ void compact_monsters(int num_to_compact)
 	if (num_to_compact)
 		msg("Compacting monsters...");
 
+	/* The schedule and visibility updates refer to monsters by index */
+	monster_schedule_flush(cave);
+	update_monsters_later();
+
 
 	/* Compact at least 'num_to_compact' objects */
 	for (num_compacted = 0, iter = 1; num_compacted < num_to_compact; iter++) {
@@ -469,32 +494,149 @@ void get_mon_num_prep(bool (*get_mon_num_hook)(struct monster_race *race))
 			entry->prob2 = 0;
 	}
 
+	/* The running totals are out of date */
+	alloc_race_total_valid = false;
+
 	return;
 }
 
 /**
- * Helper function for get_mon_num(). Scans the prepared monster allocation
- * table and picks a random monster. Returns the index of a monster in
- * `table`.
+ * Is it the season for seasonal monsters?
  */
-static struct monster_race *get_mon_race_aux(long total,
-											 const alloc_entry *table)
+static bool mon_num_is_season(void)
+{
+	time_t cur_time = time(NULL);
+	struct tm *date = localtime(&cur_time);
+
+	return date->tm_mon == 11 && date->tm_mday >= 24 && date->tm_mday <= 26;
+}
+
+/**
+ * Helper function for get_mon_num(). Fills in the "prob3" field of the
+ * monster allocation table from the "prob2" field and the restrictions
+ * which do not depend on the level being generated, and keeps running
+ * totals of it.
+ */
+static void get_mon_num_totals(bool seasonal)
 {
 	int i;
+	long total = 0L;
+
+	for (i = 0; i < alloc_race_size; i++) {
+		alloc_entry *entry = &alloc_race_table[i];
+		struct monster_race *race = &r_info[entry->index];
+
+		/* Default */
+		entry->prob3 = entry->prob2;
+
+		/* No seasonal monsters outside of Christmas */
+		if (rf_has(race->flags, RF_SEASONAL) && !seasonal)
+			entry->prob3 = 0;
+
+		/* Some monsters never appear out of depth */
+		if (rf_has(race->flags, RF_FORCE_DEPTH) && race->level > player->depth)
+			entry->prob3 = 0;
+
+		total += entry->prob3;
+		alloc_race_total[i] = total;
+	}
+
+	alloc_race_total_valid = true;
+	alloc_race_total_depth = player->depth;
+	alloc_race_total_seasonal = seasonal;
+}
+
+/**
+ * Helper function for get_mon_num(). Returns the index of the first entry in
+ * the (level-sorted) monster allocation table deeper than `level`.
+ */
+static int get_mon_num_end(int level)
+{
+	int lo = 0, hi = alloc_race_size;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (alloc_race_table[mid].level > level)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return lo;
+}
+
+/**
+ * Is this race allowed to be generated now?  Only one copy of a unique must
+ * be around at the same time.
+ */
+static bool mon_num_available(const struct monster_race *race)
+{
+	return !rf_has(race->flags, RF_UNIQUE) || race->cur_num < race->max_num;
+}
+
+/**
+ * Helper function for get_mon_num(). Picks a random monster from entries
+ * `start` to `end` - 1 of the prepared monster allocation table.
+ *
+ * Races are picked by binary search on the running totals; unavailable
+ * uniques are not part of those, so a pick of one is rejected and tried
+ * again, which leaves the remaining races with the same relative chances.
+ * If that keeps failing, fall back to a scan of the available races.
+ */
+static struct monster_race *get_mon_race_aux(int start, int end)
+{
+	int i, tries;
+	long base = start ? alloc_race_total[start - 1] : 0L;
+	long total = end ? alloc_race_total[end - 1] - base : 0L;
+	long value;
+
+	/* No possible monsters */
+	if (total <= 0) return NULL;
+
+	for (tries = 0; tries < MON_NUM_TRIES; tries++) {
+		int lo = start, hi = end - 1;
+		struct monster_race *race;
+
+		/* Pick a monster */
+		value = base + randint0(total);
+
+		/* Find the first entry whose running total exceeds the value */
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (alloc_race_total[mid] > value)
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+
+		race = &r_info[alloc_race_table[lo].index];
+		if (mon_num_available(race)) return race;
+	}
+
+	/* Total up the available monsters */
+	total = 0L;
+	for (i = start; i < end; i++)
+		if (mon_num_available(&r_info[alloc_race_table[i].index]))
+			total += alloc_race_table[i].prob3;
+
+	/* No legal monsters */
+	if (total <= 0) return NULL;
 
 	/* Pick a monster */
-	long value = randint0(total);
+	value = randint0(total);
 
 	/* Find the monster */
-	for (i = 0; i < alloc_race_size; i++) {
+	for (i = start; i < end; i++) {
+		if (!mon_num_available(&r_info[alloc_race_table[i].index])) continue;
+
 		/* Found the entry */
-		if (value < table[i].prob3) break;
+		if (value < alloc_race_table[i].prob3) break;
 
 		/* Decrement */
-		value -= table[i].prob3;
+		value -= alloc_race_table[i].prob3;
 	}
-	
-	return &r_info[table[i].index];
+
+	return &r_info[alloc_race_table[i].index];
 }
 
 /**
@@ -521,63 +663,31 @@ static struct monster_race *get_mon_race_aux(long total,
  */
 struct monster_race *get_mon_num(int level)
 {
-	int i, p;
-
-	long total;
+	int p, start, end;
+	bool seasonal = mon_num_is_season();
 
 	struct monster_race *race;
 
-	alloc_entry *table = alloc_race_table;
-
 	/* Occasionally produce a nastier monster in the dungeon */
 	if (level > 0 && one_in_(z_info->ood_monster_chance))
 		level += MIN(level / 4 + 2, z_info->ood_monster_amount);
 
-	total = 0L;
-
 	/* Process probabilities */
-	for (i = 0; i < alloc_race_size; i++) {
-		time_t cur_time = time(NULL);
-		struct tm *date = localtime(&cur_time);
-
-		/* Monsters are sorted by depth */
-		if (table[i].level > level) break;
-
-		/* Default */
-		table[i].prob3 = 0;
-
-		/* No town monsters in dungeon */
-		if ((level > 0) && (table[i].level <= 0)) continue;
-
-		/* Get the chosen monster */
-		race = &r_info[table[i].index];
-
-		/* No seasonal monsters outside of Christmas */
-		if (rf_has(race->flags, RF_SEASONAL) && 
-			!(date->tm_mon == 11 && date->tm_mday >= 24 && date->tm_mday <= 26))
-			continue;
-
-		/* Only one copy of a a unique must be around at the same time */
-		if (rf_has(race->flags, RF_UNIQUE) && 
-				race->cur_num >= race->max_num)
-			continue;
+	if (!alloc_race_total_valid || alloc_race_total_depth != player->depth ||
+		alloc_race_total_seasonal != seasonal)
+		get_mon_num_totals(seasonal);
 
-		/* Some monsters never appear out of depth */
-		if (rf_has(race->flags, RF_FORCE_DEPTH) && race->level > player->depth)
-			continue;
+	/* Monsters are sorted by depth, so allowed monsters are consecutive */
+	end = get_mon_num_end(level);
 
-		/* Accept */
-		table[i].prob3 = table[i].prob2;
+	/* No town monsters in dungeon */
+	start = (level > 0) ? get_mon_num_end(0) : 0;
 
-		/* Total */
-		total += table[i].prob3;
-	}
+	/* Pick a monster */
+	race = get_mon_race_aux(start, end);
 
 	/* No legal monsters */
-	if (total <= 0) return NULL;
-
-	/* Pick a monster */
-	race = get_mon_race_aux(total, table);
+	if (!race) return NULL;
 
 	/* Try for a "harder" monster once (50%) or twice (10%) */
 	p = randint0(100);
@@ -586,7 +696,7 @@ struct monster_race *get_mon_num(int level)
 		struct monster_race *old = race;
 
 		/* Pick a new monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(start, end);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -597,7 +707,7 @@ struct monster_race *get_mon_num(int level)
 		struct monster_race *old = race;
 
 		/* Pick a monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(start, end);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -689,7 +799,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 			continue;
 
 		/* Allocate by hand, prep, apply magic */
-		obj = mem_zalloc(sizeof(*obj));
+		obj = object_new();
 		if (drop->artifact) {
 			object_prep(obj, lookup_kind(drop->artifact->tval,
 				drop->artifact->sval), level, RANDOMISE);
@@ -712,8 +822,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 			any = true;
 		} else {
 			obj->artifact->created = false;
-			object_wipe(obj);
-			mem_free(obj);
+			object_delete(&obj);
 		}
 	}
 
@@ -736,8 +845,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 			any = true;
 		} else {
 			obj->artifact->created = false;
-			object_wipe(obj);
-			mem_free(obj);
+			object_delete(&obj);
 		}
 	}
 
@@ -786,6 +894,9 @@ s16b place_monster(struct chunk *c, int y, int x, struct monster *mon,
 	new_mon->fx = x;
 	assert(square_monster(c, y, x) == new_mon);
 
+	/* Queue it to move */
+	monster_set_energy(c, new_mon, new_mon->energy);
+
 	update_mon(new_mon, c, true);
 
 	/* Hack -- Count the number of "reproducers" */
@@ -841,6 +952,9 @@ s16b place_monster(struct chunk *c, int y, int x, struct monster *mon,
 				object_delete(&obj);
 			}
 		}
+
+		/* Visibility depends on the mimicry */
+		update_mon_later(m_idx);
 	}
 
 	/* Result */
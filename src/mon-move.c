@@ -31,6 +31,7 @@
 #include "mon-desc.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-spell.h"
 #include "mon-util.h"
 #include "obj-desc.h"
@@ -245,8 +246,8 @@ static bool near_permwall(const struct monster *mon, struct chunk *c)
  * through obstacles.
  *
  * Monsters first try to use up-to-date distance information ('sound') as
- * saved in cave->squares[y][x].cost.  Failing that, they'll try using scent
- * ('when') which is just old cost information.
+ * saved in the cost of the chunk's noise flow.  Failing that, they'll try
+ * using scent ('when') which is just old cost information.
  *
  * Tracking by 'scent' means that monsters end up near enough the player to
  * switch to 'sound' (cost), or they end up somewhere the player left via 
@@ -259,7 +260,7 @@ static bool get_moves_flow(struct chunk *c, struct monster *mon)
 {
 	int i;
 
-	int best_when = 0;
+	u32b best_when = 0;
 	int best_cost = 999;
 	int best_direction = 0;
 	bool found_direction = false;
@@ -274,13 +275,13 @@ static bool get_moves_flow(struct chunk *c, struct monster *mon)
 		return (false);
 
 	/* The player is not currently near the monster grid */
-	if (c->squares[my][mx].when < c->squares[py][px].when)
+	if (cave_scent_when(c, my, mx) < cave_scent_when(c, py, px))
 		/* If the player has never been near this grid, abort */
-		if (c->squares[my][mx].when == 0) return false;
+		if (cave_scent_when(c, my, mx) == 0) return false;
 
 	/* Monster is too far away to notice the player */
-	if (c->squares[my][mx].cost > z_info->max_flow_depth) return false;
-	if (c->squares[my][mx].cost > mon->race->aaf) return false;
+	if (cave_scent_cost(c, my, mx) > z_info->max_flow_depth) return false;
+	if (cave_scent_cost(c, my, mx) > mon->race->aaf) return false;
 
 	/* If the player can see monster, set target and run towards them */
 	if (square_isview(c, my, mx)) {
@@ -300,17 +301,17 @@ static bool get_moves_flow(struct chunk *c, struct monster *mon)
 		if (!square_in_bounds(c, y, x)) continue;
 
 		/* Ignore unvisited/unpassable locations */
-		if (c->squares[y][x].when == 0) continue;
+		if (cave_scent_when(c, y, x) == 0) continue;
 
 		/* Ignore locations whose data is more stale */
-		if (c->squares[y][x].when < best_when) continue;
+		if (cave_scent_when(c, y, x) < best_when) continue;
 
 		/* Ignore locations which are farther away */
-		if (c->squares[y][x].cost > best_cost) continue;
+		if (cave_scent_cost(c, y, x) > best_cost) continue;
 
 		/* Save the cost and time */
-		best_when = c->squares[y][x].when;
-		best_cost = c->squares[y][x].cost;
+		best_when = cave_scent_when(c, y, x);
+		best_cost = cave_scent_cost(c, y, x);
 		best_direction = i;
 		found_direction = true;
 	}
@@ -347,18 +348,18 @@ static bool get_moves_fear(struct chunk *c, struct monster *mon)
 {
 	int i;
 	int gy = 0, gx = 0;
-	int best_when = 0, best_score = -1;
+	u32b best_when = 0;
+	int best_score = -1;
 
-	int py = player->py, px = player->px;
 	int my = mon->fy, mx = mon->fx;
 
 	/* If the player is not currently near the monster, no reason to flow */
-	if (c->squares[my][mx].when < c->squares[py][px].when)
+	if (flow_dist(c->noise, my, mx) < 0)
 		return false;
 
 	/* Monster is too far away to use flow information */
-	if (c->squares[my][mx].cost > z_info->max_flow_depth) return false;
-	if (c->squares[my][mx].cost > mon->race->aaf) return false;
+	if (cave_scent_cost(c, my, mx) > z_info->max_flow_depth) return false;
+	if (cave_scent_cost(c, my, mx) > mon->race->aaf) return false;
 
 	/* Check nearby grids, diagonals first */
 	for (i = 7; i >= 0; i--) {
@@ -372,7 +373,8 @@ static bool get_moves_fear(struct chunk *c, struct monster *mon)
 		if (!square_in_bounds(c, y, x)) continue;
 
 		/* Ignore illegal & older locations */
-		if (c->squares[y][x].when == 0 || c->squares[y][x].when < best_when)
+		if (cave_scent_when(c, y, x) == 0 ||
+			cave_scent_when(c, y, x) < best_when)
 			continue;
 
 		/* Calculate distance of this grid from our target */
@@ -382,7 +384,7 @@ static bool get_moves_fear(struct chunk *c, struct monster *mon)
 		 * First half of calculation is inversely proportional to distance
 		 * Second half is inversely proportional to grid's distance from player
 		 */
-		score = 5000 / (dis + 3) - 500 / (c->squares[y][x].cost + 1);
+		score = 5000 / (dis + 3) - 500 / (cave_scent_cost(c, y, x) + 1);
 
 		/* No negative scores */
 		if (score < 0) score = 0;
@@ -391,7 +393,7 @@ static bool get_moves_fear(struct chunk *c, struct monster *mon)
 		if (score < best_score) continue;
 
 		/* Save the score and time */
-		best_when = c->squares[y][x].when;
+		best_when = cave_scent_when(c, y, x);
 		best_score = score;
 
 		/* Save the location */
@@ -412,136 +414,11 @@ static bool get_moves_fear(struct chunk *c, struct monster *mon)
 
 
 
-/*
- * Hack -- Precompute a bunch of calls to distance() in find_safety() and
- * find_hiding().
- *
- * The pair of arrays dist_offsets_y[n] and dist_offsets_x[n] contain the
- * offsets of all the locations with a distance of n from a central point,
- * with an offset of (0,0) indicating no more offsets at this distance.
- *
- * This is, of course, fairly unreadable, but it eliminates multiple loops
- * from the previous version.
- *
- * It is probably better to replace these arrays with code to compute
- * the relevant arrays, even if the storage is pre-allocated in hard
- * coded sizes.  At the very least, code should be included which is
- * able to generate and dump these arrays (ala "los()").  XXX XXX XXX
- *
- * Also, the storage needs could be reduced by using char.  XXX XXX XXX
+/**
+ * Grids a fleeing or hiding monster looks at must be fewer than this many
+ * steps away
  */
-
-
-static const int d_off_y_0[] =
-{ 0 };
-
-static const int d_off_x_0[] =
-{ 0 };
-
-
-static const int d_off_y_1[] =
-{ -1, -1, -1, 0, 0, 1, 1, 1, 0 };
-
-static const int d_off_x_1[] =
-{ -1, 0, 1, -1, 1, -1, 0, 1, 0 };
-
-
-static const int d_off_y_2[] =
-{ -1, -1, -2, -2, -2, 0, 0, 1, 1, 2, 2, 2, 0 };
-
-static const int d_off_x_2[] =
-{ -2, 2, -1, 0, 1, -2, 2, -2, 2, -1, 0, 1, 0 };
-
-
-static const int d_off_y_3[] =
-{ -1, -1, -2, -2, -3, -3, -3, 0, 0, 1, 1, 2, 2,
-  3, 3, 3, 0 };
-
-static const int d_off_x_3[] =
-{ -3, 3, -2, 2, -1, 0, 1, -3, 3, -3, 3, -2, 2,
-  -1, 0, 1, 0 };
-
-
-static const int d_off_y_4[] =
-{ -1, -1, -2, -2, -3, -3, -3, -3, -4, -4, -4, 0,
-  0, 1, 1, 2, 2, 3, 3, 3, 3, 4, 4, 4, 0 };
-
-static const int d_off_x_4[] =
-{ -4, 4, -3, 3, -2, -3, 2, 3, -1, 0, 1, -4, 4,
-  -4, 4, -3, 3, -2, -3, 2, 3, -1, 0, 1, 0 };
-
-
-static const int d_off_y_5[] =
-{ -1, -1, -2, -2, -3, -3, -4, -4, -4, -4, -5, -5,
-  -5, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 4, 4, 5, 5,
-  5, 0 };
-
-static const int d_off_x_5[] =
-{ -5, 5, -4, 4, -4, 4, -2, -3, 2, 3, -1, 0, 1,
-  -5, 5, -5, 5, -4, 4, -4, 4, -2, -3, 2, 3, -1,
-  0, 1, 0 };
-
-
-static const int d_off_y_6[] =
-{ -1, -1, -2, -2, -3, -3, -4, -4, -5, -5, -5, -5,
-  -6, -6, -6, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5,
-  5, 5, 6, 6, 6, 0 };
-
-static const int d_off_x_6[] =
-{ -6, 6, -5, 5, -5, 5, -4, 4, -2, -3, 2, 3, -1,
-  0, 1, -6, 6, -6, 6, -5, 5, -5, 5, -4, 4, -2,
-  -3, 2, 3, -1, 0, 1, 0 };
-
-
-static const int d_off_y_7[] =
-{ -1, -1, -2, -2, -3, -3, -4, -4, -5, -5, -5, -5,
-  -6, -6, -6, -6, -7, -7, -7, 0, 0, 1, 1, 2, 2, 3,
-  3, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 0 };
-
-static const int d_off_x_7[] =
-{ -7, 7, -6, 6, -6, 6, -5, 5, -4, -5, 4, 5, -2,
-  -3, 2, 3, -1, 0, 1, -7, 7, -7, 7, -6, 6, -6,
-  6, -5, 5, -4, -5, 4, 5, -2, -3, 2, 3, -1, 0,
-  1, 0 };
-
-
-static const int d_off_y_8[] =
-{ -1, -1, -2, -2, -3, -3, -4, -4, -5, -5, -6, -6,
-  -6, -6, -7, -7, -7, -7, -8, -8, -8, 0, 0, 1, 1,
-  2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7,
-  8, 8, 8, 0 };
-
-static const int d_off_x_8[] =
-{ -8, 8, -7, 7, -7, 7, -6, 6, -6, 6, -4, -5, 4,
-  5, -2, -3, 2, 3, -1, 0, 1, -8, 8, -8, 8, -7,
-  7, -7, 7, -6, 6, -6, 6, -4, -5, 4, 5, -2, -3,
-  2, 3, -1, 0, 1, 0 };
-
-
-static const int d_off_y_9[] =
-{ -1, -1, -2, -2, -3, -3, -4, -4, -5, -5, -6, -6,
-  -7, -7, -7, -7, -8, -8, -8, -8, -9, -9, -9, 0,
-  0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 7,
-  7, 8, 8, 8, 8, 9, 9, 9, 0 };
-
-static const int d_off_x_9[] =
-{ -9, 9, -8, 8, -8, 8, -7, 7, -7, 7, -6, 6, -4,
-  -5, 4, 5, -2, -3, 2, 3, -1, 0, 1, -9, 9, -9,
-  9, -8, 8, -8, 8, -7, 7, -7, 7, -6, 6, -4, -5,
-  4, 5, -2, -3, 2, 3, -1, 0, 1, 0 };
-
-
-static const int *dist_offsets_y[10] =
-{
-	d_off_y_0, d_off_y_1, d_off_y_2, d_off_y_3, d_off_y_4,
-	d_off_y_5, d_off_y_6, d_off_y_7, d_off_y_8, d_off_y_9
-};
-
-static const int *dist_offsets_x[10] =
-{
-	d_off_x_0, d_off_x_1, d_off_x_2, d_off_x_3, d_off_x_4,
-	d_off_x_5, d_off_x_6, d_off_x_7, d_off_x_8, d_off_x_9
-};
+#define FLEE_DEPTH 10
 
 
 /**
@@ -564,61 +441,56 @@ static bool find_safety(struct chunk *c, struct monster *mon)
 	int py = player->py;
 	int px = player->px;
 
-	int i, y, x, dy, dx, d, dis;
+	int i, n, y, x, d, dis;
 	int gy = 0, gx = 0, gdis = 0;
 
-	const int *y_offsets;
-	const int *x_offsets;
+	struct flow *near = cave_near_flow(c, fy, fx, FLEE_DEPTH);
+	const struct loc *grids = flow_grids(near, &n);
 
-	/* Start with adjacent locations, spread further */
-	for (d = 1; d < 10; d++) {
-		/* Get the lists of points with a distance d from (fx, fy) */
-		y_offsets = dist_offsets_y[d];
-		x_offsets = dist_offsets_x[d];
+	/* Start with adjacent locations, spread further (skipping the monster) */
+	for (i = 1; i < n; i++) {
+		y = grids[i].y;
+		x = grids[i].x;
+		d = flow_dist(near, y, x);
 
-		/* Check the locations */
-		for (i = 0, dx = x_offsets[0], dy = y_offsets[0];
-		     dx != 0 || dy != 0;
-		     i++, dx = x_offsets[i], dy = y_offsets[i]) {
-			y = fy + dy;
-			x = fx + dx;
+		/* Stop after the nearest steps with a safe location */
+		if (gdis > 0 && d > flow_dist(near, gy, gx)) break;
 
-			/* Skip illegal locations */
-			if (!square_in_bounds_fully(cave, y, x)) continue;
+		/* Skip illegal locations */
+		if (!square_in_bounds_fully(c, y, x)) continue;
 
-			/* Skip locations in a wall */
-			if (!square_ispassable(cave, y, x)) continue;
+		/* Skip locations in a wall */
+		if (!square_ispassable(c, y, x)) continue;
 
-			/* Ignore grids very far from the player */
-			if (c->squares[y][x].when < c->squares[py][px].when) continue;
+		/* Ignore grids very far from the player */
+		if (flow_dist(c->noise, y, x) < 0) continue;
 
-			/* Ignore too-distant grids */
-			if (c->squares[y][x].cost > c->squares[fy][fx].cost + 2 * d)
-				continue;
+		/* Ignore too-distant grids */
+		if (cave_scent_cost(c, y, x) > cave_scent_cost(c, fy, fx) + 2 * d)
+			continue;
+
+		/* Check for absence of shot (more or less) */
+		if (!square_isview(c, y, x)) {
+			/* Calculate distance from player */
+			dis = distance(y, x, py, px);
 
-			/* Check for absence of shot (more or less) */
-			if (!square_isview(c, y, x)) {
-				/* Calculate distance from player */
-				dis = distance(y, x, py, px);
-
-				/* Remember if further than previous */
-				if (dis > gdis) {
-					gy = y;
-					gx = x;
-					gdis = dis;
-				}
+			/* Remember if further than previous */
+			if (dis > gdis) {
+				gy = y;
+				gx = x;
+				gdis = dis;
 			}
 		}
+	}
 
-		/* Check for success */
-		if (gdis > 0) {
-			/* Good location */
-			mon->ty = gy;
-			mon->tx = gx;
+	/* Check for success */
+	if (gdis > 0) {
+		/* Good location */
+		mon->ty = gy;
+		mon->tx = gx;
 
-			/* Found safe place */
-			return (true);
-		}
+		/* Found safe place */
+		return (true);
 	}
 
 	/* No safe place */
@@ -644,57 +516,53 @@ static bool find_hiding(struct monster *mon)
 	int py = player->py;
 	int px = player->px;
 
-	int i, y, x, dy, dx, d, dis;
+	int i, n, y, x, dis;
 	int gy = 0, gx = 0, gdis = 999, min;
 
-	const int *y_offsets, *x_offsets;
+	struct flow *near = cave_near_flow(cave, fy, fx, FLEE_DEPTH);
+	const struct loc *grids = flow_grids(near, &n);
 
 	/* Closest distance to get */
 	min = distance(py, px, fy, fx) * 3 / 4 + 2;
 
-	/* Start with adjacent locations, spread further */
-	for (d = 1; d < 10; d++) {
-		/* Get the lists of points with a distance d from (fx, fy) */
-		y_offsets = dist_offsets_y[d];
-		x_offsets = dist_offsets_x[d];
-
-		/* Check the locations */
-		for (i = 0, dx = x_offsets[0], dy = y_offsets[0];
-		     dx != 0 || dy != 0;
-		     i++, dx = x_offsets[i], dy = y_offsets[i]) {
-			y = fy + dy;
-			x = fx + dx;
-
-			/* Skip illegal locations */
-			if (!square_in_bounds_fully(cave, y, x)) continue;
-
-			/* Skip occupied locations */
-			if (!square_isempty(cave, y, x)) continue;
-
-			/* Check for hidden, available grid */
-			if (!square_isview(cave, y, x) &&
-				projectable(cave, fy, fx, y, x, PROJECT_STOP)) {
-				/* Calculate distance from player */
-				dis = distance(y, x, py, px);
-
-				/* Remember if closer than previous */
-				if (dis < gdis && dis >= min) {
-					gy = y;
-					gx = x;
-					gdis = dis;
-				}
+	/* Start with adjacent locations, spread further (skipping the monster) */
+	for (i = 1; i < n; i++) {
+		y = grids[i].y;
+		x = grids[i].x;
+
+		/* Stop after the nearest steps with a good location */
+		if (gdis < 999 && flow_dist(near, y, x) > flow_dist(near, gy, gx))
+			break;
+
+		/* Skip illegal locations */
+		if (!square_in_bounds_fully(cave, y, x)) continue;
+
+		/* Skip occupied locations */
+		if (!square_isempty(cave, y, x)) continue;
+
+		/* Check for hidden, available grid */
+		if (!square_isview(cave, y, x) &&
+			projectable(cave, fy, fx, y, x, PROJECT_STOP)) {
+			/* Calculate distance from player */
+			dis = distance(y, x, py, px);
+
+			/* Remember if closer than previous */
+			if (dis < gdis && dis >= min) {
+				gy = y;
+				gx = x;
+				gdis = dis;
 			}
 		}
+	}
 
-		/* Check for success */
-		if (gdis < 999) {
-			/* Good location */
-			mon->ty = gy;
-			mon->tx = gx;
+	/* Check for success */
+	if (gdis < 999) {
+		/* Good location */
+		mon->ty = gy;
+		mon->tx = gx;
 
-			/* Found good place */
-			return (true);
-		}
+		/* Found good place */
+		return (true);
 	}
 
 	/* No good place */
@@ -898,13 +766,13 @@ static bool monster_can_flow(struct chunk *c, struct monster *mon)
 {
 	int fy = mon->fy;
 	int fx = mon->fx;
+	int d;
 
 	assert(c);
 
-	/* Check the flow (normal aaf is about 20) */
-	if ((c->squares[fy][fx].when == c->squares[player->py][player->px].when) &&
-	    (c->squares[fy][fx].cost < z_info->max_flow_depth) &&
-	    (c->squares[fy][fx].cost < mon->race->aaf))
+	/* Check the noise flow (normal aaf is about 20) */
+	d = flow_dist(c->noise, fy, fx);
+	if (d >= 0 && d < mon->race->aaf)
 		return true;
 	return false;
 }
@@ -1556,11 +1424,373 @@ static void regen_monster(struct monster *mon)
 
 
 /**
- * Process all the "live" monsters, once per game turn.
+ * ------------------------------------------------------------------------
+ * Monster scheduling
  *
- * During each game turn, we scan through the list of all the "live" monsters,
- * (backwards, so we can excise any "freshly dead" monsters), energizing each
- * monster, and allowing fully energized monsters to move, attack, pass, etc.
+ * Rather than sweeping the whole monster list every game turn, each monster
+ * is queued by the game turn on which it will next have enough energy to
+ * move.  Its energy is only brought up to date when it is taken off the
+ * queue, so a monster which is waiting for energy costs nothing at all.
+ *
+ * A monster's energy is stored as the value it had at the start of game
+ * turn mon->energy_turn, together with the energy it gains per game turn.
+ * Because a monster never gains more than move_energy in one game turn, the
+ * energy after any number of turns follows directly from those two values.
+ * ------------------------------------------------------------------------ */
+
+/**
+ * A monster waiting on the queue, and the game turn it will next move on
+ */
+struct monster_wait {
+	s32b turn;
+	int midx;
+};
+
+/**
+ * A monster which is due to move this game turn
+ */
+struct monster_due {
+	int midx;
+	int energy;
+};
+
+/**
+ * The schedule for one chunk
+ */
+struct monster_schedule {
+	struct monster_wait *queue;	/* Binary heap, earliest turn first */
+	int queue_count;
+	int queue_size;
+
+	struct monster_due *due;	/* Monsters moving on turn due_turn */
+	int due_count;
+	int due_size;
+	int due_next;				/* First due monster not yet passed over */
+	bool due_sorted;			/* Due monsters are in order of energy */
+	s32b due_turn;
+};
+
+/**
+ * Energy a monster gains each game turn at its current speed
+ */
+static int monster_turn_energy(const struct monster *mon)
+{
+	int mspeed = mon->mspeed;
+
+	if (mon->m_timed[MON_TMD_FAST])
+		mspeed += 10;
+	if (mon->m_timed[MON_TMD_SLOW])
+		mspeed -= 10;
+
+	return turn_energy(mspeed);
+}
+
+/**
+ * Energy a monster has at the start of game turn `when`
+ *
+ * Over k turns the monster gains k * gain and spends move_energy once for
+ * each of the first k - 1 turns on which its accumulated energy reached
+ * another multiple of move_energy.
+ */
+static int monster_energy_at(const struct monster *mon, s32b when)
+{
+	s32b k = when - mon->energy_turn;
+	int gain = mon->energy_gain;
+
+	if (k <= 0)
+		return mon->energy;
+
+	return mon->energy + k * gain
+		- z_info->move_energy * ((mon->energy + (k - 1) * gain)
+								 / z_info->move_energy);
+}
+
+/**
+ * The game turn on which a monster will next move, or -1 for never
+ */
+static s32b monster_next_turn(const struct monster *mon)
+{
+	int need = z_info->move_energy - mon->energy;
+
+	if (need <= 0)
+		return mon->energy_turn;
+	if (!mon->energy_gain)
+		return -1;
+
+	return mon->energy_turn + (need + mon->energy_gain - 1) / mon->energy_gain;
+}
+
+/**
+ * Add a monster to the list of those moving this game turn
+ */
+static void schedule_due(struct monster_schedule *s, const struct monster *mon)
+{
+	if (s->due_count == s->due_size) {
+		s->due_size = s->due_size ? s->due_size * 2 : 32;
+		s->due = mem_realloc(s->due, s->due_size * sizeof(*s->due));
+	}
+
+	s->due[s->due_count].midx = mon->midx;
+	s->due[s->due_count].energy = monster_energy_at(mon, s->due_turn);
+	s->due_count++;
+	s->due_sorted = false;
+}
+
+/**
+ * Queue a monster for the next game turn it will move on
+ */
+static void schedule_push(struct monster_schedule *s, struct monster *mon)
+{
+	struct monster_wait wait;
+	int i;
+
+	mon->sched_turn = monster_next_turn(mon);
+	if (mon->sched_turn < 0)
+		return;
+
+	/* Already due */
+	if (mon->sched_turn <= s->due_turn) {
+		mon->sched_turn = s->due_turn;
+		schedule_due(s, mon);
+		return;
+	}
+
+	if (s->queue_count == s->queue_size) {
+		s->queue_size = s->queue_size ? s->queue_size * 2 : 64;
+		s->queue = mem_realloc(s->queue, s->queue_size * sizeof(*s->queue));
+	}
+
+	wait.turn = mon->sched_turn;
+	wait.midx = mon->midx;
+
+	/* Sift up */
+	for (i = s->queue_count++; i > 0; i = (i - 1) / 2) {
+		int parent = (i - 1) / 2;
+		if (s->queue[parent].turn <= wait.turn)
+			break;
+		s->queue[i] = s->queue[parent];
+	}
+	s->queue[i] = wait;
+}
+
+/**
+ * Remove the earliest entry from the queue
+ */
+static struct monster_wait schedule_pop(struct monster_schedule *s)
+{
+	struct monster_wait top = s->queue[0];
+	struct monster_wait last = s->queue[--s->queue_count];
+	int i = 0;
+
+	/* Sift down */
+	while (2 * i + 1 < s->queue_count) {
+		int child = 2 * i + 1;
+		if (child + 1 < s->queue_count &&
+			s->queue[child + 1].turn < s->queue[child].turn)
+			child++;
+		if (last.turn <= s->queue[child].turn)
+			break;
+		s->queue[i] = s->queue[child];
+		i = child;
+	}
+	s->queue[i] = last;
+
+	return top;
+}
+
+/**
+ * Build the schedule for a chunk from its monsters' current energy
+ *
+ * Monsters which have already been handled this game turn are listed as due
+ * so that reset_monsters() will find them.
+ */
+static void schedule_build(struct chunk *c)
+{
+	struct monster_schedule *s = mem_zalloc(sizeof(*s));
+	int i;
+
+	s->due_turn = turn;
+	c->mon_sched = s;
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+
+		mon->energy_gain = monster_turn_energy(mon);
+		if (mflag_has(mon->mflag, MFLAG_HANDLED)) {
+			mon->energy_turn = turn + 1;
+			schedule_due(s, mon);
+		} else {
+			mon->energy_turn = turn;
+		}
+		schedule_push(s, mon);
+	}
+}
+
+/**
+ * Move the schedule on to the current game turn
+ */
+static void schedule_advance(struct chunk *c)
+{
+	struct monster_schedule *s = c->mon_sched;
+	int i, count = 0;
+
+	/* Keep any monsters which should have moved but did not get the chance;
+	 * like a monster passed over by the old sweep, they neither gain nor
+	 * spend energy for the turn they missed */
+	for (i = 0; i < s->due_count; i++) {
+		struct monster *mon = cave_monster(c, s->due[i].midx);
+		if (mon->race && mon->sched_turn == s->due_turn) {
+			mon->energy = monster_energy_at(mon, s->due_turn);
+			mon->energy_turn = turn;
+			mon->sched_turn = turn;
+			s->due[count++] = s->due[i];
+		}
+	}
+	s->due_count = count;
+	s->due_turn = turn;
+	s->due_next = 0;
+	s->due_sorted = false;
+
+	/* Take everything due now off the queue, skipping stale entries */
+	while (s->queue_count && s->queue[0].turn <= turn) {
+		struct monster_wait wait = schedule_pop(s);
+		struct monster *mon = cave_monster(c, wait.midx);
+
+		if (!mon->race || mon->sched_turn != wait.turn) continue;
+		mon->sched_turn = turn;
+		schedule_due(s, mon);
+	}
+}
+
+/**
+ * Order due monsters by energy, most first, then by index, highest first
+ */
+static int cmp_monster_due(const void *a, const void *b)
+{
+	const struct monster_due *da = a;
+	const struct monster_due *db = b;
+
+	if (da->energy != db->energy)
+		return db->energy - da->energy;
+	return db->midx - da->midx;
+}
+
+/**
+ * Get the next monster to move this game turn with at least the given energy
+ */
+static struct monster *schedule_next(struct chunk *c, int minimum_energy)
+{
+	struct monster_schedule *s;
+
+	/* The schedule is dropped if the monster list is compacted */
+	if (!c->mon_sched)
+		schedule_build(c);
+	s = c->mon_sched;
+
+	if (!s->due_sorted) {
+		int i;
+		for (i = 0; i < s->due_count; i++) {
+			struct monster *mon = cave_monster(c, s->due[i].midx);
+			s->due[i].energy = monster_energy_at(mon, turn);
+		}
+		sort(s->due, s->due_count, sizeof(*s->due), cmp_monster_due);
+		s->due_next = 0;
+		s->due_sorted = true;
+	}
+
+	for (; s->due_next < s->due_count; s->due_next++) {
+		struct monster_due *due = &s->due[s->due_next];
+		struct monster *mon = cave_monster(c, due->midx);
+
+		if (!mon->race || mon->sched_turn != turn) continue;
+		if (mflag_has(mon->mflag, MFLAG_HANDLED)) continue;
+
+		/* Everyone after this has less energy */
+		if (due->energy < minimum_energy) break;
+
+		return mon;
+	}
+
+	return NULL;
+}
+
+/**
+ * Bring a chunk's monster energy up to date and drop its schedule
+ *
+ * This must be done before monsters are moved around the monster list, or
+ * their energy is needed for anything other than process_monsters().
+ */
+void monster_schedule_flush(struct chunk *c)
+{
+	struct monster_schedule *s = c->mon_sched;
+	int i;
+
+	if (!s) return;
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+
+		if (mon->energy_turn < turn) {
+			mon->energy = monster_energy_at(mon, turn);
+			mon->energy_turn = turn;
+		}
+	}
+
+	mem_free(s->queue);
+	mem_free(s->due);
+	mem_free(s);
+	c->mon_sched = NULL;
+}
+
+/**
+ * Set a monster's energy as of now
+ */
+void monster_set_energy(struct chunk *c, struct monster *mon, int energy)
+{
+	mon->energy = energy;
+	mon->energy_turn = mflag_has(mon->mflag, MFLAG_HANDLED) ? turn + 1 : turn;
+	mon->energy_gain = monster_turn_energy(mon);
+
+	if (c->mon_sched)
+		schedule_push(c->mon_sched, mon);
+}
+
+/**
+ * A monster's energy as of the current game turn, whether or not its
+ * stored energy has been brought up to date
+ */
+int monster_current_energy(const struct monster *mon)
+{
+	return monster_energy_at(mon, turn);
+}
+
+/**
+ * Requeue a monster after a change to its speed
+ */
+void monster_reschedule(struct chunk *c, struct monster *mon)
+{
+	if (!c->mon_sched) return;
+
+	/* Account for the energy gained at the old speed */
+	if (mon->energy_turn < turn) {
+		mon->energy = monster_energy_at(mon, turn);
+		mon->energy_turn = turn;
+	}
+
+	mon->energy_gain = monster_turn_energy(mon);
+	schedule_push(c->mon_sched, mon);
+}
+
+
+/**
+ * Process the "live" monsters which have enough energy to move this game
+ * turn, and have not moved already.
+ *
+ * Monsters are taken in order of energy, most first, so that those with at
+ * least minimum_energy move before the player.  Monsters without enough
+ * energy to move are left on the schedule until they do.
  *
  * This function and its children are responsible for a considerable fraction
  * of the processor time in normal situations, greater if the character is
@@ -1568,8 +1798,7 @@ static void regen_monster(struct monster *mon)
  */
 void process_monsters(struct chunk *c, int minimum_energy)
 {
-	int i;
-	int mspeed;
+	struct monster *mon;
 
 	/* Only process some things every so often */
 	bool regen = false;
@@ -1578,28 +1807,32 @@ void process_monsters(struct chunk *c, int minimum_energy)
 	if (turn % 100 == 0)
 		regen = true;
 
-	/* Process the monsters (backwards) */
-	for (i = cave_monster_max(c) - 1; i >= 1; i--)
-	{
-		struct monster *mon;
+	if (!c->mon_sched)
+		schedule_build(c);
+	if (c->mon_sched->due_turn != turn)
+		schedule_advance(c);
+
+	/* Monsters which are not moving this turn still regenerate */
+	if (regen && !minimum_energy) {
+		int i;
+		for (i = cave_monster_max(c) - 1; i >= 1; i--) {
+			mon = cave_monster(c, i);
+			if (!mon->race || mon->sched_turn == turn) continue;
+			if (mflag_has(mon->mflag, MFLAG_HANDLED)) continue;
+			regen_monster(mon);
+		}
+	}
+
+	/* Process the monsters */
+	while ((mon = schedule_next(c, minimum_energy))) {
+		int energy = monster_energy_at(mon, turn);
 		bool moving;
 
 		/* Handle "leaving" */
 		if (player->is_dead || player->upkeep->generate_level) break;
 
-		/* Get a 'live' monster */
-		mon = cave_monster(c, i);
-		if (!mon->race) continue;
-
-		/* Ignore monsters that have already been handled */
-		if (mflag_has(mon->mflag, MFLAG_HANDLED))
-			continue;
-
-		/* Not enough energy to move yet */
-		if (mon->energy < minimum_energy) continue;
-
 		/* Does this monster have enough energy to move? */
-		moving = mon->energy >= z_info->move_energy ? true : false;
+		moving = energy >= z_info->move_energy ? true : false;
 
 		/* Prevent reprocessing */
 		mflag_on(mon->mflag, MFLAG_HANDLED);
@@ -1608,23 +1841,23 @@ void process_monsters(struct chunk *c, int minimum_energy)
 		if (regen)
 			regen_monster(mon);
 
-		/* Calculate the net speed */
-		mspeed = mon->mspeed;
-		if (mon->m_timed[MON_TMD_FAST])
-			mspeed += 10;
-		if (mon->m_timed[MON_TMD_SLOW])
-			mspeed -= 10;
-
 		/* Give this monster some energy */
-		mon->energy += turn_energy(mspeed);
+		mon->energy_gain = monster_turn_energy(mon);
+		energy += mon->energy_gain;
+
+		/* Use up "some" energy */
+		if (moving)
+			energy -= z_info->move_energy;
+
+		/* Queue it for its next move */
+		mon->energy = energy;
+		mon->energy_turn = turn + 1;
+		schedule_push(c->mon_sched, mon);
 
 		/* End the turn of monsters without enough energy to move */
 		if (!moving)
 			continue;
 
-		/* Use up "some" energy */
-		mon->energy -= z_info->move_energy;
-
 		/* Mimics lie in wait */
 		if (is_mimicking(mon)) continue;
 
@@ -1635,7 +1868,7 @@ void process_monsters(struct chunk *c, int minimum_energy)
 				continue;
 
 			/* Set this monster to be the current actor */
-			c->mon_current = i;
+			c->mon_current = mon->midx;
 
 			/* Process the monster */
 			process_monster(c, mon);
@@ -1660,6 +1893,16 @@ void reset_monsters(void)
 	int i;
 	struct monster *mon;
 
+	/* Only monsters which moved this turn can have been handled */
+	if (cave->mon_sched) {
+		struct monster_schedule *s = cave->mon_sched;
+		for (i = 0; i < s->due_count; i++) {
+			mon = cave_monster(cave, s->due[i].midx);
+			mflag_off(mon->mflag, MFLAG_HANDLED);
+		}
+		return;
+	}
+
 	/* Process the monsters (backwards) */
 	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
 		/* Access the monster */
@@ -22,5 +22,9 @@
 bool multiply_monster(const struct monster *m);
 void process_monsters(struct chunk *c, int minimum_energy);
 void reset_monsters(void);
+void monster_schedule_flush(struct chunk *c);
+int monster_current_energy(const struct monster *mon);
+void monster_set_energy(struct chunk *c, struct monster *mon, int energy);
+void monster_reschedule(struct chunk *c, struct monster *mon);
 
 #endif /* !MONSTER_MOVE_H */
@@ -18,6 +18,7 @@
 
 #include "angband.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-summon.h"
 #include "mon-util.h"
 
@@ -187,7 +188,7 @@ int call_monster(int y, int x)
 	mon_clear_timed(mon, MON_TMD_SLEEP, MON_TMD_FLG_NOMESSAGE, false);
 
 	/* Set it's energy to 0 */
-	mon->energy = 0;
+	monster_set_energy(cave, mon, 0);
 
 	return (mon->race->level);
 }
@@ -275,7 +276,7 @@ int summon_specific(int y1, int x1, int lev, int type, bool delay, bool call)
 	/* If delay, try to let the player act before the summoned monsters,
 	 * including slowing down faster monsters for one turn */
 	if (delay) {
-		mon->energy = 0;
+		monster_set_energy(cave, mon, 0);
 		if (mon->race->speed > player->state.speed)
 			mon_inc_timed(mon, MON_TMD_SLOW, 1,
 				MON_TMD_FLG_NOMESSAGE, false);
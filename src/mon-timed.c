@@ -20,6 +20,7 @@
 #include "mon-desc.h"
 #include "mon-lore.h"
 #include "mon-msg.h"
+#include "mon-move.h"
 #include "mon-spell.h"
 #include "mon-timed.h"
 #include "mon-util.h"
@@ -207,6 +208,10 @@ static bool mon_set_timed(struct monster *mon, int ef_idx, int timer,
 	else
 		mon->m_timed[ef_idx] = timer;
 
+	/* Speed changes alter when the monster next moves */
+	if (!resisted && (ef_idx == MON_TMD_FAST || ef_idx == MON_TMD_SLOW))
+		monster_reschedule(cave, mon);
+
 	if (player->upkeep->health_who == mon)
 		player->upkeep->redraw |= (PR_HEALTH);
 
@@ -230,9 +230,11 @@ void update_mon(struct monster *mon, struct chunk *c, bool full)
 	/* Detected */
 	if (mflag_has(mon->mflag, MFLAG_MARK)) flag = true;
 
-	/* Check if telepathy works */
+	/* Check if telepathy works; while a level is being generated the player
+	 * may still be at their position on the old one */
 	if (square_isno_esp(c, fy, fx) ||
-		square_isno_esp(c, player->py, player->px))
+		(square_in_bounds(c, player->py, player->px) &&
+		 square_isno_esp(c, player->py, player->px)))
 		telepathy_ok = false;
 
 	/* Nearby */
@@ -404,12 +406,78 @@ void update_mon(struct monster *mon, struct chunk *c, bool full)
 
 
 /**
- * Updates all the (non-dead) monsters via update_mon().
+ * What the player could sense monsters with at the last full update
+ */
+static struct {
+	struct chunk *c;
+	int py, px;
+	bool blind;
+	bool telepathy;
+	bool see_invis;
+	int see_infra;
+} monster_senses;
+
+/**
+ * Monsters whose visibility may have changed since the last update
+ */
+static int changed_midx[256];
+static int changed_n;
+static bool changed_all = true;
+
+/**
+ * Mark a monster for updating by the next update_monsters()
+ */
+void update_mon_later(int m_idx)
+{
+	if (changed_n < (int)N_ELEMENTS(changed_midx))
+		changed_midx[changed_n++] = m_idx;
+	else
+		changed_all = true;
+}
+
+/**
+ * Mark every monster for updating by the next update_monsters()
+ */
+void update_monsters_later(void)
+{
+	changed_all = true;
+}
+
+/**
+ * Updates the (non-dead) monsters via update_mon().
+ *
+ * Each monster updates itself when it moves or is detected, and
+ * update_view() marks the monsters on grids whose view it recalculates,
+ * so unless the distances are wanted or the player's senses have changed
+ * only those marked monsters need updating.
  */
 void update_monsters(bool full)
 {
 	int i;
 
+	bool telepathy = player_of_has(player, OF_TELEPATHY);
+	bool see_invis = player_of_has(player, OF_SEE_INVIS);
+	bool blind = player->timed[TMD_BLIND] ? true : false;
+
+	/* Update only the marked monsters if nothing else has changed */
+	if (!full && !changed_all && (monster_senses.c == cave) &&
+		(monster_senses.py == player->py) &&
+		(monster_senses.px == player->px) &&
+		(monster_senses.blind == blind) &&
+		(monster_senses.telepathy == telepathy) &&
+		(monster_senses.see_invis == see_invis) &&
+		(monster_senses.see_infra == player->state.see_infra)) {
+		for (i = 0; i < changed_n; i++) {
+			struct monster *mon = cave_monster(cave, changed_midx[i]);
+
+			/* Update the monster if alive */
+			if (mon->race)
+				update_mon(mon, cave, false);
+		}
+		changed_n = 0;
+		return;
+	}
+
 	/* Update each (live) monster */
 	for (i = 1; i < cave_monster_max(cave); i++) {
 		struct monster *mon = cave_monster(cave, i);
@@ -418,6 +486,16 @@ void update_monsters(bool full)
 		if (mon->race)
 			update_mon(mon, cave, full);
 	}
+
+	monster_senses.c = cave;
+	monster_senses.py = player->py;
+	monster_senses.px = player->px;
+	monster_senses.blind = blind;
+	monster_senses.telepathy = telepathy;
+	monster_senses.see_invis = see_invis;
+	monster_senses.see_infra = player->state.see_infra;
+	changed_n = 0;
+	changed_all = false;
 }
 
 
@@ -489,8 +567,10 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		if (rf_has(mon->race->flags, RF_HAS_LIGHT))
 			player->upkeep->update |= PU_UPDATE_VIEW;
 
-		/* Redraw monster list */
-		player->upkeep->redraw |= (PR_MONLIST);
+		/* Redraw monster list; update_mon() has already noted any change
+		 * in visibility, so unseen monsters can move without it */
+		if (mflag_has(mon->mflag, MFLAG_VISIBLE))
+			player->upkeep->redraw |= (PR_MONLIST);
 	}
 
 	/* Player 1 */
@@ -531,7 +611,8 @@ void monster_swap(int y1, int x1, int y2, int x2)
 			player->upkeep->update |= PU_UPDATE_VIEW;
 
 		/* Redraw monster list */
-		player->upkeep->redraw |= (PR_MONLIST);
+		if (mflag_has(mon->mflag, MFLAG_VISIBLE))
+			player->upkeep->redraw |= (PR_MONLIST);
 	}
 
 	/* Player 2 */
@@ -605,6 +686,7 @@ void become_aware(struct monster *mon)
 		}
 
 		/* Update monster and item lists */
+		update_mon_later(mon->midx);
 		player->upkeep->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
 		player->upkeep->redraw |= (PR_MONLIST | PR_ITEMLIST);
 	}
@@ -28,6 +28,8 @@ bool monster_is_nonliving(struct monster_race *race);
 bool monster_is_unusual(struct monster_race *race);
 bool match_monster_bases(const struct monster_base *base, ...);
 void update_mon(struct monster *mon, struct chunk *c, bool full);
+void update_mon_later(int m_idx);
+void update_monsters_later(void);
 void update_monsters(bool full);
 bool monster_carry(struct chunk *c, struct monster *mon, struct object *obj);
 void monster_swap(int y1, int x1, int y2, int x2);
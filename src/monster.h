@@ -323,6 +323,9 @@ struct monster {
 
 	byte mspeed;		/* Monster "speed" */
 	byte energy;		/* Monster "energy" */
+	byte energy_gain;	/**< Energy gained per game turn.  Not saved */
+	s32b energy_turn;	/**< Game turn energy is correct for.  Not saved */
+	s32b sched_turn;	/**< Game turn of next move.  Not saved */
 
 	byte cdis;			/* Current dis from player */
 
@@ -284,7 +284,7 @@ static void chest_death(int y, int x, struct object *chest)
 			treasure = make_object(cave, value, false, false, false, NULL, 0);
 			if (!treasure) continue;
 			if (tval_is_chest(treasure)) {
-				mem_free(treasure);
+				object_delete(&treasure);
 				continue;
 			}
 		}
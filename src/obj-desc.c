@@ -25,6 +25,33 @@
 #include "obj-tval.h"
 #include "obj-util.h"
 
+/**
+ * Number of descriptions remembered by object_desc(), and the longest one
+ * that can be remembered
+ */
+#define DESC_CACHE_SIZE 256
+#define DESC_CACHE_LEN  160
+
+/**
+ * A remembered description, and everything it depends on: the object and its
+ * known version, how it was described, and what the player knew at the time
+ */
+struct desc_cache_entry {
+	const struct object *obj;
+	int mode;
+	u32b epoch;
+	bool aware;
+	bool tried;
+	bool ignored;
+	bool show_flavors;
+	struct object copy;
+	struct object known;
+	size_t len;
+	char text[DESC_CACHE_LEN];
+};
+
+static struct desc_cache_entry desc_cache[DESC_CACHE_SIZE];
+
 const char *inscrip_text[] =
 {
 	NULL,
@@ -592,25 +619,26 @@ static size_t obj_desc_aware(const struct object *obj, char *buf, size_t max,
 
 
 /**
- * Describes item `obj` into buffer `buf` of size `max`.
- *
- * ODESC_PREFIX prepends a 'the', 'a' or number
- * ODESC_BASE results in a base description.
- * ODESC_COMBAT will add to-hit, to-dam and AC info.
- * ODESC_EXTRA will add pval/charge/inscription/ignore info.
- * ODESC_PLURAL will pluralise regardless of the number in the stack.
- * ODESC_STORE turns off ignore markers, for in-store display.
- * ODESC_SPOIL treats the object as fully identified.
- *
- * Setting 'prefix' to true prepends a 'the', 'a' or the number in the stack,
- * respectively.
- *
- * \returns The number of bytes used of the buffer.
+ * Note the ego and kind of an object as seen, if the player knows them
  */
-size_t object_desc(char *buf, size_t max, const struct object *obj, int mode)
+static void obj_desc_seen(const struct object *obj, int mode)
+{
+	if (mode & ODESC_SPOIL) return;
+
+	if (obj->known->ego)
+		obj->ego->everseen = true;
+
+	if (object_flavor_is_aware(obj))
+		obj->kind->everseen = true;
+}
+
+/**
+ * Build the description of `obj`; see object_desc()
+ */
+static size_t object_desc_aux(char *buf, size_t max, const struct object *obj,
+							  int mode)
 {
 	bool prefix = mode & ODESC_PREFIX ? true : false;
-	bool spoil = mode & ODESC_SPOIL ? true : false;
 	bool terse = mode & ODESC_TERSE ? true : false;
 
 	size_t end = 0;
@@ -632,11 +660,7 @@ size_t object_desc(char *buf, size_t max, const struct object *obj, int mode)
 				ignore_item_ok(obj) ? " {ignore}" : "");
 
 	/* Egos and kinds whose name we know are seen */
-	if (obj->known->ego && !spoil)
-		obj->ego->everseen = true;
-
-	if (object_flavor_is_aware(obj) && !spoil)
-		obj->kind->everseen = true;
+	obj_desc_seen(obj, mode);
 
 	/** Construct the name **/
 
@@ -667,3 +691,79 @@ size_t object_desc(char *buf, size_t max, const struct object *obj, int mode)
 
 	return end;
 }
+
+/**
+ * Describes item `obj` into buffer `buf` of size `max`.
+ *
+ * ODESC_PREFIX prepends a 'the', 'a' or number
+ * ODESC_BASE results in a base description.
+ * ODESC_COMBAT will add to-hit, to-dam and AC info.
+ * ODESC_EXTRA will add pval/charge/inscription/ignore info.
+ * ODESC_PLURAL will pluralise regardless of the number in the stack.
+ * ODESC_STORE turns off ignore markers, for in-store display.
+ * ODESC_SPOIL treats the object as fully identified.
+ *
+ * Setting 'prefix' to true prepends a 'the', 'a' or the number in the stack,
+ * respectively.
+ *
+ * \returns The number of bytes used of the buffer.
+ */
+size_t object_desc(char *buf, size_t max, const struct object *obj, int mode)
+{
+	struct desc_cache_entry *e;
+	bool aware, tried, ignored = false;
+	bool show_flavors = OPT(show_flavors) ? true : false;
+	size_t len;
+
+	/* Nothing to remember */
+	if (!obj || !obj->known)
+		return object_desc_aux(buf, max, obj, mode);
+
+	aware = obj->kind->aware;
+	tried = obj->kind->tried;
+	if (tval_is_money(obj) || ((mode & ODESC_EXTRA) && !(mode & ODESC_STORE)))
+		ignored = ignore_item_ok(obj);
+
+	e = &desc_cache[(((uintptr_t)obj >> 4) ^ ((u32b)mode * 2654435761U)) %
+					DESC_CACHE_SIZE];
+
+	/* Reuse the last description if nothing it depends on has changed */
+	if ((e->obj == obj) && (e->mode == mode) &&
+		(e->epoch == knowledge_epoch) && (e->aware == aware) &&
+		(e->tried == tried) && (e->ignored == ignored) &&
+		(e->show_flavors == show_flavors) &&
+		!memcmp(&e->copy, obj, sizeof(*obj)) &&
+		!memcmp(&e->known, obj->known, sizeof(*obj->known))) {
+		if (e->len < max) {
+			if (obj->kind == obj->known->kind && !tval_is_money(obj))
+				obj_desc_seen(obj, mode);
+			memcpy(buf, e->text, e->len + 1);
+			return e->len;
+		}
+		return object_desc_aux(buf, max, obj, mode);
+	}
+
+	/* Describe the object, remembering the description if it fits */
+	len = object_desc_aux(e->text, sizeof(e->text), obj, mode);
+	if (len >= sizeof(e->text) - 1) {
+		e->obj = NULL;
+		return object_desc_aux(buf, max, obj, mode);
+	}
+
+	e->obj = obj;
+	e->mode = mode;
+	e->epoch = knowledge_epoch;
+	e->aware = aware;
+	e->tried = tried;
+	e->ignored = ignored;
+	e->show_flavors = show_flavors;
+	memcpy(&e->copy, obj, sizeof(*obj));
+	memcpy(&e->known, obj->known, sizeof(*obj->known));
+	e->len = len;
+
+	if (len < max) {
+		memcpy(buf, e->text, len + 1);
+		return len;
+	}
+	return object_desc_aux(buf, max, obj, mode);
+}
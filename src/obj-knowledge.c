@@ -67,6 +67,13 @@ struct flag_type {
 
 static size_t rune_max;
 static struct rune *rune_list;
+
+/**
+ * Bumped whenever the player's knowledge of objects changes, so that anything
+ * worked out from that knowledge can tell when it is out of date
+ */
+u32b knowledge_epoch = 0;
+
 static char *c_rune[] = {
 	"enchantment to armor",
 	"enchantment to hit",
@@ -745,6 +752,8 @@ void player_know_object(struct player *p, struct object *obj)
 	if (!obj->known) return;
 	if (obj->kind != obj->known->kind) return;
 
+	knowledge_epoch++;
+
 	/* Set combat details */
 	obj->known->to_a = p->obj_k->to_a * obj->to_a;
 	if (!object_has_standard_to_h(obj))
@@ -988,6 +997,7 @@ static void player_learn_rune(struct player *p, size_t i, bool message)
 
 	/* Nothing learned */
 	if (!learned) return;
+	knowledge_epoch++;
 
 	/* Give a message */
 	if (message)
@@ -1577,6 +1587,7 @@ void object_flavor_aware(struct object *obj)
 	if (obj->kind->aware) return;
 	obj->kind->aware = true;
 	obj->known->effect = obj->effect;
+	knowledge_epoch++;
 
 	/* Fix ignore/autoinscribe */
 	if (kind_is_ignored_unaware(obj->kind))
@@ -1627,4 +1638,5 @@ void object_flavor_tried(struct object *obj)
 	assert(obj);
 	assert(obj->kind);
 	obj->kind->tried = true;
+	knowledge_epoch++;
 }
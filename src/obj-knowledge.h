@@ -44,6 +44,8 @@ struct rune {
 	const char *name;
 };
 
+extern u32b knowledge_epoch;
+
 int max_runes(void);
 enum rune_variety rune_variety(size_t i);
 bool player_knows_rune(struct player *p, size_t i);
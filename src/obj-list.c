@@ -122,7 +122,7 @@ void object_list_reset(object_list_t *list)
 	if (!object_list_needs_update(list))
 		return;
 
-	memset(list->entries, 0, list->entries_size * sizeof(object_list_entry_t));
+	memset(list->entries, 0, list->distinct_entries * sizeof(object_list_entry_t));
 	memset(list->total_entries, 0, OBJECT_LIST_SECTION_MAX * sizeof(u16b));
 	memset(list->total_objects, 0, OBJECT_LIST_SECTION_MAX * sizeof(u16b));
 	list->distinct_entries = 0;
@@ -166,8 +166,8 @@ void object_list_collect(object_list_t *list)
 
 	/* Scan each object in the dungeon. */
 	for (i = 1; i < cave_k->obj_max; i++) {
-		object_list_entry_t *entry = NULL;
-		int entry_index;
+		object_list_entry_t *entry;
+		int j;
 		int current_distance;
 		int entry_distance;
 		int y, x, field;
@@ -183,33 +183,22 @@ void object_list_collect(object_list_t *list)
 			x = obj->ix;
 		}
 
+		if (object_list_should_ignore_object(obj)) continue;
+
 		/* Determine which section of the list the object entry is in */
 		los = projectable(cave, py, px, y, x, PROJECT_NONE) ||
 			((y == py) && (x == px));
 		field = (los) ? OBJECT_LIST_SECTION_LOS : OBJECT_LIST_SECTION_NO_LOS;
 
-		if (object_list_should_ignore_object(obj)) continue;
-
-		/* Find or add a list entry. */
-		for (entry_index = 0; entry_index < (int)list->entries_size;
-			 entry_index++) {
-			int j;
-			struct object *list_obj = list->entries[entry_index].object;
-
-			if (list_obj == NULL) {
-				/* We found an empty slot, so add this object here. */
-				list->entries[entry_index].object = obj;
-				for (j = 0; j < OBJECT_LIST_SECTION_MAX; j++)
-					list->entries[entry_index].count[j] = 0;
-				list->entries[entry_index].dy = y - player->py;
-				list->entries[entry_index].dx = x - player->px;
-				entry = &list->entries[entry_index];
-				break;
-			}
-		}
-
-		if (entry == NULL)
-			return;
+		/* Each object gets its own entry, so add it at the end. */
+		if (list->distinct_entries >= list->entries_size)
+			break;
+		entry = &list->entries[list->distinct_entries++];
+		entry->object = obj;
+		for (j = 0; j < OBJECT_LIST_SECTION_MAX; j++)
+			entry->count[j] = 0;
+		entry->dy = y - player->py;
+		entry->dx = x - player->px;
 
 		/* We only know the number of objects we've actually seen */
 		if (obj->kind == cave->objects[obj->oidx]->kind)
@@ -230,10 +219,7 @@ void object_list_collect(object_list_t *list)
 	}
 
 	/* Collect totals for easier calculations of the list. */
-	for (i = 0; i < (int)list->entries_size; i++) {
-		if (list->entries[i].object == NULL)
-			continue;
-
+	for (i = 0; i < list->distinct_entries; i++) {
 		if (list->entries[i].count[OBJECT_LIST_SECTION_LOS] > 0)
 			list->total_entries[OBJECT_LIST_SECTION_LOS]++;
 
@@ -244,7 +230,6 @@ void object_list_collect(object_list_t *list)
 			list->entries[i].count[OBJECT_LIST_SECTION_LOS];
 		list->total_objects[OBJECT_LIST_SECTION_NO_LOS] +=
 			list->entries[i].count[OBJECT_LIST_SECTION_NO_LOS];
-		list->distinct_entries++;
 	}
 
 	list->creation_turn = turn;
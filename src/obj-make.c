@@ -29,12 +29,29 @@
 #include "obj-tval.h"
 #include "obj-util.h"
 
-/** Arrays holding an index of objects to generate for a given level */
+/**
+ * Arrays holding an index of objects to generate for a given level.
+ *
+ * obj_alloc[level * k_max + item] is the running total of the allocation
+ * probabilities of kinds 1 to item at that level, so a kind can be picked by
+ * binary search; obj_total[level] is the overall total.
+ */
 static u32b *obj_total;
-static byte *obj_alloc;
+static u32b *obj_alloc;
 
 static u32b *obj_total_great;
-static byte *obj_alloc_great;
+static u32b *obj_alloc_great;
+
+/**
+ * The same running totals for kinds of each tval.  obj_tval_kinds lists the
+ * kinds in order grouped by tval, with the group for tval t running from
+ * obj_tval_start[t] to obj_tval_start[t + 1] - 1; the totals are indexed by
+ * level * k_max + position in that list, and restart with each group.
+ */
+static int *obj_tval_kinds;
+static int *obj_tval_start;
+static u32b *obj_alloc_tval;
+static u32b *obj_alloc_tval_great;
 
 static s16b alloc_ego_size = 0;
 static alloc_entry *alloc_ego_table;
@@ -47,6 +64,15 @@ struct money {
 static struct money *money_type;
 static int num_money_types;
 
+/**
+ * Allocation probability of an object kind at a given level
+ */
+static int object_alloc_prob(const struct object_kind *kind, int lev)
+{
+	if ((lev < kind->alloc_min) || (lev > kind->alloc_max)) return 0;
+	return kind->alloc_prob;
+}
+
 static void init_obj_make(void) {
 	int i, item, lev;
 	int k_max = z_info->k_max;
@@ -59,34 +85,66 @@ static void init_obj_make(void) {
 	/*** Initialize object allocation info ***/
 
 	/* Allocate and wipe */
-	obj_alloc = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(byte));
-	obj_alloc_great = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(byte));
+	obj_alloc = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(u32b));
+	obj_alloc_great = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(u32b));
 	obj_total = mem_zalloc((z_info->max_obj_depth + 1) * sizeof(u32b));
 	obj_total_great = mem_zalloc((z_info->max_obj_depth + 1) * sizeof(u32b));
 
 	/* Init allocation data */
+	for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
+		u32b total = 0, total_great = 0;
+
+		for (item = 1; item < k_max; item++) {
+			int rarity = object_alloc_prob(&k_info[item], lev);
+
+			/* Save the probability in the standard table */
+			total += rarity;
+			obj_alloc[(lev * k_max) + item] = total;
+
+			/* Save the probability in the "great" table if relevant */
+			if (!kind_is_good(&k_info[item])) rarity = 0;
+			total_great += rarity;
+			obj_alloc_great[(lev * k_max) + item] = total_great;
+		}
+
+		obj_total[lev] = total;
+		obj_total_great[lev] = total_great;
+	}
+
+	/* Group the kinds by tval */
+	obj_tval_kinds = mem_zalloc(k_max * sizeof(int));
+	obj_tval_start = mem_zalloc((TV_MAX + 1) * sizeof(int));
+	for (item = 1; item < k_max; item++)
+		obj_tval_start[k_info[item].tval + 1]++;
+	for (i = 1; i <= TV_MAX; i++)
+		obj_tval_start[i] += obj_tval_start[i - 1];
+	aux = mem_zalloc(TV_MAX * sizeof(s16b));
 	for (item = 1; item < k_max; item++) {
-		const struct object_kind *kind = &k_info[item];
+		int tval = k_info[item].tval;
+		obj_tval_kinds[obj_tval_start[tval] + aux[tval]++] = item;
+	}
+	mem_free(aux);
 
-		int min = kind->alloc_min;
-		int max = kind->alloc_max;
+	/* Init allocation data by tval */
+	obj_alloc_tval = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(u32b));
+	obj_alloc_tval_great = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(u32b));
+	for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
+		int tval;
 
-		/* If an item doesn't have a rarity, move on */
-		if (!kind->alloc_prob) continue;
+		for (tval = 0; tval < TV_MAX; tval++) {
+			u32b total = 0, total_great = 0;
 
-		/* Go through all the dungeon levels */
-		for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
-			int rarity = kind->alloc_prob;
+			for (i = obj_tval_start[tval]; i < obj_tval_start[tval + 1]; i++) {
+				const struct object_kind *kind = &k_info[obj_tval_kinds[i]];
+				int rarity = object_alloc_prob(kind, lev);
 
-			/* Save the probability in the standard table */
-			if ((lev < min) || (lev > max)) rarity = 0;
-			obj_total[lev] += rarity;
-			obj_alloc[(lev * k_max) + item] = rarity;
+				total += rarity;
+				obj_alloc_tval[(lev * k_max) + i] = total;
 
-			/* Save the probability in the "great" table if relevant */
-			if (!kind_is_good(kind)) rarity = 0;
-			obj_total_great[lev] += rarity;
-			obj_alloc_great[(lev * k_max) + item] = rarity;
+				if (!kind_is_good(kind)) rarity = 0;
+				total_great += rarity;
+				obj_alloc_tval_great[(lev * k_max) + i] = total_great;
+			}
 		}
 	}
 
@@ -179,6 +237,10 @@ static void cleanup_obj_make(void) {
 	}
 	mem_free(money_type);
 	mem_free(alloc_ego_table);
+	mem_free(obj_alloc_tval_great);
+	mem_free(obj_alloc_tval);
+	mem_free(obj_tval_start);
+	mem_free(obj_tval_kinds);
 	mem_free(obj_total_great);
 	mem_free(obj_total);
 	mem_free(obj_alloc_great);
@@ -966,39 +1028,43 @@ bool kind_is_good(const struct object_kind *kind)
 }
 
 
+/**
+ * Find the first entry from start to end - 1 of a table of running totals
+ * which is greater than value, or end if there is none.
+ */
+static int alloc_search(const u32b *totals, int start, int end, u32b value)
+{
+	while (start < end) {
+		int mid = (start + end) / 2;
+		if (totals[mid] > value)
+			end = mid;
+		else
+			start = mid + 1;
+	}
+
+	return start;
+}
+
 /**
  * Choose an object kind of a given tval given a dungeon level.
  */
 static struct object_kind *get_obj_num_by_kind(int level, bool good, int tval)
 {
-	/* This is the base index into obj_alloc for this dlev */
-	size_t ind, item;
+	/* This is the base index into obj_alloc_tval for this dlev */
+	size_t ind = level * z_info->k_max;
+	int start = obj_tval_start[tval], end = obj_tval_start[tval + 1];
+	u32b *totals = good ? obj_alloc_tval_great : obj_alloc_tval;
 	u32b value;
-	int total = 0;
-	byte *objects = good ? obj_alloc_great : obj_alloc;
-
-	/* Pick an object */
-	ind = level * z_info->k_max;
-
-	/* Get new total */
-	for (item = 1; item < z_info->k_max; item++)
-		if (objkind_byid(item)->tval == tval)
-			total += objects[ind + item];
+	int i;
 
 	/* No appropriate items of that tval */
-	if (!total) return NULL;
-	
-	value = randint0(total);
-	
-	for (item = 1; item < z_info->k_max; item++)
-		if (objkind_byid(item)->tval == tval) {
-			if (value < objects[ind + item]) break;
+	if (start == end || !totals[ind + end - 1]) return NULL;
 
-			value -= objects[ind + item];
-		}
+	value = randint0(totals[ind + end - 1]);
+	i = alloc_search(totals + ind, start, end, value);
 
 	/* Return the item index */
-	return objkind_byid(item);
+	return objkind_byid(obj_tval_kinds[i]);
 }
 
 /**
@@ -1009,8 +1075,9 @@ static struct object_kind *get_obj_num_by_kind(int level, bool good, int tval)
 struct object_kind *get_obj_num(int level, bool good, int tval)
 {
 	/* This is the base index into obj_alloc for this dlev */
-	size_t ind, item;
+	size_t ind;
 	u32b value;
+	int item;
 
 	/* Occasional level boost */
 	if ((level > 0) && one_in_(z_info->great_obj))
@@ -1029,22 +1096,10 @@ struct object_kind *get_obj_num(int level, bool good, int tval)
 	
 	if (!good) {
 		value = randint0(obj_total[level]);
-		for (item = 1; item < z_info->k_max; item++) {
-			/* Found it */
-			if (value < obj_alloc[ind + item]) break;
-
-			/* Decrement */
-			value -= obj_alloc[ind + item];
-		}
+		item = alloc_search(obj_alloc + ind, 1, z_info->k_max, value);
 	} else {
 		value = randint0(obj_total_great[level]);
-		for (item = 1; item < z_info->k_max; item++) {
-			/* Found it */
-			if (value < obj_alloc_great[ind + item]) break;
-
-			/* Decrement */
-			value -= obj_alloc_great[ind + item];
-		}
+		item = alloc_search(obj_alloc_great + ind, 1, z_info->k_max, value);
 	}
 
 	/* Return the item index */
@@ -1180,7 +1235,7 @@ struct object *make_gold(int lev, char *coin_type)
 	s32b avg = (18 * lev)/10 + 18;
 	s32b spread = lev + 10;
 	s32b value = rand_spread(avg, spread);
-	struct object *new_gold = mem_zalloc(sizeof(*new_gold)); 
+	struct object *new_gold = object_new();
 
 	/* Increase the range to infinite, moving the average to 110% */
 	while (one_in_(100) && value * 10 <= SHRT_MAX)
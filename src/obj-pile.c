@@ -192,12 +192,100 @@ bool pile_contains(const struct object *top, const struct object *obj)
 	return false;
 }
 
+/**
+ * A block of objects for the object pool
+ */
+struct object_slab {
+	struct object_slab *next;
+	struct object objects[OBJECT_POOL_SLAB];
+};
+
+/**
+ * The object pool: every slab allocated so far, and a list (linked through
+ * the objects' next pointers) of the objects in them not in use
+ */
+static struct object_slab *object_slabs = NULL;
+static struct object *object_pool = NULL;
+static struct object_pool_stats object_stats;
+
+/**
+ * Add a slab of objects to the pool
+ */
+static void object_pool_grow(void)
+{
+	struct object_slab *slab = mem_zalloc(sizeof(*slab));
+	int i;
+
+	slab->next = object_slabs;
+	object_slabs = slab;
+
+	/* Hand out the lowest addresses first */
+	for (i = OBJECT_POOL_SLAB - 1; i >= 0; i--) {
+		slab->objects[i].next = object_pool;
+		object_pool = &slab->objects[i];
+	}
+
+	object_stats.slabs++;
+	object_stats.capacity += OBJECT_POOL_SLAB;
+}
+
+/**
+ * Return an object to the pool
+ */
+static void object_pool_release(struct object *obj)
+{
+	if (mem_flags & MEM_POISON_FREE)
+		memset(obj, 0xCD, sizeof(*obj));
+	obj->next = object_pool;
+	object_pool = obj;
+
+	object_stats.in_use--;
+	object_stats.frees++;
+}
+
 /**
  * Create a new object and return it
  */
 struct object *object_new(void)
 {
-	return mem_zalloc(sizeof(struct object));
+	struct object *obj;
+
+	if (!object_pool)
+		object_pool_grow();
+
+	obj = object_pool;
+	object_pool = obj->next;
+	memset(obj, 0, sizeof(*obj));
+
+	object_stats.allocs++;
+	if (++object_stats.in_use > object_stats.peak)
+		object_stats.peak = object_stats.in_use;
+
+	return obj;
+}
+
+/**
+ * Get the object pool's counts
+ */
+void object_pool_get_stats(struct object_pool_stats *stats)
+{
+	*stats = object_stats;
+}
+
+/**
+ * Free the whole object pool.  Any objects still in use are freed with it, so
+ * this must only be called once nothing refers to them.
+ */
+void object_pool_free(void)
+{
+	while (object_slabs) {
+		struct object_slab *next = object_slabs->next;
+		mem_free(object_slabs);
+		object_slabs = next;
+	}
+
+	object_pool = NULL;
+	memset(&object_stats, 0, sizeof(object_stats));
 }
 
 /**
@@ -313,7 +401,8 @@ void object_delete(struct object **obj_address)
 		player->upkeep->object = NULL;
 
 	/* Orphan rather than actually delete if we still have a known object */
-	if (cave && cave_k && obj->oidx && (obj == cave->objects[obj->oidx]) &&
+	if (cave && cave_k && obj->oidx && (obj->oidx <= cave->obj_max) &&
+		(obj == cave->objects[obj->oidx]) &&
 		cave_k->objects[obj->oidx]) {
 		obj->iy = 0;
 		obj->ix = 0;
@@ -332,16 +421,19 @@ void object_delete(struct object **obj_address)
 	if (obj->brands)
 		free_brand(obj->brands);
 
-	/* Remove from any lists */
+	/* Remove from any lists; the object may belong to a chunk with a longer
+	 * list than the current level's */
 	if (cave_k && cave_k->objects && obj->oidx
+		&& (obj->oidx <= cave_k->obj_max)
 		&& (obj == cave_k->objects[obj->oidx]))
 		cave_k->objects[obj->oidx] = NULL;
 
 	if (cave && cave->objects && obj->oidx
+		&& (obj->oidx <= cave->obj_max)
 		&& (obj == cave->objects[obj->oidx]))
 		cave->objects[obj->oidx] = NULL;
 
-	mem_free(obj);
+	object_pool_release(obj);
 	*obj_address = NULL;
 }
 
@@ -22,6 +22,23 @@
 #define OBJECT_LIST_SIZE  128
 #define OBJECT_LIST_INCR  128
 
+/**
+ * Number of objects carved from each slab of the object pool
+ */
+#define OBJECT_POOL_SLAB  256
+
+/**
+ * Counts kept by the object pool
+ */
+struct object_pool_stats {
+	u32b slabs;			/* Slabs allocated */
+	u32b capacity;		/* Objects those slabs hold */
+	u32b in_use;		/* Objects currently handed out */
+	u32b peak;			/* Most objects ever handed out at once */
+	u32b allocs;		/* Calls to object_new() */
+	u32b frees;			/* Objects returned to the pool */
+};
+
 /**
  * Modes for stacking by object_similar()
  */
@@ -49,6 +66,8 @@ typedef enum
 } object_floor_t;
 
 struct object *object_new(void);
+void object_pool_get_stats(struct object_pool_stats *stats);
+void object_pool_free(void);
 void list_object(struct chunk *c, struct object *obj);
 void delist_object(struct chunk *c, struct object *obj);
 void object_delete(struct object **obj_address);
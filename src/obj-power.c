@@ -137,10 +137,19 @@ ang_file *object_log;
 
 /**
  * Log progress info to the object log
+ *
+ * Nothing is formatted unless there is a log to write to, as object_power()
+ * is mostly called without one.
  */
-void log_obj(char *message)
+void log_obj(const char *fmt, ...)
 {
-	file_putf(object_log, message);
+	va_list vp;
+
+	if (!object_log) return;
+
+	va_start(vp, fmt);
+	file_vputf(object_log, fmt, vp);
+	va_end(vp);
 }
 
 /**
@@ -155,7 +164,7 @@ static int bow_multiplier(const struct object *obj)
 	else
 		mult = obj->pval;
 
-	log_obj(format("Base mult for this weapon is %d\n", mult));
+	log_obj("Base mult for this weapon is %d\n", mult);
 	return mult;
 }
 
@@ -167,7 +176,7 @@ static int to_damage_power(const struct object *obj)
 	int p;
 
 	p = (obj->to_d * DAMAGE_POWER / 2);
-	if (p) log_obj(format("%d power from to_dam\n", p));
+	if (p) log_obj("%d power from to_dam\n", p);
 
 	/* Add second lot of damage power for non-weapons */
 	if ((wield_slot(obj) != slot_by_name(player, "shooting")) &&
@@ -176,7 +185,7 @@ static int to_damage_power(const struct object *obj)
 		int q = (obj->to_d * DAMAGE_POWER);
 		p += q;
 		if (q)
-			log_obj(format("Add %d from non-weapon to_dam, total %d\n", q, p));
+			log_obj("Add %d from non-weapon to_dam, total %d\n", q, p);
 	}
 	return p;
 }
@@ -191,7 +200,7 @@ static int damage_dice_power(const struct object *obj)
 	/* Add damage from dice for any wieldable weapon or ammo */
 	if (tval_is_melee_weapon(obj) || tval_is_ammo(obj)) {
 		dice = (obj->dd * (obj->ds + 1) * DAMAGE_POWER / 4);
-		log_obj(format("Add %d power for damage dice, ", dice));
+		log_obj("Add %d power for damage dice, ", dice);
 	} else if (wield_slot(obj) != slot_by_name(player, "shooting")) {
 		/* Add power boost for nonweapons with combat flags */
 		if (obj->brands || obj->slays ||
@@ -199,8 +208,8 @@ static int damage_dice_power(const struct object *obj)
 			(obj->modifiers[OBJ_MOD_SHOTS] > 0) ||
 			(obj->modifiers[OBJ_MOD_MIGHT] > 0)) {
 			dice = (WEAP_DAMAGE * DAMAGE_POWER);
-			log_obj(format("Add %d power for non-weapon combat bonuses, ",
-						   dice));
+			log_obj("Add %d power for non-weapon combat bonuses, ",
+						   dice);
 		}
 	}
 	return dice;
@@ -224,8 +233,8 @@ static int ammo_damage_power(const struct object *obj, int p)
 
 		if (launcher != -1) {
 			q = (archery[launcher].ammo_dam * DAMAGE_POWER / 2);
-			log_obj(format("Adding %d power from ammo, total is %d\n", q,
-						   p + q));
+			log_obj("Adding %d power from ammo, total is %d\n", q,
+						   p + q);
 		}
 	}
 	return q;
@@ -244,8 +253,8 @@ static int launcher_ammo_damage_power(const struct object *obj, int p)
 		if (obj->ego)
 			p += (archery[ammo_type].launch_dam * DAMAGE_POWER / 2);
 		p = p * archery[ammo_type].launch_mult / (2 * MAX_BLOWS);
-		log_obj(format("After multiplying ammo and rescaling, power is %d\n",
-					   p));
+		log_obj("After multiplying ammo and rescaling, power is %d\n",
+					   p);
 	}
 	return p;
 }
@@ -269,8 +278,8 @@ static int extra_blows_power(const struct object *obj, int p)
 		/* Add boost for assumed off-weapon damage */
 		p += (NONWEAP_DAMAGE * obj->modifiers[OBJ_MOD_BLOWS]
 			  * DAMAGE_POWER / 2);
-		log_obj(format("Add %d power for extra blows, total is %d\n",
-					   p - q, p));
+		log_obj("Add %d power for extra blows, total is %d\n",
+					   p - q, p);
 	}
 	return p;
 }
@@ -290,8 +299,8 @@ static int extra_shots_power(const struct object *obj, int p)
 	} else if (obj->modifiers[OBJ_MOD_SHOTS] > 0) {
 		int q = obj->modifiers[OBJ_MOD_SHOTS];
 		p = p * (1 + q);
-		log_obj(format("Multiplying power by %d for extra shots, total is %d\n",
-					   1 + q, p));
+		log_obj("Multiplying power by %d for extra shots, total is %d\n",
+					   1 + q, p);
 	}
 	return p;
 }
@@ -309,9 +318,9 @@ static int extra_might_power(const struct object *obj, int p, int mult)
 	} else {
 		mult += obj->modifiers[OBJ_MOD_MIGHT];
 	}
-	log_obj(format("Mult after extra might is %d\n", mult));
+	log_obj("Mult after extra might is %d\n", mult);
 	p *= mult;
-	log_obj(format("After multiplying power for might, total is %d\n", p));
+	log_obj("After multiplying power for might, total is %d\n", p);
 	return p;
 }
 
@@ -397,14 +406,14 @@ static s32b slay_power(const struct object *obj, int p, int verbose,
 			slays = slay_collect(obj->slays, NULL);
 
 			for (b = brands; b; b = b->next) {
-				log_obj(format("%sx%d ", b->name, b->multiplier));
+				log_obj("%sx%d ", b->name, b->multiplier);
 			}
 			for (s = slays; s; s = s->next) {
-				log_obj(format("%sx%d ", s->name, s->multiplier));
+				log_obj("%sx%d ", s->name, s->multiplier);
 			}
-			log_obj(format("\nsv is: %d\n", sv));
-			log_obj(format(" and t_m_p is: %d \n", tot_mon_power));
-			log_obj(format("times 1000 is: %d\n", (1000 * sv) / tot_mon_power));
+			log_obj("\nsv is: %d\n", sv);
+			log_obj(" and t_m_p is: %d \n", tot_mon_power);
+			log_obj("times 1000 is: %d\n", (1000 * sv) / tot_mon_power);
 			free_brand(brands);
 			free_slay(slays);
 		}
@@ -416,35 +425,35 @@ static s32b slay_power(const struct object *obj, int p, int verbose,
 
 	q = (dice_pwr * (sv / 100)) / (tot_mon_power / 100);
 	p += q;
-	log_obj(format("Add %d for slay power, total is %d\n", q, p));
+	log_obj("Add %d for slay power, total is %d\n", q, p);
 
 	/* Bonuses for multiple brands and slays */
 	if (num_slays > 1) {
 		q = (num_slays * num_slays * dice_pwr) / (DAMAGE_POWER * 5);
 		p += q;
-		log_obj(format("Add %d power for multiple slays, total is %d\n", q, p));
+		log_obj("Add %d power for multiple slays, total is %d\n", q, p);
 	}
 	if (num_brands > 1) {
 		q = (2 * num_brands * num_brands * dice_pwr) / (DAMAGE_POWER * 5);
 		p += q;
-		log_obj(format("Add %d power for multiple brands, total is %d\n",q, p));
+		log_obj("Add %d power for multiple brands, total is %d\n",q, p);
 	}
 	if (num_kills > 1) {
 		q = (3 * num_kills * num_kills * dice_pwr) / (DAMAGE_POWER * 5);
 		p += q;
-		log_obj(format("Add %d power for multiple kills, total is %d\n", q, p));
+		log_obj("Add %d power for multiple kills, total is %d\n", q, p);
 	}
 	if (num_slays == 8) {
 		p += 10;
-		log_obj(format("Add 10 power for full set of slays, total is %d\n", p));
+		log_obj("Add 10 power for full set of slays, total is %d\n", p);
 	}
 	if (num_brands == 5) {
 		p += 20;
-		log_obj(format("Add 20 power for full set of brands, total is %d\n",p));
+		log_obj("Add 20 power for full set of brands, total is %d\n",p);
 	}
 	if (num_kills == 3) {
 		p += 20;
-		log_obj(format("Add 20 power for full set of kills, total is %d\n", p));
+		log_obj("Add 20 power for full set of kills, total is %d\n", p);
 	}
 
 	return p;
@@ -458,7 +467,7 @@ static int rescale_bow_power(const struct object *obj, int p)
 {
 	if (wield_slot(obj) == slot_by_name(player, "shooting")) {
 		p /= MAX_BLOWS;
-		log_obj(format("Rescaling bow power, total is %d\n", p));
+		log_obj("Rescaling bow power, total is %d\n", p);
 	}
 	return p;
 }
@@ -471,7 +480,7 @@ static int to_hit_power(const struct object *obj, int p)
 	int q = (obj->to_h * TO_HIT_POWER / 2);
 	p += q;
 	if (p) 
-		log_obj(format("Add %d power for to hit, total is %d\n", q, p));
+		log_obj("Add %d power for to hit, total is %d\n", q, p);
 	return p;
 }
 
@@ -485,7 +494,7 @@ static int ac_power(const struct object *obj, int p)
 	if (obj->ac) {
 		p += BASE_ARMOUR_POWER;
 		q += (obj->ac * BASE_AC_POWER / 2);
-		log_obj(format("Adding %d power for base AC value\n", q));
+		log_obj("Adding %d power for base AC value\n", q);
 
 		/* Add power for AC per unit weight */
 		if (obj->weight > 0) {
@@ -501,7 +510,7 @@ static int ac_power(const struct object *obj, int p)
 		} else
 			q *= 5;
 		p += q;
-		log_obj(format("Add %d power for AC per unit weight, now %d\n",	q, p));
+		log_obj("Add %d power for AC per unit weight, now %d\n",	q, p);
 	}
 	return p;
 }
@@ -518,18 +527,18 @@ static int to_ac_power(const struct object *obj, int p)
 
 	q = (obj->to_a * TO_AC_POWER / 2);
 	p += q;
-	log_obj(format("Add %d power for to_ac of %d, total is %d\n", 
-				   q, obj->to_a, p));
+	log_obj("Add %d power for to_ac of %d, total is %d\n", 
+				   q, obj->to_a, p);
 	if (obj->to_a > HIGH_TO_AC) {
 		q = ((obj->to_a - (HIGH_TO_AC - 1)) * TO_AC_POWER);
 		p += q;
-		log_obj(format("Add %d power for high to_ac, total is %d\n",
-							q, p));
+		log_obj("Add %d power for high to_ac, total is %d\n",
+							q, p);
 	}
 	if (obj->to_a > VERYHIGH_TO_AC) {
 		q = ((obj->to_a - (VERYHIGH_TO_AC -1)) * TO_AC_POWER * 2);
 		p += q;
-		log_obj(format("Add %d power for very high to_ac, total is %d\n",q, p));
+		log_obj("Add %d power for very high to_ac, total is %d\n",q, p);
 	}
 	if (obj->to_a >= INHIBIT_AC) {
 		p += INHIBIT_POWER;
@@ -545,8 +554,8 @@ static int jewelry_power(const struct object *obj, int p)
 {
 	if (tval_is_jewelry(obj)) {
 		p += BASE_JEWELRY_POWER;
-		log_obj(format("Adding %d power for jewelry, total is %d\n", 
-					   BASE_JEWELRY_POWER, p));
+		log_obj("Adding %d power for jewelry, total is %d\n", 
+					   BASE_JEWELRY_POWER, p);
 	}
 	return p;
 }
@@ -565,22 +574,22 @@ static int modifier_power(const struct object *obj, int p)
 		if (mod_power(i)) {
 			q = (k * mod_power(i) * mod_slot_mult(i, wield_slot(obj)));
 			p += q;
-			if (q) log_obj(format("Add %d power for %d %s, total is %d\n", 
-								  q, k, mod_name(i), p));
+			if (q) log_obj("Add %d power for %d %s, total is %d\n", 
+								  q, k, mod_name(i), p);
 		}
 	}
 
 	/* Add extra power term if there are a lot of ability bonuses */
 	if (extra_stat_bonus > 249) {
-		log_obj(format("Inhibiting - Total ability bonus of %d is too high\n", 
-					   extra_stat_bonus));
+		log_obj("Inhibiting - Total ability bonus of %d is too high\n", 
+					   extra_stat_bonus);
 		p += INHIBIT_POWER;
 	} else if (extra_stat_bonus > 0) {
 		q = ability_power[extra_stat_bonus / 10];
 		if (!q) return p;
 		p += q;
-		log_obj(format("Add %d power for modifier total of %d, total is %d\n", 
-					   q, extra_stat_bonus, p));
+		log_obj("Add %d power for modifier total of %d, total is %d\n", 
+					   q, extra_stat_bonus, p);
 	}
 	return p;
 }
@@ -611,8 +620,8 @@ static int flags_power(const struct object *obj, int p, int verbose,
 		if (flag_power(i)) {
 			q = (flag_power(i) * flag_slot_mult(i, wield_slot(obj)));
 			p += q;
-			log_obj(format("Add %d power for %s, total is %d\n", 
-						   q, flag_name(i), p));
+			log_obj("Add %d power for %s, total is %d\n", 
+						   q, flag_name(i), p);
 		}
 
 		/* Track combinations of flag types */
@@ -626,16 +635,16 @@ static int flags_power(const struct object *obj, int p, int verbose,
 		if (flag_sets[i].count > 1) {
 			q = (flag_sets[i].factor * flag_sets[i].count * flag_sets[i].count);
 			p += q;
-			log_obj(format("Add %d power for multiple %s, total is %d\n",
-						   q, flag_sets[i].desc, p));
+			log_obj("Add %d power for multiple %s, total is %d\n",
+						   q, flag_sets[i].desc, p);
 		}
 
 		/* Add bonus if item has a full set of these flags */
 		if (flag_sets[i].count == flag_sets[i].size) {
 			q = flag_sets[i].bonus;
 			p += q;
-			log_obj(format("Add %d power for full set of %s, total is %d\n", 
-						   q, flag_sets[i].desc, p));
+			log_obj("Add %d power for full set of %s, total is %d\n", 
+						   q, flag_sets[i].desc, p);
 		}
 	}
 
@@ -660,8 +669,8 @@ static int element_power(const struct object *obj, int p)
 			if (el_powers[i].ignore_power != 0) {
 				q = (el_powers[i].ignore_power);
 				p += q;
-				log_obj(format("Add %d power for ignoring %s, total is %d\n",
-							   q, el_powers[i].name, p));
+				log_obj("Add %d power for ignoring %s, total is %d\n",
+							   q, el_powers[i].name, p);
 			}
 		}
 
@@ -669,20 +678,20 @@ static int element_power(const struct object *obj, int p)
 			if (el_powers[i].vuln_power != 0) {
 				q = (el_powers[i].vuln_power);
 				p += q;
-				log_obj(format("Add %d power for vulnerability to %s, total is %d\n", q, el_powers[i].name, p));
+				log_obj("Add %d power for vulnerability to %s, total is %d\n", q, el_powers[i].name, p);
 			}
 		} else if (obj->el_info[i].res_level == 1) {
 			if (el_powers[i].res_power != 0) {
 				q = (el_powers[i].res_power);
 				p += q;
-				log_obj(format("Add %d power for resistance to %s, total is %d\n", q, el_powers[i].name, p));
+				log_obj("Add %d power for resistance to %s, total is %d\n", q, el_powers[i].name, p);
 			}
 		} else if (obj->el_info[i].res_level == 3) {
 			if (el_powers[i].im_power != 0) {
 				q = (el_powers[i].im_power + el_powers[i].res_power);
 				p += q;
-				log_obj(format("Add %d power for immunity to %s, total is %d\n",
-							   q, el_powers[i].name, p));
+				log_obj("Add %d power for immunity to %s, total is %d\n",
+							   q, el_powers[i].name, p);
 			}
 		}
 
@@ -698,16 +707,16 @@ static int element_power(const struct object *obj, int p)
 		if (element_sets[i].count > 1) {
 			q = (element_sets[i].factor * element_sets[i].count * element_sets[i].count);
 			p += q;
-			log_obj(format("Add %d power for multiple %s, total is %d\n",
-						   q, element_sets[i].desc, p));
+			log_obj("Add %d power for multiple %s, total is %d\n",
+						   q, element_sets[i].desc, p);
 		}
 
 		/* Add bonus if item has a full set of these flags */
 		if (element_sets[i].count == element_sets[i].size) {
 			q = element_sets[i].bonus;
 			p += q;
-			log_obj(format("Add %d power for full set of %s, total is %d\n", 
-						   q, element_sets[i].desc, p));
+			log_obj("Add %d power for full set of %s, total is %d\n", 
+						   q, element_sets[i].desc, p);
 		}
 	}
 
@@ -730,8 +739,8 @@ static int effects_power(const struct object *obj, int p)
 
 	if (q) {
 		p += q;
-		log_obj(format("Add %d power for item activation, total is %d\n",
-					   q, p));
+		log_obj("Add %d power for item activation, total is %d\n",
+					   q, p);
 	}
 	return p;
 }
@@ -751,7 +760,7 @@ s32b object_power(const struct object* obj, int verbose, ang_file *log_file)
 	p = to_damage_power(obj);
 	dice_pwr = damage_dice_power(obj);
 	p += dice_pwr;
-	if (dice_pwr) log_obj(format("total is %d\n", p));
+	if (dice_pwr) log_obj("total is %d\n", p);
 	p += ammo_damage_power(obj, p);
 	mult = bow_multiplier(obj);
 	p = launcher_ammo_damage_power(obj, p);
@@ -778,7 +787,7 @@ s32b object_power(const struct object* obj, int verbose, ang_file *log_file)
 	p = element_power(obj, p);
 	p = effects_power(obj, p);
 
-	log_obj(format("FINAL POWER IS %d\n", p));
+	log_obj("FINAL POWER IS %d\n", p);
 
 	return p;
 }
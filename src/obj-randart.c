@@ -303,9 +303,11 @@ static s32b artifact_power(int a_idx, bool translate)
 
 	object_copy(&known_obj, &obj);
 	obj.known = &known_obj;
-	object_desc(buf, 256 * sizeof(char), &obj,
-				ODESC_PREFIX | ODESC_FULL | ODESC_SPOIL);
-	file_putf(log_file, "%s\n", buf);
+	if (log_file) {
+		object_desc(buf, 256 * sizeof(char), &obj,
+					ODESC_PREFIX | ODESC_FULL | ODESC_SPOIL);
+		file_putf(log_file, "%s\n", buf);
+	}
 
 	power = object_power(&obj, verbose, log_file);
 
@@ -2710,88 +2712,179 @@ static void scramble_artifact(int a_idx)
 	file_putf(log_file, "Number of tries for artifact %d was: %d\n", a_idx, tries);
 }
 
+/**
+ * The types of artifact an acceptable set must have enough of
+ */
+static const struct art_category {
+	const char *name;
+	const char *desc;
+	int min;
+} art_categories[] = {
+	{ "swords", "swords", 5 },
+	{ "polearms", "polearms", 5 },
+	{ "blunts", "blunts", 5 },
+	{ "bows", "bows", 4 },
+	{ "bodies", "body-armors", 5 },
+	{ "shields", "shields", 4 },
+	{ "cloaks", "cloaks", 4 },
+	{ "hats", "hats", 4 },
+	{ "gloves", "gloves", 4 },
+	{ "boots", "boots", 4 }
+};
+
+#define ART_CATEGORY_MAX (int)N_ELEMENTS(art_categories)
+
+/**
+ * Most passes over the set repair_artifacts() makes before giving up
+ */
+#define ART_REPAIR_PASSES 10
+
+/**
+ * Return the index in art_categories[] of an artifact's type, or -1 if
+ * there is no minimum for it
+ */
+static int art_category(const struct artifact *art)
+{
+	switch (art->tval)
+	{
+		case TV_SWORD: return 0;
+		case TV_POLEARM: return 1;
+		case TV_HAFTED: return 2;
+		case TV_BOW: return 3;
+		case TV_SOFT_ARMOR:
+		case TV_HARD_ARMOR:
+		case TV_DRAG_ARMOR: return 4;
+		case TV_SHIELD: return 5;
+		case TV_CLOAK: return 6;
+		case TV_HELM:
+		case TV_CROWN: return 7;
+		case TV_GLOVES: return 8;
+		case TV_BOOTS: return 9;
+		default: return -1;
+	}
+}
+
+/**
+ * Work out how far short of its minimum the set is for each type of
+ * artifact; a negative deficit is a surplus
+ */
+static void art_category_deficits(int *deficit)
+{
+	int i;
+
+	for (i = 0; i < ART_CATEGORY_MAX; i++)
+		deficit[i] = art_categories[i].min;
+
+	for (i = 0; i < z_info->a_max; i++) {
+		int cat = art_category(&a_info[i]);
+		if (cat >= 0) deficit[cat]--;
+	}
+}
+
 /**
  * Return true if the whole set of random artifacts meets certain
  * criteria.  Return false if we fail to meet those criteria (which will
- * restart the whole process).
+ * restart the whole process, or repair the set).
  */
 static bool artifacts_acceptable(void)
 {
-	int swords = 5, polearms = 5, blunts = 5, bows = 4;
-	int bodies = 5, shields = 4, cloaks = 4, hats = 4;
-	int gloves = 4, boots = 4;
+	int deficit[ART_CATEGORY_MAX];
+	char types[256] = "";
+	bool short_of_any = false;
 	int i;
 
-	for (i = 0; i < z_info->a_max; i++)
-	{
-		switch (a_info[i].tval)
-		{
-			case TV_SWORD:
-				swords--; break;
-			case TV_POLEARM:
-				polearms--; break;
-			case TV_HAFTED:
-				blunts--; break;
-			case TV_BOW:
-				bows--; break;
-			case TV_SOFT_ARMOR:
-			case TV_HARD_ARMOR:
-			case TV_DRAG_ARMOR:
-				bodies--; break;
-			case TV_SHIELD:
-				shields--; break;
-			case TV_CLOAK:
-				cloaks--; break;
-			case TV_HELM:
-			case TV_CROWN:
-				hats--; break;
-			case TV_GLOVES:
-				gloves--; break;
-			case TV_BOOTS:
-				boots--; break;
+	art_category_deficits(deficit);
+
+	for (i = 0; i < ART_CATEGORY_MAX; i++) {
+		file_putf(log_file, "Deficit amount for %s is %d\n",
+				  art_categories[i].name, deficit[i]);
+		if (deficit[i] > 0) {
+			my_strcat(types, " ", sizeof(types));
+			my_strcat(types, art_categories[i].desc, sizeof(types));
+			short_of_any = true;
 		}
 	}
 
-	file_putf(log_file, "Deficit amount for swords is %d\n", swords);
-	file_putf(log_file, "Deficit amount for polearms is %d\n", polearms);
-	file_putf(log_file, "Deficit amount for blunts is %d\n", blunts);
-	file_putf(log_file, "Deficit amount for bows is %d\n", bows);
-	file_putf(log_file, "Deficit amount for bodies is %d\n", bodies);
-	file_putf(log_file, "Deficit amount for shields is %d\n", shields);
-	file_putf(log_file, "Deficit amount for cloaks is %d\n", cloaks);
-	file_putf(log_file, "Deficit amount for hats is %d\n", hats);
-	file_putf(log_file, "Deficit amount for gloves is %d\n", gloves);
-	file_putf(log_file, "Deficit amount for boots is %d\n", boots);
-
-	if (swords > 0 || polearms > 0 || blunts > 0 || bows > 0 ||
-	    bodies > 0 || shields > 0 || cloaks > 0 || hats > 0 ||
-	    gloves > 0 || boots > 0) {
-		if (verbose) {
-			char types[256];
-			strnfmt(types, sizeof(types), "%s%s%s%s%s%s%s%s%s%s",
-					swords > 0 ? " swords" : "",
-					polearms > 0 ? " polearms" : "",
-					blunts > 0 ? " blunts" : "",
-					bows > 0 ? " bows" : "",
-					bodies > 0 ? " body-armors" : "",
-					shields > 0 ? " shields" : "",
-					cloaks > 0 ? " cloaks" : "",
-					hats > 0 ? " hats" : "",
-					gloves > 0 ? " gloves" : "",
-					boots > 0 ? " boots" : "");
-
+	if (short_of_any) {
+		if (verbose)
 			file_putf(log_file, "Restarting generation process: not enough%s",
 					  types);
-		}
 		return false;
 	} else
 		return true;
 }
 
+/**
+ * Return true if scramble_artifact() would give the artifact a new base item
+ */
+static bool artifact_can_change_kind(int a_idx)
+{
+	struct artifact *art = &a_info[a_idx];
+	struct object_kind *kind;
+
+	if (art->tval == 0) return false;
+
+	kind = lookup_kind(art->tval, art->sval);
+	if (strstr(art->name, "The One Ring") ||
+		kf_has(kind->kind_flags, KF_QUEST_ART) ||
+		kf_has(kind->kind_flags, KF_INSTA_ART))
+		return false;
+
+	return base_power[a_idx] <= INHIBIT_POWER;
+}
+
+/**
+ * Make up any shortfall in a set of artifacts by regenerating only as many
+ * artifacts as it takes, starting with the lowest indices and never taking
+ * from a type which has none to spare.
+ *
+ * Returns false if the set is still short after ART_REPAIR_PASSES passes,
+ * for example because no artifact can be changed into a missing type.
+ */
+static bool repair_artifacts(void)
+{
+	int pass;
+
+	for (pass = 0; pass < ART_REPAIR_PASSES; pass++) {
+		int deficit[ART_CATEGORY_MAX];
+		int a_idx, i;
+
+		if (artifacts_acceptable())
+			return true;
+
+		art_category_deficits(deficit);
+
+		for (a_idx = 1; a_idx < z_info->a_max; a_idx++) {
+			int cat = art_category(&a_info[a_idx]);
+			bool short_of_any = false;
+
+			if (!artifact_can_change_kind(a_idx)) continue;
+			if (cat >= 0 && deficit[cat] >= 0) continue;
+
+			file_putf(log_file, "Repairing set with artifact %d\n", a_idx);
+			scramble_artifact(a_idx);
+
+			if (cat >= 0) deficit[cat]++;
+			cat = art_category(&a_info[a_idx]);
+			if (cat >= 0) deficit[cat]--;
+
+			for (i = 0; i < ART_CATEGORY_MAX; i++)
+				if (deficit[i] > 0) short_of_any = true;
+			if (!short_of_any) break;
+		}
+	}
+
+	return artifacts_acceptable();
+}
+
 /**
  * Scramble each artifact
+ *
+ * If the set fails to meet certain criteria, the original way is to start
+ * over; otherwise it is repaired (see repair_artifacts()), and only started
+ * over if it can't be.
  */
-static errr scramble(void)
+static errr scramble(bool repair)
 {
 	/* If our artifact set fails to meet certain criteria, we start over. */
 	do {
@@ -2800,7 +2893,7 @@ static errr scramble(void)
 		/* Generate all the artifacts. */
 		for (a_idx = 1; a_idx < z_info->a_max; a_idx++)
 			scramble_artifact(a_idx);
-	} while (!artifacts_acceptable());
+	} while (repair ? !repair_artifacts() : !artifacts_acceptable());
 
 	/* Success */
 	return (0);
@@ -2861,7 +2954,7 @@ static errr init_names(void)
 /**
  * Call the name allocation and artifact scrambling routines
  */
-static errr do_randart_aux(bool full)
+static errr do_randart_aux(bool full, bool repair)
 {
 	errr result;
 
@@ -2870,7 +2963,7 @@ static errr do_randart_aux(bool full)
 
 	/* Randomize the artifacts */
 	if (full)
-		if ((result = scramble()) != 0) return (result);
+		if ((result = scramble(repair)) != 0) return (result);
 
 	/* Success */
 	return (0);
@@ -2881,14 +2974,16 @@ static errr do_randart_aux(bool full)
  * Randomize the artifacts
  *
  * The full flag toggles between just randomizing the names and
- * complete randomization of the artifacts.
+ * complete randomization of the artifacts.  Seeds marked with
+ * RANDART_SEED_REPAIR repair an unacceptable set instead of starting over.
  */
 errr do_randart(u32b randart_seed, bool full)
 {
 	errr err;
+	bool repair = (randart_seed & RANDART_SEED_REPAIR) ? true : false;
 
 	/* Prepare to use the Angband "simple" RNG. */
-	Rand_value = randart_seed;
+	Rand_value = randart_seed & ~RANDART_SEED_REPAIR;
 	Rand_quick = true;
 
 	/* Only do all the following if full randomization requested */
@@ -2920,7 +3015,7 @@ errr do_randart(u32b randart_seed, bool full)
 	}
 
 	/* Generate the random artifact (names) */
-	err = do_randart_aux(full);
+	err = do_randart_aux(full, repair);
 
 	/* Only do all the following if full randomization requested */
 	if (full) {
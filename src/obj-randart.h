@@ -31,6 +31,14 @@
 #define MIN_NAME_LEN 5
 #define MAX_NAME_LEN 9
 
+/**
+ * Randart seeds with this bit set make up any shortfall in the set of
+ * artifacts by regenerating a few of them, rather than the whole set.
+ * Seeds without it (including all those in older savefiles) keep the
+ * original behaviour, so they still give the same artifacts.
+ */
+#define RANDART_SEED_REPAIR 0x80000000UL
+
 /**
  * Inhibiting factors for large bonus values
  * "HIGH" values use INHIBIT_WEAK
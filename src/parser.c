@@ -33,6 +33,12 @@
  * Each hook has a list of specs, which are essentially named formal parameters;
  * when we run a particular hook across a line, each spec in the hook is
  * assigned a value.
+ *
+ * Hooks are found through a hash table on their directive.  The values of a
+ * line are kept in an array, in the order of the specs, and symbols and
+ * strings point into the parser's own copy of the line.  Each spec knows its
+ * slot in that array, and each hook hashes its specs on their names when it
+ * is registered, so a value is found by name without searching the line.
  */
 
 const char *parser_error_str[PARSE_ERROR_MAX] = {
@@ -56,10 +62,11 @@ struct parser_spec {
 	struct parser_spec *next;
 	int type;
 	const char *name;
+	unsigned int slot;		/* Position of its value in the line */
 };
 
 struct parser_value {
-	struct parser_spec spec;
+	const struct parser_spec *spec;
 	union {
 		wchar_t cval;
 		int ival;
@@ -72,9 +79,13 @@ struct parser_value {
 struct parser_hook {
 	struct parser_hook *next;
 	enum parser_error (*func)(struct parser *p);
+	unsigned int index;		/* Order of registration */
 	char *dir;
 	struct parser_spec *fhead;
 	struct parser_spec *ftail;
+	unsigned int nspecs;
+	struct parser_spec **names;	/* Specs hashed on their names */
+	size_t names_size;
 };
 
 struct parser {
@@ -83,9 +94,22 @@ struct parser {
 	unsigned int colno;
 	char errmsg[1024];
 	struct parser_hook *hooks;
-	struct parser_value *fhead;
-	struct parser_value *ftail;
+	unsigned int nhooks;
+	struct parser_hook **table;	/* Hooks hashed on their directive */
+	size_t table_size;
+	struct parser_hook *hook;	/* Hook of the current line */
+	struct parser_value *values;	/* Values of the current line, in spec order */
+	unsigned int nvalues;
+	unsigned int max_values;
+	char *line;		/* Copy of the current line, tokenized in place */
+	size_t line_size;
 	void *priv;
+
+	/* Record of the lines parsed, for the parse cache */
+	byte *rec;
+	size_t rec_len;
+	size_t rec_size;
+	u32b rec_count;
 };
 
 /**
@@ -96,28 +120,47 @@ struct parser *parser_new(void) {
 	return p;
 }
 
+/**
+ * Find the slot in the hook table for a directive: the one holding its hook,
+ * or the empty one where it would go
+ */
+static size_t hook_slot(struct parser *p, const char *dir) {
+	size_t mask = p->table_size - 1;
+	size_t slot = djb2_hash(dir) & mask;
+
+	while (p->table[slot] && strcmp(p->table[slot]->dir, dir))
+		slot = (slot + 1) & mask;
+
+	return slot;
+}
+
 static struct parser_hook *findhook(struct parser *p, const char *dir) {
-	struct parser_hook *h = p->hooks;
-	while (h) {
-		if (!strcmp(h->dir, dir))
-			break;
-		h = h->next;
-	}
-	return h;
+	if (!p->table)
+		return NULL;
+	return p->table[hook_slot(p, dir)];
 }
 
-static void parser_freeold(struct parser *p) {
-	struct parser_value *v;
-	while (p->fhead) {
-		int t = p->fhead->spec.type & ~PARSE_T_OPT;
-		v = (struct parser_value *)p->fhead->spec.next;
-		if (t == PARSE_T_SYM || t == PARSE_T_STR)
-			mem_free(p->fhead->u.sval);
-		mem_free(p->fhead);
-		p->fhead = v;
+/**
+ * Put all the hooks into a hook table of the given size.  If a directive has
+ * more than one hook, the last one registered is used.
+ */
+static void parser_rehash(struct parser *p, size_t size) {
+	struct parser_hook *h;
+
+	mem_free(p->table);
+	p->table = mem_zalloc(size * sizeof(*p->table));
+	p->table_size = size;
+
+	/* The hook list starts with the last registered */
+	for (h = p->hooks; h; h = h->next) {
+		size_t slot = hook_slot(p, h->dir);
+		if (!p->table[slot])
+			p->table[slot] = h;
 	}
 }
 
+static void parse_cache_record(struct parser *p, struct parser_hook *h);
+
 static bool parse_random(const char *str, random_value *bonus) {
 	bool negative = false;
 
@@ -209,22 +252,20 @@ static bool parse_random(const char *str, random_value *bonus) {
  * This runs the first parser hook registered with `p` that matches `line`.
  */
 enum parser_error parser_parse(struct parser *p, const char *line) {
-	char *cline;
 	char *tok;
 	struct parser_hook *h;
 	struct parser_spec *s;
 	struct parser_value *v;
 	char *sp = NULL;
+	size_t len;
 
 	assert(p);
 	assert(line);
 
-	parser_freeold(p);
-
+	p->nvalues = 0;
+	p->hook = NULL;
 	p->lineno++;
 	p->colno = 1;
-	p->fhead = NULL;
-	p->ftail = NULL;
 
 	/* Ignore empty lines and comments. */
 	while (*line && (isspace(*line)))
@@ -232,11 +273,16 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!*line || *line == '#')
 		return PARSE_ERROR_NONE;
 
-	cline = string_make(line);
+	/* Values point into this copy of the line, so they need no copies */
+	len = strlen(line) + 1;
+	if (len > p->line_size) {
+		p->line_size = MAX(len, 2 * p->line_size);
+		p->line = mem_realloc(p->line, p->line_size);
+	}
+	memcpy(p->line, line, len);
 
-	tok = strtok(cline, ":");
+	tok = strtok(p->line, ":");
 	if (!tok) {
-		mem_free(cline);
 		p->error = PARSE_ERROR_MISSING_FIELD;
 		return PARSE_ERROR_MISSING_FIELD;
 	}
@@ -245,9 +291,9 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!h) {
 		my_strcpy(p->errmsg, tok, sizeof(p->errmsg));
 		p->error = PARSE_ERROR_UNDEFINED_DIRECTIVE;
-		mem_free(cline);
 		return PARSE_ERROR_UNDEFINED_DIRECTIVE;
 	}
+	p->hook = h;
 
 	/* There's a little bit of trickiness here to account for optional
 	 * types. The optional flag has a bit assigned to it in the spec's type
@@ -266,7 +312,7 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		} else if (t == PARSE_T_CHAR) {
 			tok = strtok(sp, "");
 			if (tok)
-				sp = tok + 2;
+				sp = tok[1] ? tok + 2 : tok + 1;
 		} else {
 			tok = strtok(sp, "");
 			sp = NULL;
@@ -275,25 +321,20 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			if (!(s->type & PARSE_T_OPT)) {
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_MISSING_FIELD;
-				mem_free(cline);
 				return PARSE_ERROR_MISSING_FIELD;
 			}
 			break;
 		}
 
-		/* Allocate a value node. */
-		v = mem_alloc(sizeof *v);
-		v->spec.next = NULL;
-		v->spec.type = s->type;
-		v->spec.name = s->name;
+		/* Take the next value slot. */
+		v = &p->values[p->nvalues];
+		v->spec = s;
 
 		/* Parse out its value. */
 		if (t == PARSE_T_INT) {
 			char *z = NULL;
 			v->u.ival = strtol(tok, &z, 0);
 			if (z == tok) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -302,8 +343,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			char *z = NULL;
 			v->u.uval = strtoul(tok, &z, 0);
 			if (z == tok || *tok == '-') {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -311,26 +350,20 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		} else if (t == PARSE_T_CHAR) {
 			text_mbstowcs(&v->u.cval, tok, 1);
 		} else if (t == PARSE_T_SYM || t == PARSE_T_STR) {
-			v->u.sval = string_make(tok);
+			v->u.sval = tok;
 		} else if (t == PARSE_T_RAND) {
 			if (!parse_random(tok, &v->u.rval)) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_RANDOM;
 				return PARSE_ERROR_NOT_RANDOM;
 			}
 		}
 
-		/* Link it into the value list. */
-		if (!p->fhead)
-			p->fhead = v;
-		else
-			p->ftail->spec.next = &v->spec;
-		p->ftail = v;
+		p->nvalues++;
 	}
 
-	mem_free(cline);
+	if (p->rec)
+		parse_cache_record(p, h);
 
 	p->error = h->func(p);
 	return p->error;
@@ -352,6 +385,20 @@ void parser_setpriv(struct parser *p, void *v) {
 	p->priv = v;
 }
 
+/**
+ * Find the slot in a hook's name table for a spec name: the one holding its
+ * spec, or the empty one where it would go
+ */
+static size_t name_slot(const struct parser_hook *h, const char *name) {
+	size_t mask = h->names_size - 1;
+	size_t slot = djb2_hash(name) & mask;
+
+	while (h->names[slot] && strcmp(h->names[slot]->name, name))
+		slot = (slot + 1) & mask;
+
+	return slot;
+}
+
 static int parse_type(const char *s) {
 	int rv = 0;
 	if (s[0] == '?') {
@@ -376,6 +423,8 @@ static int parse_type(const char *s) {
 static void clean_specs(struct parser_hook *h) {
 	struct parser_spec *s;
 	mem_free(h->dir);
+	mem_free(h->names);
+	h->names = NULL;
 	while (h->fhead) {
 		s = h->fhead;
 		h->fhead = h->fhead->next;
@@ -389,7 +438,10 @@ static void clean_specs(struct parser_hook *h) {
  */
 void parser_destroy(struct parser *p) {
 	struct parser_hook *h;
-	parser_freeold(p);
+	mem_free(p->rec);
+	mem_free(p->table);
+	mem_free(p->values);
+	mem_free(p->line);
 	while (p->hooks) {
 		h = p->hooks->next;
 		clean_specs(p->hooks);
@@ -414,6 +466,9 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 	h->dir = string_make(name);
 	h->fhead = NULL;
 	h->ftail = NULL;
+	h->nspecs = 0;
+	h->names = NULL;
+	h->names_size = 0;
 	while (name) {
 		/* Lack of a type is legal; that means we're at the end of the line. */
 		stype = strtok(NULL, " ");
@@ -448,6 +503,7 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 		s = mem_alloc(sizeof *s);
 		s->type = type;
 		s->name = string_make(name);
+		s->slot = h->nspecs++;
 		s->next = NULL;
 		if (h->fhead)
 			h->ftail->next = s;
@@ -456,6 +512,18 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 		h->ftail = s;
 	}
 
+	/* Hash the specs on their names, keeping the table at most half full;
+	 * if two specs share a name, the first is used */
+	h->names_size = 4;
+	while (h->names_size < 2 * h->nspecs)
+		h->names_size *= 2;
+	h->names = mem_zalloc(h->names_size * sizeof(*h->names));
+	for (s = h->fhead; s; s = s->next) {
+		size_t slot = name_slot(h, s->name);
+		if (!h->names[slot])
+			h->names[slot] = s;
+	}
+
 	return 0;
 }
 
@@ -485,6 +553,7 @@ errr parser_reg(struct parser *p, const char *fmt,
 	cfmt = string_make(fmt);
 	h->next = p->hooks;
 	h->func = func;
+	h->index = p->nhooks;
 	r = parse_specs(h, cfmt);
 	if (r)
 	{
@@ -494,7 +563,22 @@ errr parser_reg(struct parser *p, const char *fmt,
 	}
 
 	p->hooks = h;
+	p->nhooks++;
 	mem_free(cfmt);
+
+	/* Make room for its values */
+	if (h->nspecs > p->max_values) {
+		p->max_values = h->nspecs;
+		p->values = mem_realloc(p->values,
+			p->max_values * sizeof(*p->values));
+	}
+
+	/* Add it to the hook table, keeping the table at most half full */
+	if (2 * p->nhooks > p->table_size)
+		parser_rehash(p, p->table_size ? 2 * p->table_size : 32);
+	else
+		p->table[hook_slot(p, h->dir)] = h;
+
 	return 0;
 }
 
@@ -511,20 +595,22 @@ enum parser_error ignored(struct parser *p) {
  * Used to test for presence of optional values.
  */
 bool parser_hasval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name))
-			return true;
-	}
-	return false;
+	const struct parser_spec *s;
+
+	if (!p->hook)
+		return false;
+	s = p->hook->names[name_slot(p->hook, name)];
+	return s && s->slot < p->nvalues;
 }
 
 static struct parser_value *parser_getval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name)) {
-			return v;
-		}
+	const struct parser_spec *s = NULL;
+
+	if (p->hook)
+		s = p->hook->names[name_slot(p->hook, name)];
+	if (s && s->slot < p->nvalues) {
+		assert(p->values[s->slot].spec == s);
+		return &p->values[s->slot];
 	}
 	quit_fmt("parser_getval error: name is %s\n", name);
 	return 0; /* Needed to avoid Windows compiler warning */
@@ -535,7 +621,7 @@ static struct parser_value *parser_getval(struct parser *p, const char *name) {
  */
 const char *parser_getsym(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_SYM);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_SYM);
 	return v->u.sval;
 }
 
@@ -544,7 +630,7 @@ const char *parser_getsym(struct parser *p, const char *name) {
  */
 int parser_getint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_INT);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_INT);
 	return v->u.ival;
 }
 
@@ -553,7 +639,7 @@ int parser_getint(struct parser *p, const char *name) {
  */
 unsigned int parser_getuint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_UINT);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_UINT);
 	return v->u.uval;
 }
 
@@ -562,7 +648,7 @@ unsigned int parser_getuint(struct parser *p, const char *name) {
  */
 const char *parser_getstr(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_STR);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_STR);
 	return v->u.sval;
 }
 
@@ -571,7 +657,7 @@ const char *parser_getstr(struct parser *p, const char *name) {
  */
 struct random parser_getrand(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_RAND);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_RAND);
 	return v->u.rval;
 }
 
@@ -580,7 +666,7 @@ struct random parser_getrand(struct parser *p, const char *name) {
  */
 wchar_t parser_getchar(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_CHAR);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_CHAR);
 	return v->u.cval;
 }
 
@@ -650,14 +736,398 @@ errr parse_file_quit_not_found(struct parser *p, const char *filename) {
 	return parse_err;
 }
 
+/**
+ * ------------------------------------------------------------------------
+ * Parse caches
+ *
+ * A successful parse of a data file is recorded in a binary cache file in
+ * the user directory, as the hook and converted values of each directive.
+ * Later parses of the same file by the same hooks replay the cache, which
+ * calls the hooks just as parsing the text would, without reading, splitting
+ * or converting any of it.  The cache records the length and a hash of the
+ * text it was made from, and is remade whenever the text file no longer
+ * matches them; it is also ignored if it was made for a different file or a
+ * different set of hooks.  The text file's modification time is recorded
+ * too, so that the text only needs hashing when its size or time changed.
+ * ------------------------------------------------------------------------ */
+
+static const char parse_cache_magic[4] = { 'A', 'P', 'C', '3' };
+
+struct parse_cache_head {
+	char magic[4];
+	u32b signature;	/* Hash of the text file's path and the hooks */
+	u32b text_len;	/* Length of the text file */
+	u32b text_hash;	/* Hash of the text file's contents */
+	u32b text_mtime;	/* Modification time of the text file, or 0 */
+	u32b records;	/* Number of directives */
+	u32b size;		/* Bytes of directive data after the header */
+};
+
+/**
+ * Directive header in a parse cache; the values follow it, in the order of
+ * the hook's specs
+ */
+struct parse_cache_rec {
+	u32b lineno;
+	u32b hook;
+	u32b count;
+};
+
+static u32b parse_cache_hash(u32b hash, const void *data, size_t len)
+{
+	const byte *b = data;
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		hash = ((hash << 5) + hash) + b[i];
+
+	return hash;
+}
+
+/**
+ * Make the signature of a parse cache from the source path and the formats
+ * of the parser's hooks, so it is only used with what it was made from
+ */
+static u32b parse_cache_signature(struct parser *p, const char *path)
+{
+	struct parser_hook *h;
+	u32b hash = 5381;
+	size_t sizes[3] = { sizeof(int), sizeof(wchar_t), sizeof(random_value) };
+
+	hash = parse_cache_hash(hash, sizes, sizeof(sizes));
+	hash = parse_cache_hash(hash, path, strlen(path) + 1);
+	for (h = p->hooks; h; h = h->next) {
+		struct parser_spec *s;
+
+		hash = parse_cache_hash(hash, &h->index, sizeof(h->index));
+		hash = parse_cache_hash(hash, h->dir, strlen(h->dir) + 1);
+		for (s = h->fhead; s; s = s->next) {
+			hash = parse_cache_hash(hash, &s->type, sizeof(s->type));
+			hash = parse_cache_hash(hash, s->name, strlen(s->name) + 1);
+		}
+	}
+
+	return hash;
+}
+
+/**
+ * Find the length and hash of the text a parse cache is made from.  File
+ * times are too coarse to tell whether the text changed since the cache was
+ * written, as the game rewrites some data files (e.g. lore.txt) itself.
+ */
+static bool parse_cache_text(const char *path, u32b *len, u32b *hash)
+{
+	char buf[4096];
+	ang_file *f = file_open(path, MODE_READ, FTYPE_RAW);
+	int n;
+
+	if (!f)
+		return false;
+
+	*len = 0;
+	*hash = 5381;
+	while ((n = file_read(f, buf, sizeof(buf))) > 0) {
+		*len += n;
+		*hash = parse_cache_hash(*hash, buf, n);
+	}
+	file_close(f);
+
+	return n == 0;
+}
+
+/**
+ * Find the size and modification time of the text a parse cache is made
+ * from.  The time is 0, so that the text is always hashed, if it isn't known
+ * or is the current second, as the text could then change again without its
+ * time moving on.
+ */
+static void parse_cache_stamp(const char *path, u32b *size, u32b *mtime)
+{
+	if (!file_stamp(path, size, mtime) || *mtime >= (u32b)time(NULL)) {
+		*size = 0;
+		*mtime = 0;
+	}
+}
+
+/**
+ * Write a parse cache from its header and directive data
+ */
+static void parse_cache_write(const char *cache_path,
+		const struct parse_cache_head *head, const byte *data)
+{
+	ang_file *f = file_open(cache_path, MODE_WRITE, FTYPE_RAW);
+	bool ok;
+
+	if (!f)
+		return;
+
+	ok = file_write(f, (const char *)head, sizeof(*head)) &&
+		file_write(f, (const char *)data, head->size);
+	file_close(f);
+
+	/* Don't leave a broken cache behind */
+	if (!ok)
+		file_delete(cache_path);
+}
+
+/**
+ * Add some bytes to the parse record
+ */
+static void parse_cache_put(struct parser *p, const void *data, size_t len)
+{
+	if (p->rec_len + len > p->rec_size) {
+		while (p->rec_len + len > p->rec_size)
+			p->rec_size *= 2;
+		p->rec = mem_realloc(p->rec, p->rec_size);
+	}
+
+	memcpy(p->rec + p->rec_len, data, len);
+	p->rec_len += len;
+}
+
+/**
+ * Record a directive which has just been parsed, before its hook is run
+ */
+static void parse_cache_record(struct parser *p, struct parser_hook *h)
+{
+	struct parse_cache_rec r;
+	unsigned int i;
+
+	r.lineno = p->lineno;
+	r.hook = h->index;
+	r.count = p->nvalues;
+	parse_cache_put(p, &r, sizeof(r));
+
+	for (i = 0; i < p->nvalues; i++) {
+		struct parser_value *v = &p->values[i];
+		int t = v->spec->type & ~PARSE_T_OPT;
+
+		if (t == PARSE_T_INT) {
+			parse_cache_put(p, &v->u.ival, sizeof(v->u.ival));
+		} else if (t == PARSE_T_UINT) {
+			parse_cache_put(p, &v->u.uval, sizeof(v->u.uval));
+		} else if (t == PARSE_T_CHAR) {
+			parse_cache_put(p, &v->u.cval, sizeof(v->u.cval));
+		} else if (t == PARSE_T_RAND) {
+			parse_cache_put(p, &v->u.rval, sizeof(v->u.rval));
+		} else if (t == PARSE_T_SYM || t == PARSE_T_STR) {
+			u32b len = strlen(v->u.sval) + 1;
+			parse_cache_put(p, &len, sizeof(len));
+			parse_cache_put(p, v->u.sval, len);
+		}
+	}
+
+	p->rec_count++;
+}
+
+/**
+ * Go through the directives of a parse cache, either just checking that
+ * they make sense for the parser or running the hooks on them.
+ */
+static bool parse_cache_run(struct parser *p, const struct parse_cache_head *head,
+		const byte *data, bool run, errr *err)
+{
+	struct parser_hook **hooks = mem_zalloc(p->nhooks * sizeof(*hooks));
+	struct parser_hook *h;
+	const byte *pos = data, *end = data + head->size;
+	u32b i;
+	bool ok = true;
+
+	for (h = p->hooks; h; h = h->next)
+		hooks[h->index] = h;
+
+	for (i = 0; ok && (i < head->records); i++) {
+		struct parse_cache_rec r;
+		struct parser_spec *s;
+		u32b n;
+
+		if ((size_t)(end - pos) < sizeof(r)) {
+			ok = false;
+			break;
+		}
+		memcpy(&r, pos, sizeof(r));
+		pos += sizeof(r);
+		if (r.hook >= p->nhooks) {
+			ok = false;
+			break;
+		}
+		h = hooks[r.hook];
+
+		if (run) {
+			p->nvalues = 0;
+			p->hook = h;
+			p->lineno = r.lineno;
+			p->colno = r.count + 1;
+		}
+
+		for (s = h->fhead, n = 0; n < r.count; s = s->next, n++) {
+			int t;
+			size_t len;
+			struct parser_value *v;
+
+			if (!s) {
+				ok = false;
+				break;
+			}
+
+			/* Find the size of the value */
+			t = s->type & ~PARSE_T_OPT;
+			if (t == PARSE_T_INT) {
+				len = sizeof(int);
+			} else if (t == PARSE_T_UINT) {
+				len = sizeof(unsigned int);
+			} else if (t == PARSE_T_CHAR) {
+				len = sizeof(wchar_t);
+			} else if (t == PARSE_T_RAND) {
+				len = sizeof(random_value);
+			} else {
+				u32b slen;
+
+				if ((size_t)(end - pos) < sizeof(slen)) {
+					ok = false;
+					break;
+				}
+				memcpy(&slen, pos, sizeof(slen));
+				pos += sizeof(slen);
+				if (!slen || (size_t)(end - pos) < slen || pos[slen - 1]) {
+					ok = false;
+					break;
+				}
+				len = slen;
+			}
+			if ((size_t)(end - pos) < len) {
+				ok = false;
+				break;
+			}
+
+			if (run) {
+				v = &p->values[p->nvalues++];
+				v->spec = s;
+
+				if (t == PARSE_T_INT)
+					memcpy(&v->u.ival, pos, len);
+				else if (t == PARSE_T_UINT)
+					memcpy(&v->u.uval, pos, len);
+				else if (t == PARSE_T_CHAR)
+					memcpy(&v->u.cval, pos, len);
+				else if (t == PARSE_T_RAND)
+					memcpy(&v->u.rval, pos, len);
+				else
+					v->u.sval = (char *)pos;
+			}
+
+			pos += len;
+		}
+
+		/* Any values left out must be optional */
+		if (ok && s && !(s->type & PARSE_T_OPT))
+			ok = false;
+
+		/* Run the hook */
+		if (ok && run) {
+			p->error = h->func(p);
+			if (p->error) {
+				*err = p->error;
+				break;
+			}
+		}
+	}
+
+	if (pos != end && !*err)
+		ok = false;
+
+	mem_free(hooks);
+	return ok;
+}
+
+/**
+ * Parse a file from its parse cache, if there is a usable one.  Returns
+ * false, without having run any hooks, if there isn't.
+ */
+static bool parse_cache_load(struct parser *p, const char *path,
+		const char *cache_path, errr *err)
+{
+	struct parse_cache_head head;
+	ang_file *f;
+	byte *data;
+	u32b size, mtime, text_len, text_hash;
+	bool ok, restamp = false;
+
+	f = file_open(cache_path, MODE_READ, FTYPE_RAW);
+	if (!f)
+		return false;
+
+	/* Only if it was made for this file and these hooks */
+	if (file_read(f, (char *)&head, sizeof(head)) != sizeof(head) ||
+			memcmp(head.magic, parse_cache_magic, sizeof(head.magic)) ||
+			head.signature != parse_cache_signature(p, path)) {
+		file_close(f);
+		return false;
+	}
+
+	/* Only if it was made from exactly this text, which only needs checking
+	 * if the text's size or time changed */
+	parse_cache_stamp(path, &size, &mtime);
+	if (!mtime || head.text_mtime != mtime || head.text_len != size) {
+		if (!parse_cache_text(path, &text_len, &text_hash) ||
+				head.text_len != text_len || head.text_hash != text_hash) {
+			file_close(f);
+			return false;
+		}
+
+		/* Save hashing it again next time */
+		restamp = mtime && head.text_len == size;
+		head.text_mtime = mtime;
+	}
+
+	data = mem_alloc(head.size ? head.size : 1);
+	ok = file_read(f, (char *)data, head.size) == (int)head.size;
+	file_close(f);
+
+	/* Check the whole cache before running any hooks on it */
+	*err = 0;
+	if (ok)
+		ok = parse_cache_run(p, &head, data, false, err);
+	if (ok)
+		parse_cache_run(p, &head, data, true, err);
+	if (ok && restamp)
+		parse_cache_write(cache_path, &head, data);
+
+	mem_free(data);
+	return ok;
+}
+
+/**
+ * Write out the parse record as the parse cache for a file
+ */
+static void parse_cache_save(struct parser *p, const char *path,
+		const char *cache_path, u32b text_len, u32b text_hash,
+		u32b text_mtime)
+{
+	struct parse_cache_head head;
+
+	memcpy(head.magic, parse_cache_magic, sizeof(head.magic));
+	head.signature = parse_cache_signature(p, path);
+	head.text_len = text_len;
+	head.text_hash = text_hash;
+	head.text_mtime = text_mtime;
+	head.records = p->rec_count;
+	head.size = p->rec_len;
+
+	parse_cache_write(cache_path, &head, p->rec);
+}
+
 /**
  * The basic file parsing function.
  */
 errr parse_file(struct parser *p, const char *filename) {
 	char path[1024];
+	char cache_path[1024];
 	char buf[1024];
 	ang_file *fh;
 	errr r = 0;
+	u32b size, mtime, text_len, text_hash;
+	bool cache;
 
 	/* The player can put a customised file in the user directory */
 	path_build(path, sizeof(path), ANGBAND_DIR_USER, format("%s.txt",
@@ -675,13 +1145,37 @@ errr parse_file(struct parser *p, const char *filename) {
 	if (!fh)
 		return PARSE_ERROR_NO_FILE_FOUND;
 
-	/* Parse it */
+	/* Use the parse cache if we can */
+	path_build(cache_path, sizeof(cache_path), ANGBAND_DIR_USER,
+			   format("%s.raw", filename));
+	if (parse_cache_load(p, path, cache_path, &r)) {
+		file_close(fh);
+		return r;
+	}
+
+	/* Note the text before parsing it, in case it changes meanwhile */
+	parse_cache_stamp(path, &size, &mtime);
+	cache = parse_cache_text(path, &text_len, &text_hash);
+	if (size != text_len)
+		mtime = 0;
+
+	/* Parse it, recording the directives for a new cache */
+	p->rec_size = 1024;
+	p->rec = mem_alloc(p->rec_size);
+	p->rec_len = 0;
+	p->rec_count = 0;
 	while (file_getl(fh, buf, sizeof(buf))) {
 		r = parser_parse(p, buf);
 		if (r)
 			break;
 	}
 	file_close(fh);
+
+	if (!r && cache)
+		parse_cache_save(p, path, cache_path, text_len, text_hash, mtime);
+	mem_free(p->rec);
+	p->rec = NULL;
+
 	return r;
 }
 
@@ -349,7 +349,7 @@ static void get_ahw(struct player *p)
 /**
  * Creates the player's body
  */
-static void player_embody(struct player *p)
+void player_embody(struct player *p)
 {
 	char buf[80];
 	int i;
@@ -430,6 +430,7 @@ void player_init(struct player *p)
 								   sizeof(struct object *));
 	p->timed = mem_zalloc(TMD_MAX * sizeof(s16b));
 	p->obj_k = mem_zalloc(sizeof(struct object));
+	knowledge_epoch++;
 
 	/* First turn. */
 	turn = 1;
@@ -1122,7 +1123,7 @@ void do_cmd_accept_character(struct command *cmd)
 
 	/* Seed for random artifacts */
 	if (!seed_randart || !OPT(birth_keep_randarts))
-		seed_randart = randint0(0x10000000);
+		seed_randart = randint0(0x10000000) | RANDART_SEED_REPAIR;
 
 	/* Randomize the artifacts if required */
 	if (OPT(birth_randarts))
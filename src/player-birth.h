@@ -22,6 +22,7 @@
 #include "cmd-core.h"
 
 extern void player_init(struct player *p);
+extern void player_embody(struct player *p);
 extern void player_generate(struct player *p, const struct player_race *r,
                             const struct player_class *c, bool old_history);
 extern char *get_history(struct history_chart *h);
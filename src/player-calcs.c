@@ -2437,6 +2437,9 @@ void notice_stuff(struct player *p)
 	if (p->upkeep->notice & PN_IGNORE) {
 		p->upkeep->notice &= ~(PN_IGNORE);
 		ignore_drop();
+
+		/* Mimics of newly ignored objects disappear */
+		update_monsters_later();
 	}
 
 	/* Combine the pack */
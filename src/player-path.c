@@ -34,141 +34,213 @@
  * ------------------------------------------------------------------------ */
 
 /**
- * Maximum size around the player to consider in the pathfinder
+ * Path found by findpath(), as the digits of the directions to move in, from
+ * the last step at index 0 to the next step at pf_result_index
  */
-#define MAX_PF_RADIUS 100
+static char *pf_result;
+static int pf_result_size;
+static int pf_result_index;
+
+static int dir_search[8] = {2,4,6,8,1,3,7,9};
 
 /**
- * Maximum distance to consider in the pathfinder
+ * Grid waiting to be searched from by path_find(), ordered by the length of
+ * the best path through it
  */
-#define MAX_PF_LENGTH 500
-
+struct path_node {
+	int f;		/* Steps to the grid plus estimated steps from it */
+	int h;		/* Estimated steps from the grid to the target */
+	int grid;	/* Grid index, y * width + x */
+};
 
-static int terrain[MAX_PF_RADIUS][MAX_PF_RADIUS];
-static char pf_result[MAX_PF_LENGTH];
-static int pf_result_index;
-
-static int ox, oy, ex, ey;
-static int dir_search[8] = {2,4,6,8,1,3,7,9};
+/**
+ * Whether node a should be searched before node b: shortest estimated path
+ * first, then the one estimated to be nearest the target
+ */
+static bool path_node_before(const struct path_node *a,
+							 const struct path_node *b)
+{
+	return (a->f < b->f) || ((a->f == b->f) && (a->h < b->h));
+}
 
+static void path_heap_push(struct path_node *heap, int *n,
+						   struct path_node node)
+{
+	int i = (*n)++;
+
+	/* Sift up */
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		if (!path_node_before(&node, &heap[parent])) break;
+		heap[i] = heap[parent];
+		i = parent;
+	}
+	heap[i] = node;
+}
 
-static bool is_valid_pf(int y, int x)
+static struct path_node path_heap_pop(struct path_node *heap, int *n)
 {
-	/* Unvisited means allowed */
-	if (!square_isknown(cave, y, x)) return (true);
+	struct path_node top = heap[0];
+	struct path_node last = heap[--(*n)];
+	int i = 0;
+
+	/* Sift the last node down from the top */
+	while (true) {
+		int child = 2 * i + 1;
+		if (child >= *n) break;
+		if ((child + 1 < *n) && path_node_before(&heap[child + 1], &heap[child]))
+			child++;
+		if (!path_node_before(&heap[child], &last)) break;
+		heap[i] = heap[child];
+		i = child;
+	}
+	if (*n) heap[i] = last;
 
-	/* Require open space */
-	return (square_ispassable(cave, y, x));
+	return top;
 }
 
-static void fill_terrain_info(void)
+/**
+ * Whether the player's map lets them path through a grid; grids they don't
+ * know are assumed to be open
+ */
+static bool path_passable(struct chunk *c, int y, int x)
 {
-	int i, j;
+	if (!square_isknown(c, y, x)) return true;
+	return square_ispassable(cave_k, y, x);
+}
 
-	ox = MAX(player->px - MAX_PF_RADIUS / 2, 0);
-	oy = MAX(player->py - MAX_PF_RADIUS / 2, 0);
+/**
+ * Estimate of the steps between two grids; a diagonal step takes a turn,
+ * just like any other, so it is never more than the actual number of steps
+ */
+static int path_estimate(struct loc from, struct loc to)
+{
+	return MAX(ABS(to.x - from.x), ABS(to.y - from.y));
+}
 
-	ex = MIN(player->px + MAX_PF_RADIUS / 2 - 1, cave->width);
-	ey = MIN(player->py + MAX_PF_RADIUS / 2 - 1, cave->height);
+/**
+ * Find a shortest path for the player between two grids of a chunk, by A*
+ * search over the player's map.  The target grid itself is always allowed,
+ * so that the player can head for unknown grids and walls.
+ *
+ * \param c is the chunk, which should be the current level
+ * \param from is the starting grid
+ * \param to is the target grid
+ * \param dirs receives the direction of each step in the path, in order
+ * \param max is the number of steps dirs has room for
+ * \return the number of steps, or -1 if there is no path of at most max steps
+ */
+int path_find(struct chunk *c, struct loc from, struct loc to, byte *dirs,
+			  int max)
+{
+	int grids = c->height * c->width;
+	int *cost = mem_alloc(grids * sizeof(*cost));
+	byte *step = mem_zalloc(grids * sizeof(*step));
+	int heap_size = 64, n = 0;
+	struct path_node *heap = mem_alloc(heap_size * sizeof(*heap));
+	struct path_node node, add;
+	int i, goal = to.y * c->width + to.x, length = -1;
+
+	for (i = 0; i < grids; i++)
+		cost[i] = -1;
+
+	node.grid = from.y * c->width + from.x;
+	node.h = path_estimate(from, to);
+	node.f = node.h;
+	cost[node.grid] = 0;
+	path_heap_push(heap, &n, node);
+
+	while (n) {
+		int k;
+		struct loc grid;
+
+		node = path_heap_pop(heap, &n);
+
+		/* Skip nodes which have since been reached by a shorter path */
+		if (node.f - node.h > cost[node.grid]) continue;
+
+		/* Done */
+		if (node.grid == goal) {
+			length = cost[goal];
+			break;
+		}
 
-	for (i = 0; i < MAX_PF_RADIUS; i++)
-		for (j = 0; j < MAX_PF_RADIUS; j++)
-			terrain[i][j] = -1;
+		grid = loc(node.grid % c->width, node.grid / c->width);
+		for (k = 0; k < 8; k++) {
+			int dir = dir_search[k];
+			struct loc next = loc(grid.x + ddx[dir], grid.y + ddy[dir]);
+			int index = next.y * c->width + next.x;
+
+			if (!square_in_bounds_fully(c, next.y, next.x)) continue;
+			if ((index != goal) && !path_passable(c, next.y, next.x))
+				continue;
+
+			/* Only keep shorter paths */
+			if ((cost[index] >= 0) && (cost[index] <= cost[node.grid] + 1))
+				continue;
+			cost[index] = cost[node.grid] + 1;
+			step[index] = dir;
+
+			if (n == heap_size) {
+				heap_size *= 2;
+				heap = mem_realloc(heap, heap_size * sizeof(*heap));
+			}
+			add.grid = index;
+			add.h = path_estimate(next, to);
+			add.f = cost[index] + add.h;
+			path_heap_push(heap, &n, add);
+		}
+	}
 
-	for (j = oy; j < ey; j++)
-		for (i = ox; i < ex; i++)
-			if (is_valid_pf(j, i))
-				terrain[j - oy][i - ox] = MAX_PF_LENGTH;
+	/* Read the path back from the target */
+	if (length > max)
+		length = -1;
+	if (dirs && (length > 0)) {
+		struct loc grid = to;
+		for (i = length - 1; i >= 0; i--) {
+			int dir = step[grid.y * c->width + grid.x];
+			dirs[i] = dir;
+			grid.x -= ddx[dir];
+			grid.y -= ddy[dir];
+		}
+	}
 
-	terrain[player->py - oy][player->px - ox] = 1;
+	mem_free(heap);
+	mem_free(step);
+	mem_free(cost);
+	return length;
 }
 
-#define MARK_DISTANCE(c,d) if ((c <= MAX_PF_LENGTH) && (c > d)) \
-							{ c = d; try_again = (true); }
-
 bool findpath(int y, int x)
 {
-	int i, j, k;
-	int dir = 10;
-	bool try_again;
-	int cur_distance;
+	int i, n, max = cave->height * cave->width;
+	byte *dirs;
 
-	fill_terrain_info();
-
-	terrain[player->py - oy][player->px - ox] = 1;
-
-	if ((x >= ox) && (x < ex) && (y >= oy) && (y < ey)) {
-		if ((cave->squares[y][x].mon > 0) &&
-			mflag_has(square_monster(cave, y, x)->mflag, MFLAG_VISIBLE))
-			terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-
-		terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-	} else {
+	if (!square_in_bounds_fully(cave, y, x)) {
 		bell("Target out of range.");
 		return (false);
 	}
 
-	/* 
-	 * And now starts the very naive and very 
-	 * inefficient pathfinding algorithm
-	 */
-	do {
-		try_again = false;
-
-		for (j = oy + 1; j < ey - 1; j++) {
-			for (i = ox + 1; i < ex - 1; i++) {
-				cur_distance = terrain[j - oy][i - ox] + 1;
-
-				if ((cur_distance > 0) && (cur_distance < MAX_PF_LENGTH)) {
-					for (dir = 1; dir < 10; dir++) {
-						int next_y, next_x;
-						if (dir == 5)
-							dir++;
-						next_y = j - oy + ddy[dir];
-						next_x = i - ox + ddx[dir];
-
-						MARK_DISTANCE(terrain[next_y][next_x], cur_distance);
-					}
-				}
-			}
-		}
-
-		if (terrain[y - oy][x - ox] < MAX_PF_LENGTH)
-			try_again = false;
-
-	}
-	while (try_again) ;
+	dirs = mem_alloc(max);
+	n = path_find(cave, loc(player->px, player->py), loc(x, y), dirs, max);
 
 	/* Failure */
-	if (terrain[y - oy][x - ox] == MAX_PF_LENGTH) {
+	if (n < 0) {
+		mem_free(dirs);
 		bell("Target space unreachable.");
 		return (false);
 	}
 
-	/* Success */
-	i = x;
-	j = y;
-
-	pf_result_index = 0;
-
-	while ((i != player->px) || (j != player->py)) {
-		cur_distance = terrain[j - oy][i - ox] - 1;
-		for (k = 0; k < 8; k++) {
-			dir = dir_search[k];
-			if (terrain[j - oy + ddy[dir]][i - ox + ddx[dir]] == cur_distance)
-				break;
-		}
-
-		/* Should never happen */
-		assert ((dir != 10) && (dir != 5));
-
-		pf_result[pf_result_index++] = '0' + (char)(10 - dir);
-		i += ddx[dir];
-		j += ddy[dir];
+	/* Success; store the path backwards, for run_step() */
+	if (pf_result_size < max) {
+		pf_result = mem_realloc(pf_result, max);
+		pf_result_size = max;
 	}
+	for (i = 0; i < n; i++)
+		pf_result[n - 1 - i] = '0' + (char)dirs[i];
+	pf_result_index = n - 1;
 
-	pf_result_index--;
-
+	mem_free(dirs);
 	return (true);
 }
 
@@ -20,8 +20,11 @@
 #ifndef PLAYER_PATH_H
 #define PLAYER_PATH_H
 
+#include "cave.h"
 #include "z-type.h"
 
+int path_find(struct chunk *c, struct loc from, struct loc to, byte *dirs,
+			  int max);
 int pathfind_direction_to(struct loc from, struct loc to);
 bool findpath(int y, int x);
 void run_step(int dir);
@@ -73,8 +73,12 @@ wchar_t gf_to_char[GF_MAX][BOLT_MAX];
  *
  * This algorithm is similar to, but slightly different from, the one used
  * by "update_view_los()", and very different from the one used by "los()".
+ *
+ * If c is NULL, walls and monsters are ignored; this is used to build the
+ * precomputed paths below.
  */
-int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2, int flg)
+static int project_path_trace(struct chunk *c, struct loc *gp, int range,
+							  int y1, int x1, int y2, int x2, int flg)
 {
 	int y, x;
 
@@ -152,11 +156,11 @@ int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2, int
 				if ((x == x2) && (y == y2)) break;
 
 			/* Always stop at non-initial wall grids */
-			if ((n > 0) && !square_isprojectable(cave, y, x)) break;
+			if (c && !square_isprojectable(c, y, x)) break;
 
 			/* Sometimes stop at non-initial monsters/players */
 			if (flg & (PROJECT_STOP))
-				if ((n > 0) && (cave->squares[y][x].mon != 0)) break;
+				if (c && c->squares[y][x].mon != 0) break;
 
 			/* Slant */
 			if (m) {
@@ -206,11 +210,11 @@ int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2, int
 				if ((x == x2) && (y == y2)) break;
 
 			/* Always stop at non-initial wall grids */
-			if ((n > 0) && !square_isprojectable(cave, y, x)) break;
+			if (c && !square_isprojectable(c, y, x)) break;
 
 			/* Sometimes stop at non-initial monsters/players */
 			if (flg & (PROJECT_STOP))
-				if ((n > 0) && (cave->squares[y][x].mon != 0)) break;
+				if (c && c->squares[y][x].mon != 0) break;
 
 			/* Slant */
 			if (m) {
@@ -254,11 +258,11 @@ int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2, int
 				if ((x == x2) && (y == y2)) break;
 
 			/* Always stop at non-initial wall grids */
-			if ((n > 0) && !square_isprojectable(cave, y, x)) break;
+			if (c && !square_isprojectable(c, y, x)) break;
 
 			/* Sometimes stop at non-initial monsters/players */
 			if (flg & (PROJECT_STOP))
-				if ((n > 0) && (cave->squares[y][x].mon != 0)) break;
+				if (c && c->squares[y][x].mon != 0) break;
 
 			/* Advance */
 			y += sy;
@@ -271,6 +275,192 @@ int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2, int
 }
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Projection geometry
+ *
+ * The grids a projection passes through depend only on the offset from the
+ * source to the target, and the grids an explosion may reach depend only on
+ * its radius, so both are worked out once at startup for every offset and
+ * radius up to z_info->max_range.  A projection then walks these tables,
+ * checking only the terrain.
+ * ------------------------------------------------------------------------ */
+
+/**
+ * One grid on a precomputed projection path
+ */
+struct proj_step {
+	s16b y, x;		/* Offset from the source */
+	s16b dist;		/* Distance from the source */
+};
+
+/**
+ * One grid in a precomputed explosion area
+ */
+struct proj_grid {
+	s16b y, x;		/* Offset from the centre */
+	byte dist;		/* Distance from the centre */
+	byte angle;		/* Angle from the centre, for arcs */
+};
+
+static int proj_range;					/* Largest offset covered */
+static struct proj_step *proj_steps;	/* Every path, end to end */
+static int *proj_path_start;			/* First step of each path */
+static int *proj_path_len;				/* Number of steps in each path */
+static struct proj_grid **proj_disk;	/* Explosion area by radius */
+static int *proj_disk_len;				/* Number of grids by radius */
+
+/**
+ * Index of the path for a given offset
+ */
+static int proj_path_idx(int dy, int dx)
+{
+	return (dy + proj_range) * (2 * proj_range + 1) + dx + proj_range;
+}
+
+/**
+ * Precompute projection paths and explosion areas
+ */
+static void init_project_geometry(void)
+{
+	int side, dy, dx, r, n = 0;
+	struct loc *path;
+
+	proj_range = z_info->max_range;
+
+	/* Explosions store distance in a byte, and each grid's angle */
+	if (proj_range > 255) {
+		proj_range = 0;
+		return;
+	}
+
+	/* Paths, continuing past the target to the full range */
+	side = 2 * proj_range + 1;
+	path = mem_zalloc((proj_range + 1) * sizeof(*path));
+	proj_steps = mem_zalloc(side * side * proj_range * sizeof(*proj_steps));
+	proj_path_start = mem_zalloc(side * side * sizeof(int));
+	proj_path_len = mem_zalloc(side * side * sizeof(int));
+	for (dy = -proj_range; dy <= proj_range; dy++) {
+		for (dx = -proj_range; dx <= proj_range; dx++) {
+			int i, idx = proj_path_idx(dy, dx);
+			int len = project_path_trace(NULL, path, proj_range, 0, 0, dy, dx,
+										 PROJECT_THRU);
+
+			proj_path_start[idx] = n;
+			proj_path_len[idx] = len;
+			for (i = 0; i < len; i++) {
+				proj_steps[n].y = path[i].y;
+				proj_steps[n].x = path[i].x;
+				proj_steps[n].dist = distance(0, 0, path[i].y, path[i].x);
+				n++;
+			}
+		}
+	}
+	mem_free(path);
+
+	/* Explosion areas, in the order project() has always scanned them */
+	proj_disk = mem_zalloc((proj_range + 1) * sizeof(*proj_disk));
+	proj_disk_len = mem_zalloc((proj_range + 1) * sizeof(int));
+	for (r = 1; r <= proj_range; r++) {
+		proj_disk[r] = mem_zalloc((2 * r + 1) * (2 * r + 1)
+								  * sizeof(struct proj_grid));
+		for (dy = -r; dy <= r; dy++) {
+			for (dx = -r; dx <= r; dx++) {
+				struct proj_grid *grid = &proj_disk[r][proj_disk_len[r]];
+				int dist = distance(0, 0, dy, dx);
+
+				if ((dy == 0) && (dx == 0)) continue;
+				if (dist > r) continue;
+
+				grid->y = dy;
+				grid->x = dx;
+				grid->dist = dist;
+				if ((ABS(dy) <= 20) && (ABS(dx) <= 20))
+					grid->angle = get_angle_to_grid[dy + 20][dx + 20];
+				proj_disk_len[r]++;
+			}
+		}
+	}
+}
+
+/**
+ * Free the projection geometry
+ */
+static void cleanup_project_geometry(void)
+{
+	int r;
+
+	if (proj_disk) {
+		for (r = 1; r <= proj_range; r++)
+			mem_free(proj_disk[r]);
+	}
+	mem_free(proj_disk);
+	mem_free(proj_disk_len);
+	mem_free(proj_steps);
+	mem_free(proj_path_start);
+	mem_free(proj_path_len);
+	proj_disk = NULL;
+	proj_disk_len = NULL;
+	proj_steps = NULL;
+	proj_path_start = NULL;
+	proj_path_len = NULL;
+	proj_range = 0;
+}
+
+struct init_module project_module = {
+	.name = "project",
+	.init = init_project_geometry,
+	.cleanup = cleanup_project_geometry
+};
+
+/**
+ * Determine the path taken by a projection; see project_path_trace() for
+ * the details.  Paths within z_info->max_range use the precomputed steps.
+ */
+int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2,
+				 int flg)
+{
+	int dy = y2 - y1;
+	int dx = x2 - x1;
+	int i, n = 0;
+	const struct proj_step *step;
+
+	/* No path necessary (or allowed) */
+	if ((dy == 0) && (dx == 0)) return (0);
+
+	/* Too far for the precomputed paths */
+	if ((range > proj_range) || (ABS(dy) > proj_range) ||
+		(ABS(dx) > proj_range))
+		return project_path_trace(cave, gp, range, y1, x1, y2, x2, flg);
+
+	i = proj_path_idx(dy, dx);
+	step = &proj_steps[proj_path_start[i]];
+	for (i = proj_path_len[i]; i > 0; i--, step++) {
+		int y = y1 + step->y;
+		int x = x1 + step->x;
+
+		/* Save grid */
+		gp[n++] = loc(x, y);
+
+		/* Hack -- Check maximum range */
+		if (step->dist >= range) break;
+
+		/* Sometimes stop at destination grid */
+		if (!(flg & (PROJECT_THRU)))
+			if ((x == x2) && (y == y2)) break;
+
+		/* Always stop at non-initial wall grids */
+		if (!square_isprojectable(cave, y, x)) break;
+
+		/* Sometimes stop at non-initial monsters/players */
+		if (flg & (PROJECT_STOP))
+			if (cave->squares[y][x].mon != 0) break;
+	}
+
+	return (n);
+}
+
+
 /**
  * Determine if a bolt spell cast from (y1,x1) to (y2,x2) will arrive
  * at the final destination, assuming that no monster gets in the way,
@@ -622,7 +812,7 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg,
 	bool player_sees_grid[256];
 
 	/* Precalculated damage values for each distance. */
-	int *dam_at_dist = malloc((z_info->max_range + 1) * sizeof(*dam_at_dist));
+	int dam_at_dist[256];
 
 	/* Flush any pending output */
 	handle_stuff(player);
@@ -756,6 +946,8 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg,
 	 * All non-beam projections with a positive radius explode in some way.
 	 */
 	else if (rad > 0) {
+		const struct proj_grid *disk = NULL;
+		int disk_len = 0;
 
 		/* Pre-calculate some things for arcs. */
 		if ((flg & (PROJECT_ARC)) && (num_path_grids != 0)) {
@@ -778,6 +970,12 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg,
 			n1x = path_grid[i].x - centre.x + 20;
 		}
 
+		/* Grids which might be in the blast radius */
+		if (MIN(rad, proj_range) > 0) {
+			disk = proj_disk[MIN(rad, proj_range)];
+			disk_len = proj_disk_len[MIN(rad, proj_range)];
+		}
+
 		/* If the explosion centre hasn't been saved already, save it now. */
 		if (num_grids == 0) {
 			blast_grid[num_grids].y = centre.y;
@@ -787,59 +985,80 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg,
 			num_grids++;
 		}
 
-		/* Scan every grid that might possibly be in the blast radius. */
-		for (y = centre.y - rad; y <= centre.y + rad; y++) {
-			for (x = centre.x - rad; x <= centre.x + rad; x++) {
+		/* Scan every grid in the blast radius, in rows from the top. */
+		for (j = 0; j < disk_len; j++) {
+			y = centre.y + disk[j].y;
+			x = centre.x + disk[j].x;
 
-				/* Center grid has already been stored. */
-				if ((y == centre.y) && (x == centre.x))
-					continue;
+			/* Precaution: Stay within area limit. */
+			if (num_grids >= 255)
+				break;
 
-				/* Precaution: Stay within area limit. */
-				if (num_grids >= 255)
-					break;
+			/* Ignore "illegal" locations */
+			if (!square_in_bounds(cave, y, x))
+				continue;
 
-				/* Ignore "illegal" locations */
-				if (!square_in_bounds(cave, y, x))
-					continue;
-
-				/* Most explosions are immediately stopped by walls. If
-				 * PROJECT_THRU is set, walls can be affected if adjacent to
-				 * a grid visible from the explosion centre - note that as of
-				 * Angband 3.5.0 there are no such explosions - NRM.
-				 * All explosions can affect one layer of terrain which is
-				 * passable but not projectable - note that as of Angband 3.5.0
-				 * there is no such terrain - NRM */
-				if ((flg & (PROJECT_THRU)) ||
-					square_ispassable(cave, y, x)){
-					/* If this is a wall grid, ... */
-					if (!square_isprojectable(cave, y, x)) {
-						/* Check neighbors */
-						for (i = 0, k = 0; i < 8; i++) {
-							int yy = y + ddy_ddd[i];
-							int xx = x + ddx_ddd[i];
-
-							if (los(cave, centre.y, centre.x, yy, xx)) {
-								k++;
-								break;
-							}
+			/* Most explosions are immediately stopped by walls. If
+			 * PROJECT_THRU is set, walls can be affected if adjacent to
+			 * a grid visible from the explosion centre - note that as of
+			 * Angband 3.5.0 there are no such explosions - NRM.
+			 * All explosions can affect one layer of terrain which is
+			 * passable but not projectable - note that as of Angband 3.5.0
+			 * there is no such terrain - NRM */
+			if ((flg & (PROJECT_THRU)) ||
+				square_ispassable(cave, y, x)){
+				/* If this is a wall grid, ... */
+				if (!square_isprojectable(cave, y, x)) {
+					/* Check neighbors */
+					for (i = 0, k = 0; i < 8; i++) {
+						int yy = y + ddy_ddd[i];
+						int xx = x + ddx_ddd[i];
+
+						if (los(cave, centre.y, centre.x, yy, xx)) {
+							k++;
+							break;
 						}
-
-						/* Require at least one adjacent grid in LOS. */
-						if (!k)
-							continue;
 					}
-				} else if (!square_isprojectable(cave, y, x))
-					continue;
 
-				/* Must be within maximum distance. */
-				dist_from_centre  = (distance(centre.y, centre.x, y, x));
-				if (dist_from_centre > rad)
-					continue;
+					/* Require at least one adjacent grid in LOS. */
+					if (!k)
+						continue;
+				}
+			} else if (!square_isprojectable(cave, y, x))
+				continue;
+
+			/* Distance is precomputed. */
+			dist_from_centre = disk[j].dist;
 
+			/* If not an arc, accept all grids in LOS. */
+			if (!(flg & (PROJECT_ARC))) {
+				if (los(cave, centre.y, centre.x, y, x)) {
+					blast_grid[num_grids].y = y;
+					blast_grid[num_grids].x = x;
+					distance_to_grid[num_grids] = dist_from_centre;
+					sqinfo_on(cave->squares[y][x].info, SQUARE_PROJECT);
+					num_grids++;
+				}
+			}
 
-				/* If not an arc, accept all grids in LOS. */
-				if (!(flg & (PROJECT_ARC))) {
+			/* Use angle comparison to delineate an arc. */
+			else {
+				int tmp, rotate, diff;
+
+				/* 
+				 * Find the angular difference (/2) between 
+				 * the lines to the end of the arc's center-
+				 * line and to the current grid.
+				 */
+				rotate = 90 - get_angle_to_grid[n1y][n1x];
+				tmp = ABS(disk[j].angle + rotate) % 180;
+				diff = ABS(90 - tmp);
+
+				/* 
+				 * If difference is not greater then that 
+				 * allowed, and the grid is in LOS, accept it.
+				 */
+				if (diff < (degrees_of_arc + 6) / 4) {
 					if (los(cave, centre.y, centre.x, y, x)) {
 						blast_grid[num_grids].y = y;
 						blast_grid[num_grids].x = x;
@@ -848,44 +1067,12 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg,
 						num_grids++;
 					}
 				}
-
-				/* Use angle comparison to delineate an arc. */
-				else {
-					int n2y, n2x, tmp, rotate, diff;
-
-					/* Reorient current grid for table access. */
-					n2y = y - source.y + 20;
-					n2x = x - source.x + 20;
-
-					/* 
-					 * Find the angular difference (/2) between 
-					 * the lines to the end of the arc's center-
-					 * line and to the current grid.
-					 */
-					rotate = 90 - get_angle_to_grid[n1y][n1x];
-					tmp = ABS(get_angle_to_grid[n2y][n2x] + rotate) % 180;
-					diff = ABS(90 - tmp);
-
-					/* 
-					 * If difference is not greater then that 
-					 * allowed, and the grid is in LOS, accept it.
-					 */
-					if (diff < (degrees_of_arc + 6) / 4) {
-						if (los(cave, centre.y, centre.x, y, x)) {
-							blast_grid[num_grids].y = y;
-							blast_grid[num_grids].x = x;
-							distance_to_grid[num_grids] = dist_from_centre;
-							sqinfo_on(cave->squares[y][x].info, SQUARE_PROJECT);
-							num_grids++;
-						}
-					}
-				}
 			}
 		}
 	}
 
 	/* Calculate and store the actual damage at each distance. */
-	for (i = 0; i <= z_info->max_range; i++) {
+	for (i = 0; i <= proj_range; i++) {
 		/* No damage outside the radius. */
 		if (i > rad)
 			dam_temp = 0;
@@ -1069,7 +1256,6 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg,
 	if (player->upkeep->update)
 		update_stuff(player);
 
-	free(dam_at_dist);
 
 	/* Return "something was noticed" */
 	return (notice);
@@ -22,6 +22,7 @@
 #include "init.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "monster.h"
 #include "object.h"
 #include "obj-knowledge.h"
@@ -707,19 +708,45 @@ void wr_stores(void)
 
 
 
+/**
+ * Write one run of a run-length encoding: the length, seven bits at a time
+ * with the top bit set on all but the last byte, then the value
+ */
+static void wr_run(u32b count, byte value)
+{
+	while (count >= 0x80) {
+		wr_byte((byte)((count & 0x7F) | 0x80));
+		count >>= 7;
+	}
+	wr_byte((byte)count);
+	wr_byte(value);
+}
+
+/**
+ * Add the next grid's byte to a run-length encoding, flushing the run so
+ * far if the byte breaks it
+ */
+static void wr_run_add(u32b *count, byte *prev_char, byte value)
+{
+	if (*count && value != *prev_char) {
+		wr_run(*count, *prev_char);
+		*count = 0;
+	}
+	*prev_char = value;
+	(*count)++;
+}
+
 /**
  * Write the current dungeon terrain features and info flags
  *
- * Note that the cost and when fields of c->squares[y][x] are not saved
+ * Note that the flow fields (c->noise and the rest) are not saved
  */
 static void wr_dungeon_aux(struct chunk *c)
 {
 	int y, x;
 	size_t i;
 
-	byte tmp8u;
-
-	byte count;
+	u32b count;
 	byte prev_char;
 
 	/* Dungeon specific info follows */
@@ -733,27 +760,12 @@ static void wr_dungeon_aux(struct chunk *c)
 		prev_char = 0;
 
 		/* Dump for each grid */
-		for (y = 0; y < c->height; y++) {
-			for (x = 0; x < c->width; x++) {
-				/* Extract the important c->squares[y][x].info flags */
-				tmp8u = c->squares[y][x].info[i];
-
-				/* If the run is broken, or too full, flush it */
-				if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
-					wr_byte((byte)count);
-					wr_byte((byte)prev_char);
-					prev_char = tmp8u;
-					count = 1;
-				} else /* Continue the run */
-					count++;
-			}
-		}
+		for (y = 0; y < c->height; y++)
+			for (x = 0; x < c->width; x++)
+				wr_run_add(&count, &prev_char, c->squares[y][x].info[i]);
 
-		/* Flush the data (if any) */
-		if (count) {
-			wr_byte((byte)count);
-			wr_byte((byte)prev_char);
-		}
+		/* Flush the last run */
+		wr_run(count, prev_char);
 	}
 
 	/* Now the terrain */
@@ -761,27 +773,12 @@ static void wr_dungeon_aux(struct chunk *c)
 	prev_char = 0;
 
 	/* Dump for each grid */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			/* Extract a byte */
-			tmp8u = c->squares[y][x].feat;
-
-			/* If the run is broken, or too full, flush it */
-			if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
-				wr_byte((byte)count);
-				wr_byte((byte)prev_char);
-				prev_char = tmp8u;
-				count = 1;
-			} else /* Continue the run */
-				count++;
-		}
-	}
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++)
+			wr_run_add(&count, &prev_char, c->squares[y][x].feat);
 
-	/* Flush the data (if any) */
-	if (count) {
-		wr_byte((byte)count);
-		wr_byte((byte)prev_char);
-	}
+	/* Flush the last run */
+	wr_run(count, prev_char);
 
 	/* Write feeling */
 	wr_byte(c->feeling);
@@ -907,6 +904,9 @@ void wr_objects(void)
 
 void wr_monsters(void)
 {
+	/* Bring monster energy up to date */
+	monster_schedule_flush(cave);
+
 	wr_monsters_aux(cave);
 	wr_monsters_aux(cave_k);
 }
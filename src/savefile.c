@@ -36,6 +36,10 @@
  * ... data ...
  * padding so that block is a multiple of 4 bytes
  *
+ * Savefiles marked with savefile_magic_crc have the CRC-32 of the block data
+ * as the block checksum, and it is checked on loading; older savefiles have
+ * an unchecked sum of the data bytes.
+ *
  * The savefile deosn't contain the version number of that game that saved it;
  * versioning is left at the individual block level.  The current code
  * keeps a list of savefile blocks to save in savers[] below, along with
@@ -62,6 +66,10 @@
  * - and watch the magic happen.
  *
  *
+ * Blocks are written through a fixed size buffer which is flushed to the
+ * file as it fills; the block header is written last, once the size and
+ * checksum of the block are known.
+ *
  * TODO:
  * - wr_ and rd_ should be passed a buffer to work with, rather than using
  *   the rd_ and wr_ functions with a universal buffer
@@ -77,6 +85,7 @@ bool character_saved;
  * Magic bits at beginning of savefile
  */
 static const byte savefile_magic[4] = { 83, 97, 118, 101 };
+static const byte savefile_magic_crc[4] = { 83, 97, 118, 67 };
 static const byte savefile_name[4] = "VNLA";
 
 /* Some useful types */
@@ -86,6 +95,7 @@ struct blockheader {
 	char name[16];
 	u32b version;
 	u32b size;
+	u32b checksum;
 };
 
 struct blockinfo {
@@ -117,11 +127,11 @@ static const struct {
 	{ "player spells", wr_player_spells, 1 },
 	{ "gear", wr_gear, 1 },
 	{ "stores", wr_stores, 1 },
-	{ "dungeon", wr_dungeon, 1 },
+	{ "dungeon", wr_dungeon, 2 },
 	{ "objects", wr_objects, 1 },
 	{ "monsters", wr_monsters, 1 },
 	{ "traps", wr_traps, 1 },
-	{ "chunks", wr_chunks, 1 },
+	{ "chunks", wr_chunks, 2 },
 	{ "history", wr_history, 1 },
 };
 
@@ -144,12 +154,15 @@ static const struct blockinfo loaders[] = {
 	{ "player spells", rd_player_spells, 1 },
 	{ "gear", rd_gear, 1 },	
 	{ "stores", rd_stores, 1 },	
-	{ "dungeon", rd_dungeon, 1 },
+	{ "dungeon", rd_dungeon_1, 1 },
+	{ "dungeon", rd_dungeon, 2 },
 	{ "objects", rd_objects, 1 },	
 	{ "monsters", rd_monsters, 1 },
 	{ "traps", rd_traps, 1 },
-	{ "chunks", rd_chunks, 1 },
+	{ "chunks", rd_chunks_1, 1 },
+	{ "chunks", rd_chunks, 2 },
 	{ "history", rd_history, 1 },
+	{ "", NULL, 0 }
 };
 
 
@@ -159,11 +172,21 @@ static u32b buffer_size;
 static u32b buffer_pos;
 static u32b buffer_check;
 
-#define BUFFER_INITIAL_SIZE		1024
-#define BUFFER_BLOCK_INCREMENT	1024
+/* Block being saved */
+static ang_file *block_file;
+static u32b block_size;
+static bool block_error;
+
+/* Whether the savefile being loaded has CRC-32 block checksums */
+static bool savefile_crc;
+
+#define BUFFER_SAVE_SIZE		4096
 
 #define SAVEFILE_HEAD_SIZE		28
 
+/* Padding after a block of the given size, to a multiple of 4 bytes */
+#define BLOCK_PADDING(size)		((4 - ((size) % 4)) % 4)
+
 
 /**
  * ------------------------------------------------------------------------
@@ -180,26 +203,62 @@ void note(const char *message)
 }
 
 
+/**
+ * Continue a CRC-32 (as used by zlib and PNG) over some more data; start
+ * with 0
+ */
+static u32b savefile_crc32(u32b crc, const byte *data, size_t len)
+{
+	static u32b table[256];
+	size_t i;
+
+	/* Build the table on first use */
+	if (!table[1]) {
+		for (i = 0; i < 256; i++) {
+			u32b c = (u32b)i;
+			int k;
+
+			for (k = 0; k < 8; k++)
+				c = (c & 1) ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+			table[i] = c;
+		}
+	}
+
+	crc = ~crc;
+	for (i = 0; i < len; i++)
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+	return ~crc;
+}
+
+
 /**
  * ------------------------------------------------------------------------
  * Base put/get
  * ------------------------------------------------------------------------ */
 
-static void sf_put(byte v)
+/**
+ * Write out the buffered part of the block being saved
+ */
+static void sf_flush(void)
 {
-	assert(buffer != NULL);
-	assert(buffer_size > 0);
+	buffer_check = savefile_crc32(buffer_check, buffer, buffer_pos);
+	if (!file_write(block_file, (char *)buffer, buffer_pos))
+		block_error = true;
 
-	if (buffer_size == buffer_pos)
-	{
-		buffer_size += BUFFER_BLOCK_INCREMENT;
-		buffer = mem_realloc(buffer, buffer_size);
-	}
+	block_size += buffer_pos;
+	buffer_pos = 0;
+}
 
+static void sf_put(byte v)
+{
+	assert(buffer != NULL);
 	assert(buffer_pos < buffer_size);
 
 	buffer[buffer_pos++] = v;
-	buffer_check += v;
+
+	if (buffer_pos == buffer_size)
+		sf_flush();
 }
 
 static byte sf_get(void)
@@ -207,8 +266,6 @@ static byte sf_get(void)
 	if ((buffer == NULL) || (buffer_size <= 0) || (buffer_pos >= buffer_size))
 		quit("Broken savefile - probably from a development version");
 
-	buffer_check += buffer[buffer_pos];
-
 	return buffer[buffer_pos++];
 }
 
@@ -326,14 +383,23 @@ static bool try_save(ang_file *file)
 	size_t i, pos;
 
 	/* Start off the buffer */
-	buffer = mem_alloc(BUFFER_INITIAL_SIZE);
-	buffer_size = BUFFER_INITIAL_SIZE;
+	buffer = mem_alloc(BUFFER_SAVE_SIZE);
+	buffer_size = BUFFER_SAVE_SIZE;
+	block_file = file;
+	block_error = false;
 
 	for (i = 0; i < N_ELEMENTS(savers); i++) {
+		/* Leave room for the header, which is written once the block is */
+		memset(savefile_head, 0, SAVEFILE_HEAD_SIZE);
+		if (!file_write(file, (char *)savefile_head, SAVEFILE_HEAD_SIZE))
+			block_error = true;
+
 		buffer_pos = 0;
 		buffer_check = 0;
+		block_size = 0;
 
 		savers[i].save();
+		sf_flush();
 
 		/* 16-byte block name */
 		pos = my_strcpy((char *)savefile_head,
@@ -349,22 +415,30 @@ static bool try_save(ang_file *file)
 		savefile_head[pos++] = ((v >> 24) & 0xFF);
 
 		SAVE_U32B(savers[i].version);
-		SAVE_U32B(buffer_pos);
+		SAVE_U32B(block_size);
 		SAVE_U32B(buffer_check);
 
 		assert(pos == SAVEFILE_HEAD_SIZE);
 
-		file_write(file, (char *)savefile_head, SAVEFILE_HEAD_SIZE);
-		file_write(file, (char *)buffer, buffer_pos);
+		/* Go back and fill in the header */
+		if (!file_skip(file, -(int)(block_size + SAVEFILE_HEAD_SIZE)) ||
+				!file_write(file, (char *)savefile_head, SAVEFILE_HEAD_SIZE) ||
+				!file_skip(file, block_size))
+			block_error = true;
 
 		/* pad to 4 byte multiples */
-		if (buffer_pos % 4)
-			file_write(file, "xxx", 4 - (buffer_pos % 4));
+		if (block_size % 4)
+			file_write(file, "xxx", 4 - (block_size % 4));
+
+		if (block_error)
+			break;
 	}
 
 	mem_free(buffer);
+	buffer = NULL;
+	block_file = NULL;
 
-	return true;
+	return !block_error;
 }
 
 /**
@@ -398,7 +472,7 @@ bool savefile_save(const char *path)
 	safe_setuid_drop();
 
 	if (file) {
-		file_write(file, (char *) &savefile_magic, 4);
+		file_write(file, (char *) &savefile_magic_crc, 4);
 		file_write(file, (char *) &savefile_name, 4);
 
 		character_saved = try_save(file);
@@ -452,12 +526,18 @@ bool savefile_save(const char *path)
 static bool check_header(ang_file *f) {
 	byte head[8];
 
-	if (file_read(f, (char *) &head, 8) == 8 &&
-			memcmp(&head[0], savefile_magic, 4) == 0 &&
-			memcmp(&head[4], savefile_name, 4) == 0)
-		return true;
+	if (file_read(f, (char *) &head, 8) != 8 ||
+			memcmp(&head[4], savefile_name, 4) != 0)
+		return false;
 
-	return false;
+	if (memcmp(&head[0], savefile_magic_crc, 4) == 0)
+		savefile_crc = true;
+	else if (memcmp(&head[0], savefile_magic, 4) == 0)
+		savefile_crc = false;
+	else
+		return false;
+
+	return true;
 }
 
 /**
@@ -484,10 +564,7 @@ static errr next_blockheader(ang_file *f, struct blockheader *b) {
 	my_strcpy(b->name, (char *)&savefile_head, sizeof b->name);
 	b->version = RECONSTRUCT_U32B(16);
 	b->size = RECONSTRUCT_U32B(20);
-
-	/* Pad to 4 bytes */
-	if (b->size % 4)
-		b->size += 4 - (b->size % 4);
+	b->checksum = RECONSTRUCT_U32B(24);
 
 	return 0;
 }
@@ -516,20 +593,28 @@ static loader_t find_loader(struct blockheader *b,
  */
 static bool load_block(ang_file *f, struct blockheader *b, loader_t loader)
 {
+	bool ok;
+
 	/* Allocate space for the buffer */
-	buffer = mem_alloc(b->size);
+	buffer = mem_alloc(b->size ? b->size : 1);
 	buffer_pos = 0;
-	buffer_check = 0;
 
 	buffer_size = file_read(f, (char *) buffer, b->size);
-	if (buffer_size != b->size ||
-			loader() != 0) {
-		mem_free(buffer);
-		return false;
+	ok = buffer_size == b->size && file_skip(f, BLOCK_PADDING(b->size));
+
+	/* Check the data before trusting it to the loader */
+	if (ok && savefile_crc &&
+			savefile_crc32(0, buffer, b->size) != b->checksum) {
+		note(format("Savefile block %s fails its checksum.", b->name));
+		ok = false;
 	}
 
+	if (ok && loader() != 0)
+		ok = false;
+
 	mem_free(buffer);
-	return true;
+	buffer = NULL;
+	return ok;
 }
 
 /**
@@ -537,7 +622,7 @@ static bool load_block(ang_file *f, struct blockheader *b, loader_t loader)
  */
 static void skip_block(ang_file *f, struct blockheader *b)
 {
-	file_skip(f, b->size);
+	file_skip(f, b->size + BLOCK_PADDING(b->size));
 }
 
 /**
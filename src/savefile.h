@@ -92,7 +92,9 @@ int rd_player_hp(void);
 int rd_player_spells(void);
 int rd_gear(void);
 int rd_stores(void);
+int rd_dungeon_1(void);
 int rd_dungeon(void);
+int rd_chunks_1(void);
 int rd_chunks(void);
 int rd_objects(void);
 int rd_monsters(void);
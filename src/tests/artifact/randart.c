@@ -0,0 +1,197 @@
+/* artifact/randart */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "cmd-core.h"
+#include "game-world.h"
+#include "init.h"
+#include "obj-randart.h"
+#include "object.h"
+#include "player.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	/* Register a basic error handler */
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Artifact power depends on the player's body, so make a character */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* A repaired set still has enough of every type it is checked for */
+int test_repair(void *state) {
+	u32b seeds[] = { 1, 12345, 0x0FFFFFFF };
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(seeds); i++) {
+		int swords = 0, polearms = 0, blunts = 0, bows = 0;
+		int bodies = 0, shields = 0, cloaks = 0, hats = 0;
+		int gloves = 0, boots = 0;
+		int j;
+
+		eq(do_randart(seeds[i] | RANDART_SEED_REPAIR, true), 0);
+		eq(Rand_quick, false);
+
+		for (j = 0; j < z_info->a_max; j++) {
+			switch (a_info[j].tval) {
+				case TV_SWORD: swords++; break;
+				case TV_POLEARM: polearms++; break;
+				case TV_HAFTED: blunts++; break;
+				case TV_BOW: bows++; break;
+				case TV_SOFT_ARMOR:
+				case TV_HARD_ARMOR:
+				case TV_DRAG_ARMOR: bodies++; break;
+				case TV_SHIELD: shields++; break;
+				case TV_CLOAK: cloaks++; break;
+				case TV_HELM:
+				case TV_CROWN: hats++; break;
+				case TV_GLOVES: gloves++; break;
+				case TV_BOOTS: boots++; break;
+			}
+		}
+
+		require(swords >= 5 && polearms >= 5 && blunts >= 5 && bows >= 4);
+		require(bodies >= 5 && shields >= 4 && cloaks >= 4 && hats >= 4);
+		require(gloves >= 4 && boots >= 4);
+	}
+
+	ok;
+}
+
+static u32b hash_bytes(u32b hash, const void *data, size_t len) {
+	const byte *b = data;
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		hash = ((hash << 5) + hash) + b[i];
+	return hash;
+}
+
+static u32b hash_int(u32b hash, int value) {
+	return hash_bytes(hash, &value, sizeof(value));
+}
+
+static u32b hash_string(u32b hash, const char *str) {
+	return str ? hash_bytes(hash, str, strlen(str) + 1) : hash_int(hash, -1);
+}
+
+/**
+ * Sum up everything the generator decides about the current artifacts
+ */
+static u32b artifact_hash(void) {
+	u32b hash = 5381;
+	int i;
+
+	for (i = 0; i < z_info->a_max; i++) {
+		const struct artifact *art = &a_info[i];
+		const struct brand *b;
+		const struct slay *s;
+
+		hash = hash_string(hash, art->name);
+		hash = hash_int(hash, art->tval);
+		hash = hash_int(hash, art->sval);
+		hash = hash_int(hash, art->to_h);
+		hash = hash_int(hash, art->to_d);
+		hash = hash_int(hash, art->to_a);
+		hash = hash_int(hash, art->ac);
+		hash = hash_int(hash, art->dd);
+		hash = hash_int(hash, art->ds);
+		hash = hash_int(hash, art->weight);
+		hash = hash_int(hash, art->cost);
+		hash = hash_int(hash, art->level);
+		hash = hash_int(hash, art->alloc_prob);
+		hash = hash_int(hash, art->alloc_min);
+		hash = hash_int(hash, art->alloc_max);
+		hash = hash_bytes(hash, art->flags, sizeof(art->flags));
+		hash = hash_bytes(hash, art->modifiers, sizeof(art->modifiers));
+		hash = hash_bytes(hash, art->el_info, sizeof(art->el_info));
+		for (b = art->brands; b; b = b->next) {
+			hash = hash_string(hash, b->name);
+			hash = hash_int(hash, b->multiplier);
+		}
+		for (s = art->slays; s; s = s->next) {
+			hash = hash_string(hash, s->name);
+			hash = hash_int(hash, s->race_flag);
+			hash = hash_int(hash, s->multiplier);
+		}
+		hash = hash_int(hash, art->activation ? art->activation->index : -1);
+	}
+
+	return hash;
+}
+
+/* Repairing the same set from the same seed gives the same artifacts */
+int test_repair_repeat(void *state) {
+	u32b seed = 54321 | RANDART_SEED_REPAIR;
+	u32b mine, theirs = 0;
+	int fds[2], status;
+	pid_t pid;
+
+	/* Make the set in a copy of the game as it is now, and in this one */
+	require(pipe(fds) == 0);
+	pid = fork();
+	require(pid >= 0);
+	if (pid == 0) {
+		u32b hash = 0;
+		int i;
+
+		/* The set should only depend on the seed, not the game's RNG */
+		for (i = 0; i < 100; i++)
+			randint0(100);
+
+		close(fds[0]);
+		if (do_randart(seed, true) == 0)
+			hash = artifact_hash();
+		_exit(write(fds[1], &hash, sizeof(hash)) == sizeof(hash) ? 0 : 1);
+	}
+	close(fds[1]);
+
+	eq(do_randart(seed, true), 0);
+	mine = artifact_hash();
+
+	eq(read(fds[0], &theirs, sizeof(theirs)), sizeof(theirs));
+	close(fds[0]);
+	require(waitpid(pid, &status, 0) == pid);
+	require(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+	require(theirs != 0);
+	eq(mine, theirs);
+	ok;
+}
+
+const char *suite_name = "artifact/randart";
+struct test tests[] = {
+	{ "repair", test_repair },
+	{ "repair_repeat", test_repair_repeat },
+	{ NULL, NULL }
+};
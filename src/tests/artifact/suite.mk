@@ -1 +1,2 @@
-TESTPROGS += artifact/name
+TESTPROGS += artifact/name \
+	artifact/randart
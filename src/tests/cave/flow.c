@@ -0,0 +1,149 @@
+/* cave/flow */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "player.h"
+
+#define FLOW_HGT 24
+#define FLOW_WID 48
+
+static u32b flow_seed = 12345;
+
+/* A small generator of our own, so the tests don't disturb the game's RNG */
+static int flow_rand(int n)
+{
+	flow_seed = flow_seed * 1103515245 + 12345;
+	return (flow_seed >> 16) % n;
+}
+
+int setup_tests(void **state) {
+	read_edit_files();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	return 0;
+}
+
+/* Whether a repaired field has the distances of a fresh one */
+static bool flow_matches(struct chunk *c, struct flow *f, int y, int x)
+{
+	struct flow *fresh = flow_new(c, f->depth);
+	bool same = true;
+	int yy, xx;
+
+	flow_update(c, fresh, y, x);
+	for (yy = 0; yy < c->height; yy++)
+		for (xx = 0; xx < c->width; xx++)
+			if (flow_dist(f, yy, xx) != flow_dist(fresh, yy, xx))
+				same = false;
+	flow_free(c, fresh);
+
+	return same;
+}
+
+/* Every update agrees with a search from scratch */
+int test_repair(void *state) {
+	struct chunk *c = cave_new(FLOW_HGT, FLOW_WID);
+	struct flow *f = flow_new(c, 12);
+	int y = FLOW_HGT / 2, x = FLOW_WID / 2;
+	int i, j, yy, xx;
+
+	for (yy = 0; yy < FLOW_HGT; yy++)
+		for (xx = 0; xx < FLOW_WID; xx++)
+			square_set_feat(c, yy, xx, flow_rand(4) ?
+							FEAT_FLOOR : FEAT_GRANITE);
+
+	flow_update(c, f, y, x);
+	require(flow_matches(c, f, y, x));
+	eq(flow_dist(f, y, x), 0);
+
+	for (i = 0; i < 300; i++) {
+		/* Move the source a step or two, or now and then a long way */
+		if (i % 25 == 0) {
+			y = flow_rand(FLOW_HGT);
+			x = flow_rand(FLOW_WID);
+		} else {
+			y += flow_rand(5) - 2;
+			x += flow_rand(5) - 2;
+			y = MAX(0, MIN(FLOW_HGT - 1, y));
+			x = MAX(0, MIN(FLOW_WID - 1, x));
+		}
+
+		/* Open and close some grids */
+		for (j = flow_rand(4); j > 0; j--) {
+			yy = flow_rand(FLOW_HGT);
+			xx = flow_rand(FLOW_WID);
+			square_set_feat(c, yy, xx, square_isfloor(c, yy, xx) ?
+							FEAT_RUBBLE : FEAT_FLOOR);
+		}
+
+		flow_update(c, f, y, x);
+		require(flow_matches(c, f, y, x));
+	}
+
+	cave_free(c);
+	ok;
+}
+
+/* Grids are listed nearest first, and the noise leaves its scent behind */
+int test_grids_scent(void *state) {
+	struct chunk *c = cave_new(FLOW_HGT, FLOW_WID);
+	struct player p;
+	const struct loc *grids;
+	struct flow *f;
+	int i, n, yy, xx;
+
+	for (yy = 0; yy < FLOW_HGT; yy++)
+		for (xx = 0; xx < FLOW_WID; xx++)
+			square_set_feat(c, yy, xx, FEAT_FLOOR);
+
+	f = cave_near_flow(c, 5, 5, 3);
+	grids = flow_grids(f, &n);
+	eq(n, 25);
+	eq(grids[0].y, 5);
+	eq(grids[0].x, 5);
+	for (i = 1; i < n; i++)
+		require(flow_dist(f, grids[i - 1].y, grids[i - 1].x) <=
+				flow_dist(f, grids[i].y, grids[i].x));
+
+	/* A wall cuts off what lies behind it */
+	for (yy = 0; yy < FLOW_HGT; yy++)
+		square_set_feat(c, yy, 6, FEAT_GRANITE);
+	f = cave_near_flow(c, 5, 5, 3);
+	eq(flow_dist(f, 5, 7), -1);
+	eq(flow_dist(f, 5, 3), 2);
+
+	/* The player's noise, then the scent it leaves as the player moves */
+	memset(&p, 0, sizeof(p));
+	player = &p;
+	player->py = 5;
+	player->px = 5;
+	cave_update_flow(c);
+	eq(cave_scent_cost(c, 5, 3), 2);
+	eq(cave_scent_when(c, 5, 3), 1);
+	player->py = 10;
+	player->px = 30;
+	cave_update_flow(c);
+	eq(flow_dist(c->noise, 5, 3), -1);
+	eq(cave_scent_cost(c, 5, 3), 2);
+	eq(cave_scent_when(c, 5, 3), 1);
+	eq(cave_scent_when(c, 10, 30), 2);
+
+	/* Forgetting the scent keeps the noise */
+	cave_forget_flow(c);
+	eq(cave_scent_when(c, 5, 3), 0);
+	eq(flow_dist(c->noise, 10, 30), 0);
+
+	player = NULL;
+	cave_free(c);
+	ok;
+}
+
+const char *suite_name = "cave/flow";
+struct test tests[] = {
+	{ "repair", test_repair },
+	{ "grids_scent", test_grids_scent },
+	{ NULL, NULL }
+};
@@ -0,0 +1,124 @@
+/* game/desc.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cmd-core.h"
+#include "init.h"
+#include "obj-desc.h"
+#include "obj-knowledge.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "obj-util.h"
+#include "player.h"
+#include "z-quark.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	/* Register a basic error handler */
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Make a character */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Describing the same object twice gives the same answer */
+int test_desc_repeat(void *state) {
+	struct object *obj = player->gear;
+	char first[80], second[80];
+	size_t len;
+
+	notnull(obj);
+	len = object_desc(first, sizeof(first), obj, ODESC_PREFIX | ODESC_FULL);
+	eq(object_desc(second, sizeof(second), obj, ODESC_PREFIX | ODESC_FULL),
+	   len);
+	require(streq(first, second));
+	ok;
+}
+
+/* Changes to the object itself show up in its description */
+int test_desc_object_change(void *state) {
+	struct object *obj = player->gear;
+	char before[80], after[80];
+	quark_t note;
+
+	notnull(obj);
+	note = obj->note;
+	object_desc(before, sizeof(before), obj, ODESC_PREFIX | ODESC_FULL);
+	obj->note = quark_add("cached");
+	object_desc(after, sizeof(after), obj, ODESC_PREFIX | ODESC_FULL);
+	require(strstr(after, "{cached}") != NULL);
+	require(strstr(before, "{cached}") == NULL);
+
+	obj->note = note;
+	object_desc(after, sizeof(after), obj, ODESC_PREFIX | ODESC_FULL);
+	require(streq(before, after));
+	ok;
+}
+
+/* Changes to what the player knows show up in descriptions */
+int test_desc_knowledge_change(void *state) {
+	struct object_kind *kind = NULL;
+	struct object *obj;
+	char before[80], after[80];
+	u32b epoch;
+	int i;
+
+	for (i = 0; i < z_info->k_max; i++)
+		if (k_info[i].flavor && !k_info[i].aware) {
+			kind = &k_info[i];
+			break;
+		}
+	notnull(kind);
+
+	obj = object_new();
+	object_prep(obj, kind, 0, MINIMISE);
+	obj->known = object_new();
+	object_set_base_known(obj);
+
+	object_desc(before, sizeof(before), obj, ODESC_PREFIX | ODESC_FULL);
+	epoch = knowledge_epoch;
+	object_flavor_aware(obj);
+	require(knowledge_epoch != epoch);
+	object_desc(after, sizeof(after), obj, ODESC_PREFIX | ODESC_FULL);
+	require(!streq(before, after));
+
+	object_delete(&obj->known);
+	object_delete(&obj);
+	ok;
+}
+
+const char *suite_name = "game/desc";
+struct test tests[] = {
+	{ "desc_repeat", test_desc_repeat },
+	{ "desc_object_change", test_desc_object_change },
+	{ "desc_knowledge_change", test_desc_knowledge_change },
+	{ NULL, NULL }
+};
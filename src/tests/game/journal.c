@@ -0,0 +1,167 @@
+/* game/journal.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-input.h"
+#include "game-journal.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-move.h"
+#include "player.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+/* Scribble on the answer, then cancel the prompt */
+static bool cancel_string(const char *prompt, char *buf, size_t len) {
+	my_strcpy(buf, "Unwanted", len);
+	return false;
+}
+
+int setup_tests(void **state) {
+	/* Register a basic error handler */
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Make a character and a level, but don't enter it yet */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+	player->upkeep->autosave = false;
+	cave_generate(&cave, player);
+
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	file_delete("Test-journal.jnl");
+	cleanup_angband();
+	return 0;
+}
+
+/* Whether the file at `path` contains `str` */
+static bool file_contains(const char *path, const char *str) {
+	char *buf = NULL;
+	size_t len = 0, size = 0, i;
+	ang_file *f = file_open(path, MODE_READ, FTYPE_RAW);
+	bool found = false;
+	int n;
+
+	if (!f) return false;
+	do {
+		if (len == size) {
+			size = size ? size * 2 : 65536;
+			buf = mem_realloc(buf, size);
+		}
+		n = file_read(f, buf + len, size - len);
+		if (n > 0) len += n;
+	} while (n > 0);
+	file_close(f);
+
+	for (i = 0; !found && i + strlen(str) <= len; i++)
+		if (!memcmp(buf + i, str, strlen(str))) found = true;
+	mem_free(buf);
+
+	return found;
+}
+
+/* A recorded session replays to the same state */
+int test_round_trip(void *state) {
+	struct journal_stats stats;
+	u32b hash;
+	s32b end_turn;
+	int i;
+
+	get_string_hook = cancel_string;
+	require(journal_start("Test-journal"));
+	on_new_level();
+
+	/* Play a little, as play_game() would */
+	for (i = 0; i < 12; i++) {
+		switch (i % 4) {
+			case 0:
+				cmdq_push(CMD_WALK);
+				cmd_set_arg_direction(cmdq_peek(), "direction", 2);
+				break;
+			case 2:
+				cmdq_push(CMD_WALK);
+				cmd_set_arg_direction(cmdq_peek(), "direction", 8);
+				break;
+			default:
+				cmdq_push(CMD_HOLD);
+				break;
+		}
+		journal_step(CMD_GAME);
+		run_game_loop();
+	}
+
+	/* Start an inscription and cancel it at the prompt */
+	cmdq_push(CMD_INSCRIBE);
+	cmd_set_arg_item(cmdq_peek(), "item", player->gear);
+	journal_step(CMD_GAME);
+	run_game_loop();
+
+	hash = journal_state_hash();
+	end_turn = turn;
+	journal_stop();
+
+	/* The cancelled prompt left no answer behind */
+	require(!file_contains("Test-journal.jnl", "Unwanted"));
+
+	/* Play it again from the snapshot */
+	require(journal_replay_start("Test-journal.jnl", true));
+	while (journal_replay_step())
+		run_game_loop();
+	journal_replay_finish(&stats);
+
+	eq(stats.steps, 13);
+	eq(stats.commands, 13);
+	eq(stats.answers, 1);
+	require(stats.checks >= 2);
+	eq(stats.verified, stats.checks);
+	eq(turn, end_turn);
+	eq(journal_state_hash(), hash);
+	ok;
+}
+
+/* Monster energy which hasn't been brought up to date hashes the same */
+int test_hash_settled(void *state) {
+	u32b hash;
+	int i;
+
+	/* Let the monsters fall behind the schedule */
+	for (i = 0; i < 5; i++) {
+		cmdq_push(CMD_HOLD);
+		run_game_loop();
+	}
+
+	hash = journal_state_hash();
+	monster_schedule_flush(cave);
+	eq(journal_state_hash(), hash);
+	ok;
+}
+
+const char *suite_name = "game/journal";
+struct test tests[] = {
+	{ "round_trip", test_round_trip },
+	{ "hash_settled", test_hash_settled },
+	{ NULL, NULL }
+};
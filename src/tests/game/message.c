@@ -0,0 +1,110 @@
+/* game/message.c */
+
+#include "unit-test.h"
+#include "message.h"
+#include "z-color.h"
+#include "z-util.h"
+
+int setup_tests(void **state) {
+	messages_init();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	messages_free();
+	return 0;
+}
+
+int test_empty(void *state) {
+	eq(messages_num(), 0);
+	require(!strcmp(message_str(0), ""));
+	eq(message_count(0), 0);
+	eq(message_color(0), COLOUR_WHITE);
+	ok;
+}
+
+int test_add(void *state) {
+	message_add("first", MSG_GENERIC);
+	message_add("second", MSG_BELL);
+	eq(messages_num(), 2);
+	require(!strcmp(message_str(0), "second"));
+	require(!strcmp(message_str(1), "first"));
+	eq(message_type(0), MSG_BELL);
+	eq(message_type(1), MSG_GENERIC);
+	require(!strcmp(message_str(2), ""));
+	ok;
+}
+
+int test_coalesce(void *state) {
+	message_add("again", MSG_GENERIC);
+	message_add("again", MSG_GENERIC);
+	message_add("again", MSG_GENERIC);
+	eq(messages_num(), 3);
+	eq(message_count(0), 3);
+
+	/* A different type is a different message */
+	message_add("again", MSG_BELL);
+	eq(messages_num(), 4);
+	eq(message_count(0), 1);
+	ok;
+}
+
+int test_wrap(void *state) {
+	char buf[40];
+	int i;
+
+	for (i = 0; i < 5000; i++) {
+		strnfmt(buf, sizeof(buf), "message %d", i);
+		message_add(buf, MSG_GENERIC);
+	}
+
+	eq(messages_num(), 2048);
+	require(!strcmp(message_str(0), "message 4999"));
+	require(!strcmp(message_str(2047), "message 2952"));
+	ok;
+}
+
+int test_long(void *state) {
+	char buf[1024];
+	int i, n;
+
+	/* Long messages push the oldest ones out early */
+	memset(buf, 'x', sizeof(buf) - 1);
+	buf[sizeof(buf) - 1] = '\0';
+	for (i = 0; i < 1000; i++) {
+		buf[0] = 'a' + i % 26;
+		message_add(buf, MSG_GENERIC);
+	}
+
+	n = messages_num();
+	require(n > 0 && n < 1000);
+	for (i = 0; i < n; i++) {
+		eq(strlen(message_str(i)), sizeof(buf) - 1);
+		eq(message_str(i)[0], 'a' + (999 - i) % 26);
+	}
+
+	/* Short messages still fit after them */
+	message_add("short", MSG_GENERIC);
+	require(!strcmp(message_str(0), "short"));
+	eq(message_str(1)[0], 'a' + 999 % 26);
+	ok;
+}
+
+int test_color(void *state) {
+	message_color_define(MSG_BELL, COLOUR_RED);
+	message_add("ding", MSG_BELL);
+	eq(message_color(0), COLOUR_RED);
+	eq(message_type_color(MSG_GENERIC), COLOUR_WHITE);
+	ok;
+}
+
+const char *suite_name = "game/message";
+struct test tests[] = {
+	{ "empty", test_empty },
+	{ "add", test_add },
+	{ "coalesce", test_coalesce },
+	{ "wrap", test_wrap },
+	{ "long", test_long },
+	{ "color", test_color },
+	{ NULL, NULL }
+};
@@ -1,2 +1,5 @@
 TESTPROGS += game/basic \
-	game/mage
+	game/mage \
+	game/message \
+	game/desc \
+	game/journal
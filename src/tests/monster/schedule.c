@@ -0,0 +1,90 @@
+/* monster/schedule */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "mon-util.h"
+#include "player.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	/* Register a basic error handler */
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Make a character and a level */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+	cave_generate(&cave, player);
+	on_new_level();
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* A monster which misses its move keeps its energy for the next turn */
+int test_missed_move(void *state) {
+	struct monster_race *race = lookup_monster("Scruffy little dog");
+	struct monster *mon = NULL;
+	int y, x;
+
+	notnull(race);
+	for (y = player->py - 3; !mon && y <= player->py + 3; y++)
+		for (x = player->px - 3; !mon && x <= player->px + 3; x++) {
+			if (!square_in_bounds_fully(cave, y, x)) continue;
+			if (!square_isempty(cave, y, x)) continue;
+			if (place_new_monster(cave, y, x, race, true, false,
+								  ORIGIN_DROP_SPECIAL))
+				mon = square_monster(cave, y, x);
+		}
+	notnull(mon);
+
+	/* Due to move now */
+	monster_set_energy(cave, mon, z_info->move_energy);
+
+	/* The player leaves before the monster gets to move, on two turns */
+	player->upkeep->generate_level = true;
+	process_monsters(cave, 0);
+	turn++;
+	process_monsters(cave, 0);
+	player->upkeep->generate_level = false;
+
+	monster_schedule_flush(cave);
+	eq(mon->energy, z_info->move_energy);
+	require(!mflag_has(mon->mflag, MFLAG_HANDLED));
+	ok;
+}
+
+const char *suite_name = "monster/schedule";
+struct test tests[] = {
+	{ "missed_move", test_missed_move },
+	{ NULL, NULL }
+};
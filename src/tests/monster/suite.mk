@@ -1 +1 @@
-TESTPROGS += monster/attack monster/monster
+TESTPROGS += monster/attack monster/monster monster/schedule
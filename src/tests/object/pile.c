@@ -90,8 +90,48 @@ int test_obj_piles(void *state) {
 	ok;
 }
 
+/* Testing the object pool behind object_new() */
+int test_obj_pool(void *state) {
+	struct object_pool_stats before, after;
+	struct object *objs[OBJECT_POOL_SLAB + 1];
+	struct object *reused;
+	int i;
+
+	object_pool_get_stats(&before);
+
+	for (i = 0; i <= OBJECT_POOL_SLAB; i++) {
+		objs[i] = object_new();
+		eq(objs[i]->number, 0);
+		null(objs[i]->next);
+		objs[i]->number = 1;
+	}
+
+	object_pool_get_stats(&after);
+	eq(after.in_use, before.in_use + OBJECT_POOL_SLAB + 1);
+	eq(after.allocs, before.allocs + OBJECT_POOL_SLAB + 1);
+	require(after.capacity >= after.in_use);
+	require(after.peak >= after.in_use);
+
+	/* Freed objects are handed out again, cleared */
+	object_delete(&objs[5]);
+	null(objs[5]);
+	reused = object_new();
+	eq(reused->number, 0);
+	objs[5] = reused;
+
+	for (i = 0; i <= OBJECT_POOL_SLAB; i++)
+		object_delete(&objs[i]);
+
+	object_pool_get_stats(&after);
+	eq(after.in_use, before.in_use);
+	eq(after.frees, before.frees + OBJECT_POOL_SLAB + 2);
+
+	ok;
+}
+
 const char *suite_name = "object/pile";
 struct test tests[] = {
 	{ "pile checking", test_obj_piles },
+	{ "pool", test_obj_pool },
 	{ NULL, NULL }
 };
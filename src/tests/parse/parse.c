@@ -2,8 +2,11 @@
 
 #include "unit-test.h"
 
+#include "init.h"
 #include "parser.h"
 
+#include <utime.h>
+
 int setup_tests(void **state) {
 	struct parser *p = parser_new();
 	if (!p)
@@ -394,6 +397,100 @@ int test_char1(void *state) {
 	ok;
 }
 
+static enum parser_error helper_file(struct parser *p) {
+	int *value = parser_priv(p);
+
+	*value = parser_getint(p, "v");
+	return PARSE_ERROR_NONE;
+}
+
+static bool write_file(const char *path, const char *text) {
+	ang_file *f = file_open(path, MODE_WRITE, FTYPE_TEXT);
+	bool written;
+
+	if (!f)
+		return false;
+	written = file_put(f, text);
+	file_close(f);
+	return written;
+}
+
+/* The parse cache notices edits made within the same second as it */
+int test_file_cache(void *state) {
+	struct parser *p = parser_new();
+	int value = 0;
+
+	ANGBAND_DIR_USER = ".";
+	ANGBAND_DIR_GAMEDATA = ".";
+	parser_reg(p, "value int v", helper_file);
+	parser_setpriv(p, &value);
+
+	require(write_file("./test-cache.txt", "value:1\n"));
+	eq(parse_file(p, "test-cache"), 0);
+	eq(value, 1);
+	require(file_exists("./test-cache.raw"));
+
+	/* From the cache */
+	value = 0;
+	eq(parse_file(p, "test-cache"), 0);
+	eq(value, 1);
+
+	/* Same length, same second, different text */
+	require(write_file("./test-cache.txt", "value:2\n"));
+	eq(parse_file(p, "test-cache"), 0);
+	eq(value, 2);
+
+	file_delete("./test-cache.txt");
+	file_delete("./test-cache.raw");
+	ANGBAND_DIR_USER = NULL;
+	ANGBAND_DIR_GAMEDATA = NULL;
+	parser_destroy(p);
+	ok;
+}
+
+/* Set the modification time of a file to an hour ago */
+static bool age_file(const char *path) {
+	struct utimbuf times;
+
+	times.actime = times.modtime = time(NULL) - 3600;
+	return utime(path, &times) == 0;
+}
+
+/* A cache whose text has the same size and time isn't checked any further */
+int test_file_cache_stamp(void *state) {
+	struct parser *p = parser_new();
+	int value = 0;
+
+	ANGBAND_DIR_USER = ".";
+	ANGBAND_DIR_GAMEDATA = ".";
+	parser_reg(p, "value int v", helper_file);
+	parser_setpriv(p, &value);
+
+	require(write_file("./test-stamp.txt", "value:1\n"));
+	require(age_file("./test-stamp.txt"));
+	eq(parse_file(p, "test-stamp"), 0);
+	eq(value, 1);
+
+	/* Changed behind the cache's back, keeping the size and time */
+	require(write_file("./test-stamp.txt", "value:2\n"));
+	require(age_file("./test-stamp.txt"));
+	value = 0;
+	eq(parse_file(p, "test-stamp"), 0);
+	eq(value, 1);
+
+	/* A new time means the text is checked */
+	require(write_file("./test-stamp.txt", "value:3\n"));
+	eq(parse_file(p, "test-stamp"), 0);
+	eq(value, 3);
+
+	file_delete("./test-stamp.txt");
+	file_delete("./test-stamp.raw");
+	ANGBAND_DIR_USER = NULL;
+	ANGBAND_DIR_GAMEDATA = NULL;
+	parser_destroy(p);
+	ok;
+}
+
 const char *suite_name = "parse/parser";
 struct test tests[] = {
 	{ "priv", test_priv },
@@ -437,5 +534,8 @@ struct test tests[] = {
 
 	{ "baddir", test_baddir },
 
+	{ "file_cache", test_file_cache },
+	{ "file_cache_stamp", test_file_cache_stamp },
+
 	{ NULL, NULL }
 };
@@ -1,11 +1,19 @@
 /* player/pathfind */
 
 #include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
 #include "cmd-core.h"
 #include "player-path.h"
 
-NOSETUP
-NOTEARDOWN
+int setup_tests(void **state) {
+	read_edit_files();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	return 0;
+}
 
 int test_dir_to(void *state) {
 	eq(pathfind_direction_to(loc(0,0), loc(0,1)), DIR_S);
@@ -24,8 +32,52 @@ int test_dir_to(void *state) {
 	ok;
 }
 
+int test_path_find(void *state) {
+	byte dirs[200];
+	int y, x;
+
+	cave = cave_new(10, 40);
+	cave_k = cave_new(10, 40);
+
+	/* A wall across the level, with a gap at the bottom */
+	for (y = 0; y < 10; y++) {
+		for (x = 0; x < 40; x++) {
+			int feat = (x == 20 && y < 7) ? FEAT_GRANITE : FEAT_FLOOR;
+			square_set_feat(cave, y, x, feat);
+			square_set_feat(cave_k, y, x, feat);
+		}
+	}
+
+	eq(path_find(cave, loc(2, 2), loc(2, 2), dirs, 200), 0);
+	eq(path_find(cave, loc(2, 2), loc(5, 2), dirs, 200), 3);
+	eq(dirs[0], DIR_E);
+	eq(path_find(cave, loc(2, 2), loc(6, 6), dirs, 200), 4);
+	eq(dirs[0], DIR_SE);
+
+	/* Around the wall */
+	eq(path_find(cave, loc(18, 2), loc(22, 2), dirs, 200), 10);
+	eq(path_find(cave, loc(18, 2), loc(22, 2), dirs, 5), -1);
+
+	/* Walls the player doesn't know about don't get in the way */
+	square_set_feat(cave_k, 3, 20, FEAT_NONE);
+	eq(path_find(cave, loc(18, 2), loc(22, 2), dirs, 200), 4);
+
+	/* Targeting a wall is fine, but walled-off grids can't be reached */
+	eq(path_find(cave, loc(18, 2), loc(20, 2), dirs, 200), 2);
+	for (y = 7; y < 10; y++)
+		square_set_feat(cave_k, y, 20, FEAT_GRANITE);
+	square_set_feat(cave_k, 3, 20, FEAT_GRANITE);
+	eq(path_find(cave, loc(18, 2), loc(22, 2), dirs, 200), -1);
+
+	cave_free(cave_k);
+	cave_free(cave);
+	cave = cave_k = NULL;
+	ok;
+}
+
 const char *suite_name = "player/pathfind";
 struct test tests[] = {
 	{ "dir-to", test_dir_to },
+	{ "path-find", test_path_find },
 	{ NULL, NULL },
 };
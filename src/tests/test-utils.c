@@ -10,6 +10,10 @@
 #include "config.h"
 #include "init.h"
 #include "z-util.h"
+#include "z-virt.h"
+
+#include <stdlib.h>
+#include <unistd.h>
 
 #ifdef SOUND_SDL
 #include "sound.h"
@@ -22,6 +26,32 @@ errr init_sound_sdl(struct sound_hooks *hooks, int argc, char **argv)
 
 #endif
 
+/* The user directory for this run of a test */
+static char test_user_dir[] = "/tmp/angband-test-XXXXXX";
+static bool test_user_made = false;
+static pid_t test_user_owner;
+
+/*
+ * Remove the test user directory and anything written to it
+ */
+static void remove_test_user_dir(void) {
+	char name[1024], path[1024];
+	ang_dir *dir;
+
+	/* Only the process which made it, not a forked child */
+	if (getpid() != test_user_owner) return;
+
+	dir = my_dopen(test_user_dir);
+	if (dir) {
+		while (my_dread(dir, name, sizeof(name))) {
+			path_build(path, sizeof(path), test_user_dir, name);
+			file_delete(path);
+		}
+		my_dclose(dir);
+	}
+	rmdir(test_user_dir);
+}
+
 /*
  * Call this to initialise Angband's file paths before calling init_angband()
  * or similar.
@@ -43,6 +73,23 @@ void set_file_paths(void) {
 		my_strcat(datapath, PATH_SEP, sizeof(datapath));
 
 	init_file_paths(configpath, libpath, datapath);
+
+	/* Keep what the tests write, such as parse caches, out of the real
+	 * user directory */
+	if (!test_user_made && mkdtemp(test_user_dir)) {
+		test_user_made = true;
+		test_user_owner = getpid();
+		atexit(remove_test_user_dir);
+	}
+	if (test_user_made) {
+		char buf[1024];
+
+		string_free(ANGBAND_DIR_USER);
+		ANGBAND_DIR_USER = string_make(test_user_dir);
+		string_free(ANGBAND_DIR_INFO);
+		path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "info");
+		ANGBAND_DIR_INFO = string_make(buf);
+	}
 }
 
 /*
@@ -0,0 +1,178 @@
+/* ui-term/fresh */
+
+#include "unit-test.h"
+#include "ui-term.h"
+
+/* The drawing calls made by the last Term_fresh() */
+struct draw {
+	bool pict;
+	int x, y, n, a;
+	wchar_t s[80];
+};
+
+static struct draw draws[64];
+static int num_draws;
+
+static errr text_test(int x, int y, int n, int a, const wchar_t *s) {
+	struct draw *d = &draws[num_draws++];
+	d->pict = false;
+	d->x = x;
+	d->y = y;
+	d->n = n;
+	d->a = a;
+	memcpy(d->s, s, n * sizeof(wchar_t));
+	d->s[n] = 0;
+	return 0;
+}
+
+static errr pict_test(int x, int y, int n, const int *ap, const wchar_t *cp,
+					  const int *tap, const wchar_t *tcp) {
+	struct draw *d = &draws[num_draws++];
+	d->pict = true;
+	d->x = x;
+	d->y = y;
+	d->n = n;
+	d->a = ap[0];
+	memcpy(d->s, cp, n * sizeof(wchar_t));
+	d->s[n] = 0;
+	return 0;
+}
+
+static errr wipe_test(int x, int y, int n) {
+	return 0;
+}
+
+static term test_term;
+
+static void fresh(void) {
+	num_draws = 0;
+	Term_fresh();
+}
+
+int setup_tests(void **state) {
+	term_init(&test_term, 80, 24, 16);
+	test_term.text_hook = text_test;
+	test_term.pict_hook = pict_test;
+	test_term.wipe_hook = wipe_test;
+	test_term.soft_cursor = true;
+	Term_activate(&test_term);
+	fresh();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	term_nuke(&test_term);
+	return 0;
+}
+
+int test_text(void *state) {
+	Term_putstr(0, 0, -1, 1, "hello");
+	fresh();
+	eq(num_draws, 1);
+	eq(draws[0].x, 0);
+	eq(draws[0].n, 5);
+	eq(draws[0].a, 1);
+	require(!wcscmp(draws[0].s, L"hello"));
+
+	/* Nothing changed, nothing drawn */
+	fresh();
+	eq(num_draws, 0);
+	ok;
+}
+
+int test_bridge(void *state) {
+	Term_putstr(10, 1, -1, 2, "abcd");
+	fresh();
+
+	/* Short unchanged stretches of the same colour are redrawn */
+	Term_putch(10, 1, 2, L'X');
+	Term_putch(13, 1, 2, L'Y');
+	fresh();
+	eq(num_draws, 1);
+	eq(draws[0].x, 10);
+	eq(draws[0].n, 4);
+	require(!wcscmp(draws[0].s, L"XbcY"));
+
+	/* Long ones are not */
+	Term_putch(10, 1, 2, L'a');
+	Term_putch(40, 1, 2, L'Z');
+	fresh();
+	eq(num_draws, 2);
+	eq(draws[0].x, 10);
+	eq(draws[0].n, 1);
+	eq(draws[1].x, 40);
+	eq(draws[1].n, 1);
+
+	/* Nor ones of a different colour */
+	Term_putstr(20, 1, -1, 3, "pq");
+	fresh();
+	Term_putch(19, 1, 2, L'x');
+	Term_putch(22, 1, 2, L'y');
+	fresh();
+	eq(num_draws, 2);
+	ok;
+}
+
+int test_skip(void *state) {
+	/* A change late in a long row is found */
+	Term_putch(75, 2, 4, L'!');
+	fresh();
+	eq(num_draws, 1);
+	eq(draws[0].x, 75);
+	eq(draws[0].y, 2);
+	ok;
+}
+
+int test_pict(void *state) {
+	/* The first refresh draws the terrain everywhere */
+	test_term.always_pict = true;
+	Term_redraw();
+
+	Term_putch(5, 3, 0x81, L'a');
+	Term_putch(7, 3, 0x82, L'b');
+	Term_putch(50, 3, 0x83, L'c');
+	fresh();
+	test_term.always_pict = false;
+
+	eq(num_draws, 2);
+	require(draws[0].pict);
+	eq(draws[0].x, 5);
+	eq(draws[0].n, 3);
+	eq(draws[1].x, 50);
+	eq(draws[1].n, 1);
+	ok;
+}
+
+int test_higher_pict(void *state) {
+	test_term.higher_pict = true;
+	Term_redraw();
+
+	Term_putch(5, 4, 0x81, L'a');
+	Term_putch(6, 4, 0x82, L'b');
+	Term_putch(7, 4, 1, L'c');
+	Term_putch(8, 4, 0x83, L'd');
+	Term_putch(9, 4, 255, L' ');
+	fresh();
+	test_term.higher_pict = false;
+
+	eq(num_draws, 3);
+	require(draws[0].pict);
+	eq(draws[0].x, 5);
+	eq(draws[0].n, 2);
+	require(!draws[1].pict);
+	eq(draws[1].x, 7);
+	require(draws[2].pict);
+	eq(draws[2].x, 8);
+	eq(draws[2].n, 1);
+	ok;
+}
+
+const char *suite_name = "ui-term/fresh";
+struct test tests[] = {
+	{ "text", test_text },
+	{ "bridge", test_bridge },
+	{ "skip", test_skip },
+	{ "pict", test_pict },
+	{ "higher_pict", test_higher_pict },
+	{ NULL, NULL }
+};
@@ -2,6 +2,7 @@
 
 #include "unit-test.h"
 #include "z-quark.h"
+#include "z-util.h"
 
 int setup_tests(void **state) {
 	quarks_init();
@@ -46,9 +47,34 @@ int test_dedup(void *state) {
 	ok;
 }
 
+int test_many(void *state) {
+	quark_t q[200];
+	char buf[20];
+	int i;
+
+	quarks_reserve(50);
+	for (i = 0; i < 200; i++) {
+		strnfmt(buf, sizeof(buf), "2-%d", i);
+		q[i] = quark_add(buf);
+	}
+
+	/* Quarks keep their values as the table grows */
+	for (i = 0; i < 200; i++) {
+		strnfmt(buf, sizeof(buf), "2-%d", i);
+		require(quark_add(buf) == q[i]);
+		require(!strcmp(quark_str(q[i]), buf));
+	}
+
+	require(quark_add("1-foo") == quark_add("1-foo"));
+	require(!strcmp(quark_str(quark_add("0-bar")), "0-bar"));
+
+	ok;
+}
+
 const char *suite_name = "z-quark/quark";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "dedup", test_dedup },
+	{ "many", test_many },
 	{ NULL, NULL }
 };
@@ -0,0 +1,185 @@
+/* z-rand/rand.c */
+
+#include "unit-test.h"
+#include "z-rand.h"
+
+int setup_tests(void **state) {
+	Rand_quick = false;
+	Rand_state_init(42);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	return 0;
+}
+
+static const rand_kind kinds[] = { RAND_WELL, RAND_QUICK, RAND_XOSHIRO };
+
+int test_repeat(void *state) {
+	struct rand_context a, b;
+	size_t k;
+	int i;
+
+	for (k = 0; k < N_ELEMENTS(kinds); k++) {
+		Rand_context_init(&a, kinds[k], 1234);
+		Rand_context_init(&b, kinds[k], 1234);
+		for (i = 0; i < 1000; i++)
+			require(Rand_div_ctx(&a, 100000) == Rand_div_ctx(&b, 100000));
+	}
+
+	ok;
+}
+
+int test_xoshiro(void *state) {
+	struct rand_context ctx;
+
+	/* The first output only depends on the second word of state */
+	Rand_context_init(&ctx, RAND_XOSHIRO, 0);
+	ctx.s[0] = 1;
+	ctx.s[1] = 2;
+	ctx.s[2] = 3;
+	ctx.s[3] = 4;
+	eq(Rand_div_ctx(&ctx, 0x10000000), (11520 >> 4) & 0x0FFFFFFF);
+
+	ok;
+}
+
+int test_split(void *state) {
+	struct rand_context p1, p2, c1, c2;
+	size_t k;
+	int i, same;
+
+	for (k = 0; k < N_ELEMENTS(kinds); k++) {
+		Rand_context_init(&p1, kinds[k], 99);
+		Rand_context_init(&p2, kinds[k], 99);
+		Rand_context_split(&p1, &c1);
+		Rand_context_split(&p2, &c2);
+		eq(c1.kind, kinds[k]);
+
+		/* Splitting is reproducible, and the streams are distinct */
+		same = 0;
+		for (i = 0; i < 100; i++) {
+			u32b r = Rand_div_ctx(&c1, 0x10000000);
+			require(r == Rand_div_ctx(&c2, 0x10000000));
+			require(Rand_div_ctx(&p1, 0x10000000) ==
+					Rand_div_ctx(&p2, 0x10000000));
+			if (r == Rand_div_ctx(&p1, 0x10000000)) same++;
+			Rand_div_ctx(&p2, 0x10000000);
+		}
+		require(same < 5);
+	}
+
+	ok;
+}
+
+/**
+ * Check that two streams neither match nor run through the same numbers
+ * at an offset
+ */
+static bool streams_distinct(const u32b *a, const u32b *b, int n) {
+	int i, same = 0;
+
+	for (i = 0; i < n; i++)
+		if (a[i] == b[i]) same++;
+	if (same >= 5)
+		return false;
+
+	for (i = 0; i + 4 <= n; i++)
+		if (!memcmp(a, &b[i], 4 * sizeof(*a)) ||
+			!memcmp(b, &a[i], 4 * sizeof(*b)))
+			return false;
+
+	return true;
+}
+
+int test_split_nested(void *state) {
+	struct rand_context ctx[4];
+	u32b nums[4][500];
+	size_t k;
+	int i, j;
+
+	for (k = 0; k < N_ELEMENTS(kinds); k++) {
+		/* Parent, two siblings, and a child of the first sibling */
+		Rand_context_init(&ctx[0], kinds[k], 99);
+		Rand_context_split(&ctx[0], &ctx[1]);
+		Rand_context_split(&ctx[0], &ctx[2]);
+		Rand_context_split(&ctx[1], &ctx[3]);
+
+		for (i = 0; i < 4; i++)
+			for (j = 0; j < 500; j++)
+				nums[i][j] = Rand_div_ctx(&ctx[i], 0x10000000);
+
+		for (i = 0; i < 4; i++)
+			for (j = i + 1; j < 4; j++)
+				require(streams_distinct(nums[i], nums[j], 500));
+	}
+
+	ok;
+}
+
+int test_isolated(void *state) {
+	struct rand_context ctx;
+	u32b expect[10];
+	int i;
+
+	/* Numbers from the default context don't depend on other contexts */
+	state_i = 0;
+	Rand_state_init(7);
+	for (i = 0; i < 10; i++)
+		expect[i] = randint0(1000000);
+
+	state_i = 0;
+	Rand_state_init(7);
+	Rand_context_init(&ctx, RAND_WELL, 7);
+	for (i = 0; i < 10; i++) {
+		randint0_ctx(&ctx, 1000000);
+		eq(randint0(1000000), expect[i]);
+	}
+
+	/* Nor do they disturb the simple RNG */
+	Rand_value = 5;
+	Rand_context_init(&ctx, RAND_QUICK, 5);
+	for (i = 0; i < 10; i++)
+		randint0_ctx(&ctx, 1000000);
+	eq(Rand_value, 5);
+
+	/* A NULL context is the default one */
+	state_i = 0;
+	Rand_state_init(7);
+	for (i = 0; i < 10; i++)
+		eq(randint0_ctx(NULL, 1000000), expect[i]);
+
+	ok;
+}
+
+int test_range(void *state) {
+	struct rand_context ctx;
+	size_t k;
+	int i;
+
+	for (k = 0; k < N_ELEMENTS(kinds); k++) {
+		Rand_context_init(&ctx, kinds[k], 5);
+		for (i = 0; i < 10000; i++) {
+			s32b r = randint1_ctx(&ctx, 6);
+			int d = damroll_ctx(&ctx, 3, 4);
+			s16b n = Rand_normal_ctx(&ctx, 50, 10);
+			require(r >= 1 && r <= 6);
+			require(d >= 3 && d <= 12);
+			require(n >= 10 && n <= 90);
+		}
+		eq(Rand_div_ctx(&ctx, 1), 0);
+	}
+
+	ok;
+}
+
+const char *suite_name = "z-rand/rand";
+struct test tests[] = {
+	{ "repeat", test_repeat },
+	{ "xoshiro", test_xoshiro },
+	{ "split", test_split },
+	{ "split_nested", test_split_nested },
+	{ "isolated", test_isolated },
+	{ "range", test_range },
+	{ NULL, NULL }
+};
@@ -25,9 +25,73 @@ int test_realloc(void *state) {
 	return 0;
 }
 
+int test_realloc_move(void *state) {
+	char *p = mem_alloc(8);
+	int i;
+
+	/* Grow through the pools and out the other side, keeping the contents */
+	memcpy(p, "abcdefg", 8);
+	for (i = 16; i <= 4096; i *= 2) {
+		p = mem_realloc(p, i);
+		require(!strcmp(p, "abcdefg"));
+		memset(p + 8, 'x', i - 8);
+	}
+	p = mem_realloc(p, 12);
+	require(!memcmp(p, "abcdefg", 8));
+	mem_free(p);
+	return 0;
+}
+
+#ifndef MEM_NO_POOL
+int test_pool_reuse(void *state) {
+	void *p1 = mem_alloc(24);
+	void *p2;
+
+	mem_free(p1);
+	p2 = mem_alloc(20);
+	ptreq(p1, p2);
+	mem_free(p2);
+	return 0;
+}
+#endif
+
+int test_arena(void *state) {
+	struct mem_arena *a = mem_arena_new(256);
+	char *p1 = mem_arena_alloc(a, 10);
+	char *p2 = mem_arena_alloc(a, 10);
+	char *big = mem_arena_zalloc(a, 1000);
+	char *p3 = mem_arena_alloc(a, 10);
+	int i;
+
+	require(p1 && p2 && big && p3);
+	require(p1 != p2 && p2 != p3);
+	eq(((uintptr_t)p2) % 16, 0);
+	for (i = 0; i < 1000; i++)
+		require(!big[i]);
+	memset(big, 0x5, 1000);
+	memset(p3, 0x6, 10);
+
+	/* Lots of small pieces spill into new blocks */
+	for (i = 0; i < 100; i++)
+		memset(mem_arena_alloc(a, 40), 0x7, 40);
+
+	mem_arena_reset(a);
+	p1 = mem_arena_zalloc(a, 10);
+	require(p1);
+	require(!p1[9]);
+	null(mem_arena_alloc(a, 0));
+	mem_arena_free(a);
+	return 0;
+}
+
 const char *suite_name = "z-virt/mem";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "realloc", test_realloc },
+	{ "realloc_move", test_realloc_move },
+#ifndef MEM_NO_POOL
+	{ "pool_reuse", test_pool_reuse },
+#endif
+	{ "arena", test_arena },
 	{ NULL, NULL }
 };
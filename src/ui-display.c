@@ -41,6 +41,7 @@
 #include "savefile.h"
 #include "target.h"
 #include "ui-birth.h"
+#include "ui-display.h"
 #include "ui-game.h"
 #include "ui-input.h"
 #include "ui-map.h"
@@ -1063,87 +1064,222 @@ static void trace_map_updates(game_event_type type, game_event_data *data,
 #endif
 
 /**
- * Update either a single map grid or a whole map
+ * Map grids waiting to be redrawn, one bit per grid in row-major order.
+ *
+ * Point updates to the map are only noted here; they are drawn together,
+ * once each, when the frame is flushed by map_redraw_flush().
  */
-static void update_maps(game_event_type type, game_event_data *data, void *user)
+static u32b *dirty_grids;
+static int dirty_hgt, dirty_wid, dirty_row_words;
+
+/**
+ * Rows which may contain dirty grids
+ */
+static int dirty_y1, dirty_y2 = -1;
+
+/**
+ * Whole map needs redrawing
+ */
+static bool dirty_map;
+
+/**
+ * Forget all pending map updates
+ */
+static void map_dirty_clear(void)
 {
-	term *t = user;
+	if (dirty_grids && dirty_y1 <= dirty_y2)
+		memset(dirty_grids + dirty_y1 * dirty_row_words, 0,
+			   (dirty_y2 - dirty_y1 + 1) * dirty_row_words * sizeof(u32b));
+	dirty_y1 = dirty_hgt;
+	dirty_y2 = -1;
+	dirty_map = false;
+}
 
-	/* This signals a whole-map redraw. */
-	if (data->point.x == -1 && data->point.y == -1)
-		prt_map();
+/**
+ * Make sure the dirty set matches the size of the current level
+ */
+static bool map_dirty_fits(void)
+{
+	if (!cave) return false;
+	if (dirty_grids && cave->height == dirty_hgt && cave->width == dirty_wid)
+		return true;
 
-	/* Single point to be redrawn */
-	else {
-		struct grid_data g;
-		int a, ta;
-		wchar_t c, tc;
+	mem_free(dirty_grids);
+	dirty_hgt = cave->height;
+	dirty_wid = cave->width;
+	dirty_row_words = (dirty_wid + 31) / 32;
+	dirty_grids = mem_zalloc(dirty_hgt * dirty_row_words * sizeof(u32b));
+	dirty_y1 = dirty_hgt;
+	dirty_y2 = -1;
+	return true;
+}
 
-		int ky, kx;
-		int vy, vx;
+/**
+ * Redraw a single map grid in the given term
+ */
+static void map_draw_grid(term *t, int y, int x)
+{
+	struct grid_data g;
+	int a, ta;
+	wchar_t c, tc;
 
-		/* Location relative to panel */
-		ky = data->point.y - t->offset_y;
-		kx = data->point.x - t->offset_x;
+	int ky, kx;
+	int vy, vx;
 
-		if (t == angband_term[0]) {
-			/* Verify location */
-			if ((ky < 0) || (ky >= SCREEN_HGT)) return;
+	/* Location relative to panel */
+	ky = y - t->offset_y;
+	kx = x - t->offset_x;
 
-			/* Verify location */
-			if ((kx < 0) || (kx >= SCREEN_WID)) return;
+	if (t == angband_term[0]) {
+		/* Verify location */
+		if ((ky < 0) || (ky >= SCREEN_HGT)) return;
 
-			/* Location in window */
-			vy = ky + ROW_MAP;
-			vx = kx + COL_MAP;
+		/* Verify location */
+		if ((kx < 0) || (kx >= SCREEN_WID)) return;
 
-			if (tile_width > 1)
-				vx += (tile_width - 1) * kx;
+		/* Location in window */
+		vy = ky + ROW_MAP;
+		vx = kx + COL_MAP;
 
-			if (tile_height > 1)
-				vy += (tile_height - 1) * ky;
+		if (tile_width > 1)
+			vx += (tile_width - 1) * kx;
 
-		} else {
-			if (tile_width > 1)
-			        kx += (tile_width - 1) * kx;
+		if (tile_height > 1)
+			vy += (tile_height - 1) * ky;
 
-			if (tile_height > 1)
-			        ky += (tile_height - 1) * ky;
+	} else {
+		if (tile_width > 1)
+		        kx += (tile_width - 1) * kx;
 
-			
-			/* Verify location */
-			if ((ky < 0) || (ky >= t->hgt)) return;
-			if ((kx < 0) || (kx >= t->wid)) return;
+		if (tile_height > 1)
+		        ky += (tile_height - 1) * ky;
 
-			/* Location in window */
-			vy = ky;
-			vx = kx;
-		}
+		
+		/* Verify location */
+		if ((ky < 0) || (ky >= t->hgt)) return;
+		if ((kx < 0) || (kx >= t->wid)) return;
+
+		/* Location in window */
+		vy = ky;
+		vx = kx;
+	}
 
 
-		/* Redraw the grid spot */
-		map_info(data->point.y, data->point.x, &g);
-		grid_data_as_text(&g, &a, &c, &ta, &tc);
-		Term_queue_char(t, vx, vy, a, c, ta, tc);
+	/* Redraw the grid spot */
+	map_info(y, x, &g);
+	grid_data_as_text(&g, &a, &c, &ta, &tc);
+	Term_queue_char(t, vx, vy, a, c, ta, tc);
 #ifdef MAP_DEBUG
-		/* Plot 'spot' updates in light green to make them visible */
-		Term_queue_char(t, vx, vy, COLOUR_L_GREEN, c, ta, tc);
+	/* Plot 'spot' updates in light green to make them visible */
+	Term_queue_char(t, vx, vy, COLOUR_L_GREEN, c, ta, tc);
 #endif
 
-		if ((tile_width > 1) || (tile_height > 1))
-			Term_big_queue_char(t, vx, vy, a, c, COLOUR_WHITE, ' ');
+	if ((tile_width > 1) || (tile_height > 1))
+		Term_big_queue_char(t, vx, vy, a, c, COLOUR_WHITE, ' ');
+}
+
+/**
+ * Draw all pending map updates, then refresh the main screen
+ *
+ * Dirty grids are drawn in row-major order into the main term and every
+ * map subwindow; a pending whole-map redraw supersedes them.  The main term
+ * is activated for the drawing, so this may be called with any term active.
+ */
+void map_redraw_flush(void)
+{
+	term *old = Term;
+	term *t = angband_term[0];
+	int y, w, b, j;
+
+	/* Nothing to do */
+	if (!dirty_map && dirty_y1 > dirty_y2) return;
+
+	/* Pending grids belong to a level which has gone away */
+	if (!map_dirty_fits()) {
+		map_dirty_clear();
+		return;
+	}
+
+	Term_activate(t);
+
+	/* A whole-map redraw covers everything */
+	if (dirty_map) {
+		prt_map();
+	} else {
+		for (y = dirty_y1; y <= dirty_y2; y++) {
+			u32b *row = dirty_grids + y * dirty_row_words;
+
+			for (w = 0; w < dirty_row_words; w++) {
+				if (!row[w]) continue;
+
+				for (b = 0; b < 32; b++) {
+					int x = w * 32 + b;
+
+					if (!(row[w] & (1UL << b))) continue;
+
+					/* Main screen, then any map subwindows */
+					map_draw_grid(t, y, x);
+					for (j = 1; j < ANGBAND_TERM_MAX; j++) {
+						if (!angband_term[j]) continue;
+						if (!(window_flag[j] & PW_MAP)) continue;
+						map_draw_grid(angband_term[j], y, x);
+					}
+				}
+			}
+		}
 	}
 
+	map_dirty_clear();
+
 	/* Refresh the main screen unless the map needs to center */
 	if (player->upkeep->update & (PU_PANEL) && OPT(center_player)) {
-		int hgt = (t == angband_term[0]) ? SCREEN_HGT / 2 : t->hgt / 2;
-		int wid = (t == angband_term[0]) ? SCREEN_WID / 2 : t->wid / 2;
+		int hgt = SCREEN_HGT / 2;
+		int wid = SCREEN_WID / 2;
 
-		if (panel_should_modify(t, player->py - hgt, player->px - wid))
+		if (panel_should_modify(t, player->py - hgt, player->px - wid)) {
+			Term_activate(old);
 			return;
+		}
 	}
 
 	Term_fresh();
+	Term_activate(old);
+}
+
+/**
+ * Note that either a single map grid or the whole map needs redrawing
+ *
+ * Repeated updates of a grid within a frame only draw it once.
+ */
+static void update_maps(game_event_type type, game_event_data *data, void *user)
+{
+	int y = data->point.y, x = data->point.x;
+
+	/* This signals a whole-map redraw. */
+	if (x == -1 && y == -1) {
+		map_dirty_fits();
+		map_dirty_clear();
+		dirty_map = true;
+		return;
+	}
+
+	/* Already covered */
+	if (dirty_map) return;
+
+	/* Single point to be redrawn */
+	if (!map_dirty_fits()) return;
+	if ((y < 0) || (y >= dirty_hgt) || (x < 0) || (x >= dirty_wid)) return;
+	dirty_grids[y * dirty_row_words + x / 32] |= 1UL << (x % 32);
+	if (y < dirty_y1) dirty_y1 = y;
+	if (y > dirty_y2) dirty_y2 = y;
+}
+
+/**
+ * Draw the map updates from a set of game updates once it is over
+ */
+static void flush_maps(game_event_type type, game_event_data *data, void *user)
+{
+	map_redraw_flush();
 }
 
 /**
@@ -1208,7 +1344,7 @@ static void do_animation(void)
 		if (!mon || !mon->race || !mflag_has(mon->mflag, MFLAG_VISIBLE))
 			continue;
 		else if (rf_has(mon->race->flags, RF_ATTR_MULTI))
-			attr = randint1(BASIC_COLORS - 1);
+			attr = Rand_simple(BASIC_COLORS - 1) + 1;
 		else if (rf_has(mon->race->flags, RF_ATTR_FLICKER))
 			attr = get_flicker(monster_x_attr[mon->race->ridx]);
 		else
@@ -1307,6 +1443,9 @@ static void display_explosion(game_event_type type, game_event_data *data,
 	struct loc *blast_grid = data->explosion.blast_grid;
 	struct loc centre = data->explosion.centre;
 
+	/* Bring the map up to date first */
+	map_redraw_flush();
+
 	/* Draw the blast from inside out */
 	for (i = 0; i < num_grids; i++) {
 		/* Extract the location */
@@ -1369,6 +1508,7 @@ static void display_explosion(game_event_type type, game_event_data *data,
 		move_cursor_relative(centre.y, centre.x);
 
 		/* Flush the explosion */
+		map_redraw_flush();
 		Term_fresh();
 		if (player->upkeep->redraw)
 			redraw_stuff(player);
@@ -1391,6 +1531,9 @@ static void display_bolt(game_event_type type, game_event_data *data,
 	int y = data->bolt.y;
 	int x = data->bolt.x;
 
+	/* Bring the map up to date first */
+	map_redraw_flush();
+
 	/* Only do visuals if the player can "see" the bolt */
 	if (seen) {
 		byte a;
@@ -1407,6 +1550,7 @@ static void display_bolt(game_event_type type, game_event_data *data,
 			redraw_stuff(player);
 		Term_xtra(TERM_XTRA_DELAY, msec);
 		event_signal_point(EVENT_MAP, x, y);
+		map_redraw_flush();
 		Term_fresh();
 		if (player->upkeep->redraw)
 			redraw_stuff(player);
@@ -1438,6 +1582,9 @@ static void display_missile(game_event_type type, game_event_data *data,
 	int y = data->missile.y;
 	int x = data->missile.x;
 
+	/* Bring the map up to date first */
+	map_redraw_flush();
+
 	/* Only do visuals if the player can "see" the missile */
 	if (seen) {
 		print_rel(object_char(obj), object_attr(obj), y, x);
@@ -1448,6 +1595,7 @@ static void display_missile(game_event_type type, game_event_data *data,
 
 		Term_xtra(TERM_XTRA_DELAY, msec);
 		event_signal_point(EVENT_MAP, x, y);
+		map_redraw_flush();
 
 		Term_fresh();
 		if (player->upkeep->redraw) redraw_stuff(player);
@@ -1818,6 +1966,9 @@ static void flush_subwindow(game_event_type type, game_event_data *data,
 	term *old = Term;
 	term *t = user;
 
+	/* Draw any pending map updates */
+	map_redraw_flush();
+
 	/* Activate */
 	Term_activate(t);
 
@@ -2156,6 +2307,9 @@ static void show_splashscreen(game_event_type type, game_event_data *data,
  * ------------------------------------------------------------------------ */
 static void refresh(game_event_type type, game_event_data *data, void *user)
 {
+	/* Draw any pending map updates */
+	map_redraw_flush();
+
 	/* Place cursor on player/target */
 	if (OPT(show_target) && target_sighted()) {
 		int col, row;
@@ -2414,6 +2568,7 @@ static void ui_enter_world(game_event_type type, game_event_data *data,
 
 	/* Simplest way to keep the map up to date - will do for now */
 	event_add_handler(EVENT_MAP, update_maps, angband_term[0]);
+	event_add_handler(EVENT_END, flush_maps, NULL);
 #ifdef MAP_DEBUG
 	event_add_handler(EVENT_MAP, trace_map_updates, angband_term[0]);
 #endif
@@ -2479,6 +2634,12 @@ static void ui_leave_world(game_event_type type, game_event_data *data,
 
 	/* Simplest way to keep the map up to date - will do for now */
 	event_remove_handler(EVENT_MAP, update_maps, angband_term[0]);
+	event_remove_handler(EVENT_END, flush_maps, NULL);
+	map_dirty_clear();
+	mem_free(dirty_grids);
+	dirty_grids = NULL;
+	dirty_hgt = dirty_wid = dirty_row_words = 0;
+	dirty_y1 = 0;
 #ifdef MAP_DEBUG
 	event_remove_handler(EVENT_MAP, trace_map_updates, angband_term[0]);
 #endif
@@ -31,6 +31,7 @@ byte monster_health_attr(void);
 void cnv_stat(int val, char *out_val, size_t out_len);
 void idle_update(void);
 void toggle_inven_equip(void);
+void map_redraw_flush(void);
 void subwindows_set_flags(u32b *new_flags, size_t n_subwindows);
 void init_display(void);
 
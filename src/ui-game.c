@@ -19,6 +19,7 @@
 
 #include "angband.h"
 #include "cmds.h"
+#include "game-journal.h"
 #include "game-world.h"
 #include "grafmode.h"
 #include "init.h"
@@ -338,6 +339,8 @@ errr textui_get_cmd(cmd_context context)
 void check_for_player_interrupt(game_event_type type, game_event_data *data,
 								void *user)
 {
+	journal_interrupt_check();
+
 	/* Check for "player abort" */
 	if (player->upkeep->running ||
 	    cmd_get_nrepeats() > 0 ||
@@ -350,6 +353,8 @@ void check_for_player_interrupt(game_event_type type, game_event_data *data,
 		/* Check for a key */
 		e = inkey_ex();
 		if (e.type != EVT_NONE) {
+			journal_interrupt();
+
 			/* Flush and disturb */
 			event_signal(EVENT_INPUT_FLUSH);
 			disturb(player, 0);
@@ -410,6 +415,11 @@ static void start_game(bool new_game)
 	/* Enter the level, generating a new one if needed */
 	if (!character_dungeon)
 		cave_generate(&cave, player);
+
+	/* Record the player's input from here, if asked */
+	if (arg_journal && !journal_start(savefile))
+		msg("Could not start the journal.");
+
 	on_new_level();
 }
 
@@ -425,10 +435,16 @@ void play_game(bool new_game)
 	 * command queue is empty and a new player command is needed */
 	while (!player->is_dead && player->upkeep->playing) {
 		pre_turn_refresh();
+		journal_input_begin();
 		cmd_get_hook(CMD_GAME);
+		journal_input_end();
+		journal_step(CMD_GAME);
 		run_game_loop();
 	}
 
+	/* The rest isn't worth replaying */
+	journal_stop();
+
 	/* Close game on death or quitting */
 	close_game();
 }
@@ -229,6 +229,9 @@ ui_event inkey_ex(void)
 
 		/* Hack -- Flush output once when no key ready */
 		if (!done && (0 != Term_inkey(&kk, false, false))) {
+			/* Draw any pending map updates */
+			map_redraw_flush();
+
 			/* Hack -- activate proper term */
 			Term_activate(old);
 
@@ -317,7 +317,7 @@ void monster_list_get_glyphs(monster_list_t *list)
 	int i;
 
 	/* Run through all monsters in the list. */
-	for (i = 0; i < (int)list->entries_size; i++) {
+	for (i = 0; i < list->distinct_entries; i++) {
 		monster_list_entry_t *entry = &list->entries[i];
 		if (entry->race == NULL)
 			continue;
@@ -21,6 +21,7 @@
 #include "cmds.h"
 #include "game-event.h"
 #include "game-input.h"
+#include "game-journal.h"
 #include "hint.h"
 #include "init.h"
 #include "monster.h"
@@ -122,7 +123,7 @@ static const char *random_hint(void)
 	struct hint *v, *r = NULL;
 	int n;
 	for (v = hints, n = 1; v; v = v->next, n++)
-		if (one_in_(n))
+		if (!Rand_simple(n))
 			r = v;
 	return r->hint;
 }
@@ -142,7 +143,7 @@ static void prt_welcome(const struct owner *proprietor)
 
 	int j;
 
-	if (one_in_(2))
+	if (!Rand_simple(2))
 		return;
 
 	/* Get the first name of the store owner (stop before the first space) */
@@ -152,8 +153,8 @@ static void prt_welcome(const struct owner *proprietor)
 	/* Truncate the name */
 	short_name[j] = '\0';
 
-	if (one_in_(3)) {
-		size_t i = randint0(N_ELEMENTS(comment_hint));
+	if (!Rand_simple(3)) {
+		size_t i = Rand_simple(N_ELEMENTS(comment_hint));
 		msg(comment_hint[i], random_hint());
 	} else if (player->lev > 5) {
 		const char *player_name;
@@ -163,9 +164,9 @@ static void prt_welcome(const struct owner *proprietor)
 		i = MIN(i, N_ELEMENTS(comment_welcome) - 1);
 
 		/* Get a title for the character */
-		if ((i % 2) && randint0(2))
+		if ((i % 2) && Rand_simple(2))
 			player_name = player->class->title[(player->lev - 1) / 5];
-		else if (randint0(2))
+		else if (Rand_simple(2))
 			player_name = op_ptr->full_name;
 		else
 			player_name = "valued customer";
@@ -994,7 +995,10 @@ static bool store_menu_handle(struct menu *m, const ui_event *event, int oid)
 				ctx->flags |= (STORE_FRAME_CHANGE | STORE_GOLD_CHANGE);
 
 				/* Let the game handle any core commands (equipping, etc) */
+				journal_input_end();
+				journal_step(CMD_STORE);
 				cmdq_pop(CMD_STORE);
+				journal_input_begin();
 
 				/* Notice and handle stuff */
 				notice_stuff(player);
@@ -1070,7 +1074,10 @@ static bool store_menu_handle(struct menu *m, const ui_event *event, int oid)
 		}
 
 		/* Let the game handle any core commands (equipping, etc) */
+		journal_input_end();
+		journal_step(CMD_STORE);
 		cmdq_pop(CMD_STORE);
+		journal_input_begin();
 
 		if (processed) {
 			event_signal(EVENT_INVENTORY);
@@ -1207,7 +1214,9 @@ void use_store(game_event_type type, game_event_data *data, void *user)
 		prt_welcome(store->owner);
 
 	/* Shopping */
+	journal_input_begin();
 	menu_select(&ctx.menu, 0, false);
+	journal_input_end();
 
 	/* Shopping's done */
 	event_remove_handler(EVENT_STORECHANGED, refresh_stock, &ctx);
@@ -378,29 +378,15 @@ static errr term_win_init(term_win *s, int w, int h)
  */
 static errr term_win_copy(term_win *s, term_win *f, int w, int h)
 {
-	int x, y;
+	int y;
 
 	/* Copy contents */
 	for (y = 0; y < h; y++) {
-		int *f_aa = f->a[y];
-		wchar_t *f_cc = f->c[y];
-
-		int *s_aa = s->a[y];
-		wchar_t *s_cc = s->c[y];
+		memcpy(s->a[y], f->a[y], w * sizeof(int));
+		memcpy(s->c[y], f->c[y], w * sizeof(wchar_t));
 
-		int *f_taa = f->ta[y];
-		wchar_t *f_tcc = f->tc[y];
-
-		int *s_taa = s->ta[y];
-		wchar_t *s_tcc = s->tc[y];
-
-		for (x = 0; x < w; x++) {
-			*s_aa++ = *f_aa++;
-			*s_cc++ = *f_cc++;
-
-			*s_taa++ = *f_taa++;
-			*s_tcc++ = *f_tcc++;
-		}
+		memcpy(s->ta[y], f->ta[y], w * sizeof(int));
+		memcpy(s->tc[y], f->tc[y], w * sizeof(wchar_t));
 	}
 
 	/* Copy cursor */
@@ -654,93 +640,153 @@ void Term_queue_chars(int x, int y, int n, int a, const wchar_t *s)
 
 
 /**
- * Flush a row of the current window (see "Term_fresh")
+ * Number of cells compared at once when looking for changes in a row
+ */
+#define TERM_FRESH_BLOCK 16
+
+/**
+ * Longest stretch of unchanged cells that is redrawn to join the changed cells
+ * either side of it into a single call to a drawing hook
+ */
+#define TERM_FRESH_GAP 4
+
+/**
+ * Find the first cell from x to x2 in row y which differs between the old and
+ * new screens, comparing terrain too if `terrain` is set; return x2 + 1 if
+ * there is none.
  *
- * Display text using "Term_pict()"
+ * Each row of each plane is contiguous, so unchanged stretches are skipped a
+ * block at a time with memcmp().
  */
-static void Term_fresh_row_pict(int y, int x1, int x2)
+static int Term_fresh_next(int y, int x, int x2, bool terrain)
 {
-	int x;
+	const int *old_aa = Term->old->a[y];
+	const wchar_t *old_cc = Term->old->c[y];
+	const int *scr_aa = Term->scr->a[y];
+	const wchar_t *scr_cc = Term->scr->c[y];
+
+	const int *old_taa = Term->old->ta[y];
+	const wchar_t *old_tcc = Term->old->tc[y];
+	const int *scr_taa = Term->scr->ta[y];
+	const wchar_t *scr_tcc = Term->scr->tc[y];
+
+	/* Skip unchanged blocks */
+	while ((x + TERM_FRESH_BLOCK - 1 <= x2) &&
+		   !memcmp(&old_aa[x], &scr_aa[x], TERM_FRESH_BLOCK * sizeof(int)) &&
+		   !memcmp(&old_cc[x], &scr_cc[x], TERM_FRESH_BLOCK * sizeof(wchar_t)) &&
+		   (!terrain ||
+			(!memcmp(&old_taa[x], &scr_taa[x], TERM_FRESH_BLOCK * sizeof(int)) &&
+			 !memcmp(&old_tcc[x], &scr_tcc[x],
+					 TERM_FRESH_BLOCK * sizeof(wchar_t)))))
+		x += TERM_FRESH_BLOCK;
+
+	/* Find the changed cell within the block */
+	for (; x <= x2; x++) {
+		if ((old_aa[x] != scr_aa[x]) || (old_cc[x] != scr_cc[x]))
+			break;
+		if (terrain &&
+			((old_taa[x] != scr_taa[x]) || (old_tcc[x] != scr_tcc[x])))
+			break;
+	}
 
-	int *old_aa = Term->old->a[y];
-	wchar_t *old_cc = Term->old->c[y];
+	return x;
+}
 
-	int *scr_aa = Term->scr->a[y];
-	wchar_t *scr_cc = Term->scr->c[y];
+/**
+ * Check whether the unchanged cells from x to nx - 1 in row y can be drawn as
+ * part of a run of text in colour `fa`
+ */
+static bool Term_fresh_bridge(int y, int x, int nx, int fa)
+{
+	const int *scr_aa = Term->scr->a[y];
 
-	int *old_taa = Term->old->ta[y];
-	wchar_t *old_tcc = Term->old->tc[y];
+	if (nx - x > TERM_FRESH_GAP) return false;
 
-	int *scr_taa = Term->scr->ta[y];
-	wchar_t *scr_tcc = Term->scr->tc[y];
+	for (; x < nx; x++)
+		if (scr_aa[x] != fa) return false;
+
+	return true;
+}
+
+/**
+ * Draw a run of `fn` characters of colour `fa` from (fx, y), or erase it if
+ * the colour is black
+ */
+static void Term_fresh_text(int fx, int y, int fn, int fa)
+{
+	if (fa || Term->always_text)
+		(void)((*Term->text_hook)(fx, y, fn, fa, &Term->scr->c[y][fx]));
+	else
+		(void)((*Term->wipe_hook)(fx, y, fn));
+}
+
+/**
+ * Draw a run of `fn` attr/char pairs from (fx, y) using "Term_pict()"
+ */
+static void Term_fresh_pict(int fx, int y, int fn)
+{
+	term_win *scr = Term->scr;
 
-	int ota;
-	wchar_t otc;
+	(void)((*Term->pict_hook)(fx, y, fn, &scr->a[y][fx], &scr->c[y][fx],
+							  &scr->ta[y][fx], &scr->tc[y][fx]));
+}
 
-	int nta;
-	wchar_t ntc;
+/**
+ * Copy cell x of row y from the new screen to the old one
+ */
+static void Term_fresh_save(int y, int x)
+{
+	term_win *old = Term->old;
+	term_win *scr = Term->scr;
 
+	old->a[y][x] = scr->a[y][x];
+	old->c[y][x] = scr->c[y][x];
+	old->ta[y][x] = scr->ta[y][x];
+	old->tc[y][x] = scr->tc[y][x];
+}
+
+/**
+ * Flush a row of the current window (see "Term_fresh")
+ *
+ * Display text using "Term_pict()"
+ */
+static void Term_fresh_row_pict(int y, int x1, int x2)
+{
 	/* Pending length */
 	int fn = 0;
 
 	/* Pending start */
 	int fx = 0;
 
-	int oa;
-	wchar_t oc;
-
-	int na;
-	wchar_t nc;
-
 	/* Scan "modified" columns */
-	for (x = x1; x <= x2; x++) {
-		/* See what is currently here */
-		oa = old_aa[x];
-		oc = old_cc[x];
+	int x = Term_fresh_next(y, x1, x2, true);
+	while (x <= x2) {
+		int nx;
 
-		/* See what is desired there */
-		na = scr_aa[x];
-		nc = scr_cc[x];
-
-		ota = old_taa[x];
-		otc = old_tcc[x];
+		/* Save new contents */
+		Term_fresh_save(y, x);
 
-		nta = scr_taa[x];
-		ntc = scr_tcc[x];
+		/* Restart and Advance */
+		if (fn++ == 0) fx = x;
 
-		/* Handle unchanged grids */
-		if ((na == oa) && (nc == oc) && (nta == ota) && (ntc == otc)) {
-			/* Flush */
-			if (fn) {
+		/* Find the next change, redrawing short unchanged stretches */
+		nx = Term_fresh_next(y, x + 1, x2, true);
+		if (nx > x + 1) {
+			if ((nx <= x2) && (nx - x - 1 <= TERM_FRESH_GAP)) {
+				fn += nx - x - 1;
+			} else {
 				/* Draw pending attr/char pairs */
-				(void)((*Term->pict_hook)(fx, y, fn, &scr_aa[fx], &scr_cc[fx],
-										  &scr_taa[fx], &scr_tcc[fx]));
+				Term_fresh_pict(fx, y, fn);
 
 				/* Forget */
 				fn = 0;
 			}
-
-			/* Skip */
-			continue;
 		}
-
-		/* Save new contents */
-		old_aa[x] = na;
-		old_cc[x] = nc;
-
-		old_taa[x] = nta;
-		old_tcc[x] = ntc;
-
-		/* Restart and Advance */
-		if (fn++ == 0) fx = x;
+		x = nx;
 	}
 
 	/* Flush */
-	if (fn) {
-		/* Draw pending attr/char pairs */
-		(void)((*Term->pict_hook)(fx, y, fn, &scr_aa[fx], &scr_cc[fx],
-								  &scr_taa[fx], &scr_tcc[fx]));
-	}
+	if (fn) Term_fresh_pict(fx, y, fn);
 }
 
 
@@ -753,135 +799,79 @@ static void Term_fresh_row_pict(int y, int x1, int x2)
  */
 static void Term_fresh_row_both(int y, int x1, int x2)
 {
-	int x;
-
-	int *old_aa = Term->old->a[y];
-	wchar_t *old_cc = Term->old->c[y];
-	int *scr_aa = Term->scr->a[y];
-	wchar_t *scr_cc = Term->scr->c[y];
-
-	int *old_taa = Term->old->ta[y];
-	wchar_t *old_tcc = Term->old->tc[y];
-	int *scr_taa = Term->scr->ta[y];
-	wchar_t *scr_tcc = Term->scr->tc[y];
+	const int *scr_aa = Term->scr->a[y];
 
-	int ota;
-	wchar_t otc;
-	int nta;
-	wchar_t ntc;
-
-	/* The "always_text" flag */
-	int always_text = Term->always_text;
-
-	/* Pending length */
+	/* Pending text length, start and attr */
 	int fn = 0;
-
-	/* Pending start */
 	int fx = 0;
-
-	/* Pending attr */
 	int fa = Term->attr_blank;
 
-	int oa;
-	wchar_t oc;
-
-	int na;
-	wchar_t nc;
+	/* Pending high-bit length and start */
+	int pn = 0;
+	int px = 0;
 
 	/* Scan "modified" columns */
-	for (x = x1; x <= x2; x++) {
-		/* See what is currently here */
-		oa = old_aa[x];
-		oc = old_cc[x];
-
-		/* See what is desired there */
-		na = scr_aa[x];
-		nc = scr_cc[x];
-
-		ota = old_taa[x];
-		otc = old_tcc[x];
-
-		nta = scr_taa[x];
-		ntc = scr_tcc[x];
-
-		/* Handle unchanged grids */
-		if ((na == oa) && (nc == oc) && (nta == ota) && (ntc == otc)) {
-			/* Flush */
-			if (fn) {
-				/* Draw pending chars (normal or black) */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
-
-				/* Forget */
-				fn = 0;
-			}
-
-			/* Skip */
-			continue;
-		}
+	int x = Term_fresh_next(y, x1, x2, true);
+	while (x <= x2) {
+		int na = scr_aa[x];
+		int nx;
 
 		/* Save new contents */
-		old_aa[x] = na;
-		old_cc[x] = nc;
-		old_taa[x] = nta;
-		old_tcc[x] = ntc;
+		Term_fresh_save(y, x);
 
 		/* Handle high-bit attr/chars */
-		if ((na & 0x80)) {
+		if (na & 0x80) {
 			/* Flush */
 			if (fn) {
-				/* Draw pending chars (normal or black) */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
-
-				/* Forget */
+				Term_fresh_text(fx, y, fn, fa);
 				fn = 0;
 			}
 
 			/* 2nd byte of bigtile */
-			if (na == 255) continue;
-
-			/* Hack -- Draw the special attr/char pair */
-			(void)((*Term->pict_hook)(x, y, 1, &na, &nc, &nta, &ntc));
-
-			/* Skip */
-			continue;
-		}
-
-		/* Notice new color */
-		if (fa != na) {
+			if (na == 255) {
+				if (pn) {
+					Term_fresh_pict(px, y, pn);
+					pn = 0;
+				}
+			} else if (pn++ == 0) {
+				px = x;
+			}
+		} else {
 			/* Flush */
-			if (fn) {
-				/* Draw the pending chars, erase leading spaces */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
+			if (pn) {
+				Term_fresh_pict(px, y, pn);
+				pn = 0;
+			}
 
-				/* Forget */
+			/* Notice new color */
+			if ((fa != na) && fn) {
+				/* Draw the pending chars, erase leading spaces */
+				Term_fresh_text(fx, y, fn, fa);
 				fn = 0;
 			}
-
-			/* Save the new color */
 			fa = na;
+
+			/* Restart and Advance */
+			if (fn++ == 0) fx = x;
 		}
 
-		/* Restart and Advance */
-		if (fn++ == 0) fx = x;
+		/* Find the next change, redrawing short unchanged stretches of text */
+		nx = Term_fresh_next(y, x + 1, x2, true);
+		if (nx > x + 1) {
+			if (fn && (nx <= x2) && Term_fresh_bridge(y, x + 1, nx, fa)) {
+				fn += nx - x - 1;
+			} else {
+				if (fn) Term_fresh_text(fx, y, fn, fa);
+				if (pn) Term_fresh_pict(px, y, pn);
+				fn = pn = 0;
+			}
+		}
+		x = nx;
 	}
 
 	/* Flush */
-	if (fn) {
-		/* Draw pending chars (normal or black) */
-		if (fa || always_text)
-			(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-		else
-			(void)((*Term->wipe_hook)(fx, y, fn));
-	}
+	if (fn) Term_fresh_text(fx, y, fn, fa);
+	if (pn) Term_fresh_pict(px, y, pn);
 }
 
 
@@ -892,17 +882,12 @@ static void Term_fresh_row_both(int y, int x1, int x2)
  */
 static void Term_fresh_row_text(int y, int x1, int x2)
 {
-	int x;
-
 	int *old_aa = Term->old->a[y];
 	wchar_t *old_cc = Term->old->c[y];
 
 	int *scr_aa = Term->scr->a[y];
 	wchar_t *scr_cc = Term->scr->c[y];
 
-	/* The "always_text" flag */
-	int always_text = Term->always_text;
-
 	/* Pending length */
 	int fn = 0;
 
@@ -912,56 +897,21 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 	/* Pending attr */
 	int fa = Term->attr_blank;
 
-	int oa;
-	wchar_t oc;
-
-	int na;
-	wchar_t nc;
-
-
 	/* Scan "modified" columns */
-	for (x = x1; x <= x2; x++) {
-		/* See what is currently here */
-		oa = old_aa[x];
-		oc = old_cc[x];
-
-		/* See what is desired there */
-		na = scr_aa[x];
-		nc = scr_cc[x];
-
-		/* Handle unchanged grids */
-		if ((na == oa) && (nc == oc)) {
-			/* Flush */
-			if (fn) 	{
-				/* Draw pending chars (normal or black) */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
-
-				/* Forget */
-				fn = 0;
-			}
-
-			/* Skip */
-			continue;
-		}
+	int x = Term_fresh_next(y, x1, x2, false);
+	while (x <= x2) {
+		int na = scr_aa[x];
+		int nx;
 
 		/* Save new contents */
 		old_aa[x] = na;
-		old_cc[x] = nc;
+		old_cc[x] = scr_cc[x];
 
 		/* Notice new color */
 		if (fa != na) {
-			/* Flush */
+			/* Draw the pending chars, erase leading spaces */
 			if (fn) {
-				/* Draw the pending chars, erase leading spaces */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
-
-				/* Forget */
+				Term_fresh_text(fx, y, fn, fa);
 				fn = 0;
 			}
 
@@ -971,16 +921,25 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 
 		/* Restart and Advance */
 		if (fn++ == 0) fx = x;
+
+		/* Find the next change, redrawing short unchanged stretches */
+		nx = Term_fresh_next(y, x + 1, x2, false);
+		if (nx > x + 1) {
+			if ((nx <= x2) && Term_fresh_bridge(y, x + 1, nx, fa)) {
+				fn += nx - x - 1;
+			} else {
+				/* Draw pending chars (normal or black) */
+				Term_fresh_text(fx, y, fn, fa);
+
+				/* Forget */
+				fn = 0;
+			}
+		}
+		x = nx;
 	}
 
 	/* Flush */
-	if (fn) {
-		/* Draw pending chars (normal or black) */
-		if (fa || always_text)
-			(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-		else
-			(void)((*Term->wipe_hook)(fx, y, fn));
-	}
+	if (fn) Term_fresh_text(fx, y, fn, fa);
 }
 
 /**
@@ -1531,7 +1531,7 @@ static void clearing_stats(void)
 		/* Do randart regen */
 		if ((regen) && (iter<tries)) {
 			/* Get seed */
-			int seed_randart = randint0(0x10000000);
+			u32b seed_randart = randint0(0x10000000) | RANDART_SEED_REPAIR;
 
 			/* regen randarts */
 			do_randart(seed_randart,true);
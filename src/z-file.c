@@ -360,6 +360,24 @@ bool file_newer(const char *first, const char *second)
 #endif /* !HAVE_STAT */
 }
 
+/**
+ * Find the size and modification time of a file
+ */
+bool file_stamp(const char *fname, u32b *size, u32b *mtime)
+{
+#ifdef HAVE_STAT
+	struct stat st;
+
+	if (stat(fname, &st) != 0) return false;
+
+	*size = (u32b)st.st_size;
+	*mtime = (u32b)st.st_mtime;
+	return true;
+#else /* HAVE_STAT */
+	return false;
+#endif /* !HAVE_STAT */
+}
+
 
 
 
@@ -437,6 +455,14 @@ bool file_close(ang_file *f)
 	return true;
 }
 
+/**
+ * Push anything buffered for file handle 'f' out to the file.
+ */
+bool file_flush(ang_file *f)
+{
+	return fflush(f->fh) == 0;
+}
+
 
 
 /** Locking functions **/
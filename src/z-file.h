@@ -131,6 +131,13 @@ bool file_move(const char *fname, const char *newname);
  */
 bool file_newer(const char *first, const char *second);
 
+/**
+ * Finds the size and modification time of `fname`.
+ *
+ * Returns true if successful, false otherwise.
+ */
+bool file_stamp(const char *fname, u32b *size, u32b *mtime);
+
 
 /** File handle creation **/
 
@@ -165,6 +172,13 @@ extern void (*file_open_hook)(const char *path, file_type ftype);
  */
 bool file_close(ang_file *f);
 
+/**
+ * Write out anything buffered for `f`, so that it survives a crash.
+ *
+ * Returns true if successful, false otherwise.
+ */
+bool file_flush(ang_file *f);
+
 
 /** File locking **/
 
@@ -17,6 +17,7 @@
  *    and not for profit purposes provided that this copyright and statement
  *    are included in all such copies.  Other copyrights may also apply.
  */
+#include "z-util.h"
 #include "z-virt.h"
 #include "z-quark.h"
 #include "init.h"
@@ -25,24 +26,74 @@ static char **quarks;
 static size_t nr_quarks = 1;
 static size_t alloc_quarks = 0;
 
+/**
+ * Open-addressed hash table of quarks, keyed on the string; 0 marks an empty
+ * slot.  It is kept at most half full, so probe chains stay short.
+ */
+static quark_t *quark_table;
+static size_t quark_table_size = 0;
+
 #define QUARKS_INIT	16
 
-quark_t quark_add(const char *str)
+/**
+ * Find the hash table slot holding a string, or the empty slot where it
+ * would go
+ */
+static size_t quark_slot(const char *str)
 {
+	size_t mask = quark_table_size - 1;
+	size_t slot = djb2_hash(str) & mask;
+
+	while (quark_table[slot] && strcmp(quarks[quark_table[slot]], str))
+		slot = (slot + 1) & mask;
+
+	return slot;
+}
+
+/**
+ * Make room for at least n quarks in total, rehashing if needed
+ */
+static void quarks_grow(size_t n)
+{
+	size_t size = quark_table_size;
 	quark_t q;
 
-	for (q = 1; q < nr_quarks; q++) {
-		if (!strcmp(quarks[q], str))
-			return q;
+	if (n > alloc_quarks) {
+		while (alloc_quarks < n)
+			alloc_quarks *= 2;
+		quarks = mem_realloc(quarks, alloc_quarks * sizeof(char *));
 	}
 
-	if (nr_quarks == alloc_quarks) {
-		alloc_quarks *= 2;
-		quarks = mem_realloc(quarks, alloc_quarks * sizeof(char *));
+	if (2 * n <= quark_table_size)
+		return;
+
+	while (size < 2 * n)
+		size *= 2;
+
+	mem_free(quark_table);
+	quark_table = mem_zalloc(size * sizeof(quark_t));
+	quark_table_size = size;
+
+	for (q = 1; q < nr_quarks; q++)
+		quark_table[quark_slot(quarks[q])] = q;
+}
+
+quark_t quark_add(const char *str)
+{
+	quark_t q;
+	size_t slot = quark_slot(str);
+
+	if (quark_table[slot])
+		return quark_table[slot];
+
+	if (nr_quarks == alloc_quarks || 2 * (nr_quarks + 1) > quark_table_size) {
+		quarks_grow(nr_quarks + 1);
+		slot = quark_slot(str);
 	}
 
 	q = nr_quarks++;
 	quarks[q] = string_make(str);
+	quark_table[slot] = q;
 
 	return q;
 }
@@ -52,10 +103,19 @@ const char *quark_str(quark_t q)
 	return (q >= nr_quarks ? NULL : quarks[q]);
 }
 
+void quarks_reserve(size_t n)
+{
+	quarks_grow(nr_quarks + n);
+}
+
 void quarks_init(void)
 {
 	alloc_quarks = QUARKS_INIT;
 	quarks = mem_zalloc(alloc_quarks * sizeof(char*));
+	nr_quarks = 1;
+
+	quark_table_size = 2 * QUARKS_INIT;
+	quark_table = mem_zalloc(quark_table_size * sizeof(quark_t));
 }
 
 void quarks_free(void)
@@ -67,6 +127,12 @@ void quarks_free(void)
 		string_free(quarks[i]);
 
 	mem_free(quarks);
+	mem_free(quark_table);
+	quarks = NULL;
+	quark_table = NULL;
+	nr_quarks = 1;
+	alloc_quarks = 0;
+	quark_table_size = 0;
 }
 
 struct init_module z_quark_module = {
@@ -39,6 +39,11 @@ quark_t quark_add(const char *str);
  */
 const char *quark_str(quark_t q);
 
+/**
+ * Make room for 'n' more quarks, e.g. before adding many at once
+ */
+void quarks_reserve(size_t n);
+
 /**
  * Initialise the quarks package
  */
@@ -33,6 +33,13 @@
  * "Rand_value = seed". After that it will be automatically used instead of
  * the "complex" RNG. When you are done, you can de-activate it via
  * "Rand_quick = false". You can also choose a new seed.
+ *
+ * All of that state is global, and makes up the default context.  Code which
+ * wants its own stream of numbers, that neither disturbs nor is disturbed by
+ * the game's, can keep a struct rand_context and use the *_ctx() functions.
+ * A context can use either of the generators above or xoshiro128**, which
+ * is faster still and can be split into independent streams cheaply.
+ * Passing a NULL context to any of those functions means the default one.
  */
 
 /* begin WELL RNG
@@ -57,25 +64,63 @@ u32b STATE[RAND_DEG] = {0, 0, 0, 0, 0, 0, 0, 0,
 						0, 0, 0, 0, 0, 0, 0, 0};
 u32b z0, z1, z2;
 
-#define V0    STATE[state_i]
-#define VM1   STATE[(state_i + M1) & 0x0000001fU]
-#define VM2   STATE[(state_i + M2) & 0x0000001fU]
-#define VM3   STATE[(state_i + M3) & 0x0000001fU]
-#define VRm1  STATE[(state_i + 31) & 0x0000001fU]
-#define newV0 STATE[(state_i + 31) & 0x0000001fU]
-#define newV1 STATE[state_i]
-
-static u32b WELLRNG1024a (void){
-	z0      = VRm1;
-	z1      = Identity(V0) ^ MAT0POS (8, VM1);
-	z2      = MAT0NEG (-19, VM2) ^ MAT0NEG(-14,VM3);
-	newV1   = z1 ^ z2; 
-	newV0   = MAT0NEG (-11,z0) ^ MAT0NEG(-7,z1) ^ MAT0NEG(-13,z2);
-	state_i = (state_i + 31) & 0x0000001fU;
-	return STATE[state_i];
+#define V0    st[*si]
+#define VM1   st[(*si + M1) & 0x0000001fU]
+#define VM2   st[(*si + M2) & 0x0000001fU]
+#define VM3   st[(*si + M3) & 0x0000001fU]
+#define VRm1  st[(*si + 31) & 0x0000001fU]
+#define newV0 st[(*si + 31) & 0x0000001fU]
+#define newV1 st[*si]
+
+static u32b WELLRNG1024a (u32b *st, u32b *si, u32b *z){
+	z[0]    = VRm1;
+	z[1]    = Identity(V0) ^ MAT0POS (8, VM1);
+	z[2]    = MAT0NEG (-19, VM2) ^ MAT0NEG(-14,VM3);
+	newV1   = z[1] ^ z[2]; 
+	newV0   = MAT0NEG (-11,z[0]) ^ MAT0NEG(-7,z[1]) ^ MAT0NEG(-13,z[2]);
+	*si     = (*si + 31) & 0x0000001fU;
+	return st[*si];
 }
 /* end WELL RNG */
 
+/* begin xoshiro128** RNG
+ * Written in 2018 by David Blackman and Sebastiano Vigna, and dedicated to
+ * the public domain.
+ */
+static u32b rotl(u32b x, int k)
+{
+	return (x << k) | (x >> (32 - k));
+}
+
+static u32b xoshiro128ss(u32b *s)
+{
+	u32b result = rotl(s[1] * 5, 7) * 9;
+	u32b t = s[1] << 9;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 11);
+
+	return result;
+}
+
+/* end xoshiro128** RNG */
+
+/**
+ * Step a splitmix32 generator, which turns counting into well mixed numbers
+ */
+static u32b splitmix32(u32b *x)
+{
+	u32b z = (*x += 0x9E3779B9);
+
+	z = (z ^ (z >> 16)) * 0x85EBCA6B;
+	z = (z ^ (z >> 13)) * 0xC2B2AE35;
+	return z ^ (z >> 16);
+}
+
 /**
  * Simple RNG, implemented with a linear congruent algorithm.
  */
@@ -96,29 +141,129 @@ static bool rand_fixed = false;
 static u32b rand_fixval = 0;
 
 /**
- * Initialize the complex RNG using a new seed.
+ * Seed a WELL state table
  */
-void Rand_state_init(u32b seed)
+static void well_seed(u32b *st, u32b *si, u32b seed)
 {
 	int i, j;
 
 	/* Seed the table */
-	STATE[0] = seed;
+	st[0] = seed;
 
 	/* Propagate the seed */
 	for (i = 1; i < RAND_DEG; i++)
-		STATE[i] = LCRNG(STATE[i - 1]);
+		st[i] = LCRNG(st[i - 1]);
 
 	/* Cycle the table ten times per degree */
 	for (i = 0; i < RAND_DEG * 10; i++) {
 		/* Acquire the next index */
-		j = (state_i + 1) % RAND_DEG;
+		j = (*si + 1) % RAND_DEG;
 
 		/* Update the table, extract an entry */
-		STATE[j] += STATE[state_i];
+		st[j] += st[*si];
 
 		/* Advance the index */
-		state_i = j;
+		*si = j;
+	}
+}
+
+/**
+ * Initialize the complex RNG using a new seed.
+ */
+void Rand_state_init(u32b seed)
+{
+	well_seed(STATE, &state_i, seed);
+}
+
+/**
+ * Get the next raw 32-bit number from a context, or the default one
+ */
+static u32b rand_next(struct rand_context *ctx)
+{
+	u32b z[3];
+	u32b r;
+
+	if (!ctx) {
+		if (Rand_quick) return (Rand_value = LCRNG(Rand_value));
+
+		z[0] = z0;
+		z[1] = z1;
+		z[2] = z2;
+		r = WELLRNG1024a(STATE, &state_i, z);
+		z0 = z[0];
+		z1 = z[1];
+		z2 = z[2];
+		return r;
+	}
+
+	switch (ctx->kind) {
+		case RAND_QUICK: return (ctx->value = LCRNG(ctx->value));
+		case RAND_WELL: return WELLRNG1024a(ctx->state, &ctx->state_i, ctx->z);
+		case RAND_XOSHIRO: return xoshiro128ss(ctx->s);
+	}
+
+	assert(0 && "Should never reach here");
+	return 0;
+}
+
+/**
+ * Set up a context to use the given generator, starting from `seed`
+ */
+void Rand_context_init(struct rand_context *ctx, rand_kind kind, u32b seed)
+{
+	int i;
+
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->kind = kind;
+
+	switch (kind) {
+		case RAND_QUICK:
+			ctx->value = seed;
+			break;
+		case RAND_WELL:
+			well_seed(ctx->state, &ctx->state_i, seed);
+			break;
+		case RAND_XOSHIRO:
+			/* Spread the seed over the state with splitmix32 */
+			for (i = 0; i < 4; i++)
+				ctx->s[i] = splitmix32(&seed);
+
+			/* The all-zero state never leaves zero */
+			if (!(ctx->s[0] | ctx->s[1] | ctx->s[2] | ctx->s[3]))
+				ctx->s[0] = 1;
+			break;
+	}
+}
+
+/**
+ * Start a new context whose numbers are independent of those that
+ * `parent` (or the default context, if NULL) goes on to produce.
+ *
+ * The child is seeded from the parent's next numbers, passed through
+ * splitmix32 so that it doesn't simply follow the parent's sequence; a
+ * xoshiro128** child takes all four words of its state that way.  Children
+ * can be split in turn to any depth, and the result depends only on the
+ * parent's state, so splitting is reproducible.
+ */
+void Rand_context_split(struct rand_context *parent, struct rand_context *child)
+{
+	rand_kind kind = parent ? parent->kind :
+		(Rand_quick ? RAND_QUICK : RAND_WELL);
+	u32b x = rand_next(parent);
+
+	Rand_context_init(child, kind, splitmix32(&x));
+
+	if (kind == RAND_XOSHIRO) {
+		int i;
+
+		for (i = 0; i < 4; i++) {
+			x = rand_next(parent);
+			child->s[i] = splitmix32(&x);
+		}
+
+		/* The all-zero state never leaves zero */
+		if (!(child->s[0] | child->s[1] | child->s[2] | child->s[3]))
+			child->s[0] = 1;
 	}
 }
 
@@ -161,7 +306,7 @@ void Rand_init(void)
  * This method has no bias, and is much less affected by patterns in the "low"
  * bits of the underlying RNG's. However, it is potentially non-terminating.
  */
-u32b Rand_div(u32b m)
+u32b Rand_div_ctx(struct rand_context *ctx, u32b m)
 {
 	u32b r, n;
 
@@ -171,43 +316,30 @@ u32b Rand_div(u32b m)
 	/* Hack -- simple case */
 	if (m <= 1) return (0);
 
-	if (rand_fixed)
+	if (rand_fixed && !ctx)
 		return (rand_fixval * 1000 * (m - 1)) / (100 * 1000);
 
 	/* Partition size */
 	n = (0x10000000 / m);
 
-	if (Rand_quick) {
-		/* Use a simple RNG */
-		/* Wait for it */
-		while (1) {
-			/* Cycle the generator */
-			r = (Rand_value = LCRNG(Rand_value));
-
-			/* Mutate a 28-bit "random" number */
-			r = ((r >> 4) & 0x0FFFFFFF) / n;
+	/* Wait for it */
+	while (1) {
+		/* Mutate a 28-bit "random" number */
+		r = ((rand_next(ctx) >> 4) & 0x0FFFFFFF) / n;
 
-			/* Done */
-			if (r < m) break;
-		}
-	} else {
-		/* Use a complex RNG */
-		while (1) {
-			/* Get the next pseudorandom number */
-			r = WELLRNG1024a();
-
-			/* Mutate a 28-bit "random" number */
-			r = ((r >> 4) & 0x0FFFFFFF) / n;
-
-			/* Done */
-			if (r < m) break;
-		}
+		/* Done */
+		if (r < m) break;
 	}
 
 	/* Use the value */
 	return (r);
 }
 
+u32b Rand_div(u32b m)
+{
+	return Rand_div_ctx(NULL, m);
+}
+
 
 /**
  * The number of entries in the "Rand_normal_table"
@@ -280,7 +412,7 @@ static s16b Rand_normal_table[RANDNOR_NUM] = {
  *
  * Note that the binary search takes up to 16 quick iterations.
  */
-s16b Rand_normal(int mean, int stand)
+s16b Rand_normal_ctx(struct rand_context *ctx, int mean, int stand)
 {
 	s16b tmp, offset;
 
@@ -291,7 +423,7 @@ s16b Rand_normal(int mean, int stand)
 	if (stand < 1) return (mean);
 
 	/* Roll for probability */
-	tmp = (s16b)randint0(32768);
+	tmp = (s16b)randint0_ctx(ctx, 32768);
 
 	/* Binary Search */
 	while (low < high) {
@@ -309,17 +441,22 @@ s16b Rand_normal(int mean, int stand)
 	offset = (s16b)((long)stand * (long)low / RANDNOR_STD);
 
 	/* One half should be negative */
-	if (one_in_(2)) return (mean - offset);
+	if (one_in_ctx(ctx, 2)) return (mean - offset);
 
 	/* One half should be positive */
 	return (mean + offset);
 }
 
+s16b Rand_normal(int mean, int stand)
+{
+	return Rand_normal_ctx(NULL, mean, stand);
+}
+
 
 /**
  * Generates damage for "2d6" style dice rolls
  */
-int damroll(int num, int sides)
+int damroll_ctx(struct rand_context *ctx, int num, int sides)
 {
 	int i;
 	int sum = 0;
@@ -327,10 +464,15 @@ int damroll(int num, int sides)
 	if (sides <= 0) return 0;
 
 	for (i = 0; i < num; i++)
-		sum += randint1(sides);
+		sum += randint1_ctx(ctx, sides);
 	return sum;
 }
 
+int damroll(int num, int sides)
+{
+	return damroll_ctx(NULL, num, sides);
+}
+
 
 
 /**
@@ -49,6 +49,28 @@ typedef struct random {
  */
 #define RAND_DEG 32
 
+/**
+ * The generators a rand_context can use.
+ */
+typedef enum {
+	RAND_WELL,		/* WELL1024a, as used by the game */
+	RAND_QUICK,		/* The "simple" linear congruential RNG */
+	RAND_XOSHIRO	/* xoshiro128**, fast and cheaply splittable */
+} rand_kind;
+
+/**
+ * A private stream of random numbers.  Separate contexts share no state,
+ * so each may be used from its own thread.
+ */
+struct rand_context {
+	rand_kind kind;
+	u32b value;
+	u32b state_i;
+	u32b state[RAND_DEG];
+	u32b z[3];
+	u32b s[4];
+};
+
 /**
  * Random aspects used by damcalc, m_bonus_calc, and ranvals
  */
@@ -89,6 +111,13 @@ typedef enum {
  */
 #define one_in_(x) (!randint0(x))
 
+/**
+ * Versions of the above which draw from the given context.
+ */
+#define randint0_ctx(C, M) ((s32b) Rand_div_ctx(C, M))
+#define randint1_ctx(C, M) ((s32b) Rand_div_ctx(C, M) + 1)
+#define one_in_ctx(C, x) (!randint0_ctx(C, x))
+
 /**
  * Whether we are currently using the "quick" method or not.
  */
@@ -119,18 +148,31 @@ void Rand_state_init(u32b seed);
  */
 void Rand_init(void);
 
+/**
+ * Initialise a context to use generator `kind`, seeded with `seed`.
+ */
+void Rand_context_init(struct rand_context *ctx, rand_kind kind, u32b seed);
+
+/**
+ * Initialise `child` as a stream independent of `parent` (or of the default
+ * context, if NULL), advancing the parent.
+ */
+void Rand_context_split(struct rand_context *parent, struct rand_context *child);
+
 /**
  * Generates a random unsigned long integer X where "0 <= X < M" holds.
  *
  * The integer X falls along a uniform distribution.
  */
 u32b Rand_div(u32b m);
+u32b Rand_div_ctx(struct rand_context *ctx, u32b m);
 
 /**
  * Generate a signed random integer within `stand` standard deviations of
  * `mean`, following a normal distribution.
  */
 s16b Rand_normal(int mean, int stand);
+s16b Rand_normal_ctx(struct rand_context *ctx, int mean, int stand);
 
 /**
  * Generate a semi-random number from 0 to m-1, in a way that doesn't affect
@@ -143,6 +185,7 @@ u32b Rand_simple(u32b m);
  * Emulate a number `num` of dice rolls of dice with `sides` sides.
  */
 int damroll(int num, int sides);
+int damroll_ctx(struct rand_context *ctx, int num, int sides);
 
 /**
  * Calculation helper function for damroll
@@ -16,11 +16,255 @@
  *    are included in all such copies.  Other copyrights may also apply.
  */
 #include "z-virt.h"
+#include "z-form.h"
 #include "z-util.h"
 
 unsigned int mem_flags = 0;
 
-#define SZ(uptr)	*((size_t *)((char *)(uptr) - sizeof(size_t)))
+/**
+ * The header in front of every block handed out, recording its size (and
+ * when profiling, where it was allocated)
+ */
+typedef struct mem_header {
+#ifdef MEM_PROFILE
+	struct mem_site *site;
+#endif
+	size_t len;
+} mem_header;
+
+#define MEM_HEADER(p)	((mem_header *)((char *)(p) - sizeof(mem_header)))
+
+/**
+ * ------------------------------------------------------------------------
+ * Allocation profiling
+ * ------------------------------------------------------------------------ */
+#ifdef MEM_PROFILE
+
+/**
+ * Number of call sites the profiler can tell apart; any more are lumped
+ * together
+ */
+#define MEM_SITES_MAX 4096
+
+/**
+ * Allocation counts for one call site
+ */
+struct mem_site {
+	const char *file;
+	int line;
+	u32b allocs;
+	u32b frees;
+	size_t bytes;
+	size_t live;
+	size_t peak;
+};
+
+static struct mem_site mem_sites[MEM_SITES_MAX];
+static struct mem_site mem_site_other = { "(other)", 0, 0, 0, 0, 0, 0 };
+static int mem_num_sites = 0;
+
+/**
+ * Find the call site `file`:`line`, adding it if it is new
+ */
+static struct mem_site *mem_site_find(const char *file, int line)
+{
+	u32b hash = (u32b)line * 2654435761U;
+	const char *c;
+	int i;
+
+	if (!file) file = "(unknown)";
+	for (c = file; *c; c++)
+		hash = (hash ^ (byte)*c) * 16777619U;
+
+	for (i = 0; i < MEM_SITES_MAX; i++) {
+		struct mem_site *site = &mem_sites[(hash + i) % MEM_SITES_MAX];
+
+		if (!site->file) {
+			if (mem_num_sites >= MEM_SITES_MAX / 2) break;
+			if (!mem_num_sites) atexit(mem_profile_dump_at_exit);
+			site->file = file;
+			site->line = line;
+			mem_num_sites++;
+			return site;
+		}
+		if (site->line == line && !strcmp(site->file, file))
+			return site;
+	}
+
+	return &mem_site_other;
+}
+
+static void mem_profile_alloc(mem_header *h, const char *file, int line)
+{
+	struct mem_site *site = mem_site_find(file, line);
+
+	site->allocs++;
+	site->bytes += h->len;
+	site->live += h->len;
+	if (site->live > site->peak)
+		site->peak = site->live;
+	h->site = site;
+}
+
+static void mem_profile_free(mem_header *h)
+{
+	h->site->frees++;
+	h->site->live -= h->len;
+}
+
+static int mem_site_cmp(const void *a, const void *b)
+{
+	const struct mem_site *s1 = *(const struct mem_site * const *)a;
+	const struct mem_site *s2 = *(const struct mem_site * const *)b;
+
+	if (s1->bytes != s2->bytes)
+		return s1->bytes < s2->bytes ? 1 : -1;
+	return s2->allocs - s1->allocs;
+}
+
+/**
+ * Write the allocation counts for each call site to `f`, most bytes first
+ */
+void mem_profile_dump(FILE *f)
+{
+	struct mem_site *sorted[MEM_SITES_MAX + 1];
+	int i, n = 0;
+
+	for (i = 0; i < MEM_SITES_MAX; i++)
+		if (mem_sites[i].file)
+			sorted[n++] = &mem_sites[i];
+	if (mem_site_other.allocs)
+		sorted[n++] = &mem_site_other;
+	qsort(sorted, n, sizeof(sorted[0]), mem_site_cmp);
+
+	fprintf(f, "%-32s %10s %10s %12s %12s %12s\n", "site", "allocs",
+			"frees", "bytes", "live", "peak");
+	for (i = 0; i < n; i++) {
+		char name[64];
+
+		strnfmt(name, sizeof(name), "%s:%d", sorted[i]->file,
+				sorted[i]->line);
+		fprintf(f, "%-32s %10lu %10lu %12lu %12lu %12lu\n", name,
+				(unsigned long)sorted[i]->allocs,
+				(unsigned long)sorted[i]->frees,
+				(unsigned long)sorted[i]->bytes,
+				(unsigned long)sorted[i]->live,
+				(unsigned long)sorted[i]->peak);
+	}
+}
+
+/**
+ * Dump the allocation counts as the program exits, to the file named by the
+ * ANGBAND_MEM_PROFILE environment variable or else to stderr
+ */
+void mem_profile_dump_at_exit(void)
+{
+	const char *path = getenv("ANGBAND_MEM_PROFILE");
+	FILE *f = path ? fopen(path, "w") : NULL;
+
+	mem_profile_dump(f ? f : stderr);
+	if (f) fclose(f);
+}
+
+#else /* MEM_PROFILE */
+
+#define mem_profile_alloc(h, file, line)
+#define mem_profile_free(h)
+
+#endif /* MEM_PROFILE */
+
+/**
+ * ------------------------------------------------------------------------
+ * Size-class pools
+ * ------------------------------------------------------------------------ */
+#ifndef MEM_NO_POOL
+
+/**
+ * Blocks of up to MEM_POOL_MAX bytes are rounded up to a multiple of
+ * MEM_POOL_GRAIN and kept on a free list for their size when freed, rather
+ * than being handed back to malloc().  New blocks are carved from chunks of
+ * MEM_POOL_CHUNK bytes, which are never freed.
+ */
+#define MEM_POOL_GRAIN		16
+#define MEM_POOL_MAX		256
+#define MEM_POOL_CLASSES	(MEM_POOL_MAX / MEM_POOL_GRAIN)
+#define MEM_POOL_CHUNK		65536
+
+#define mem_pool_class(len)	(((len) + MEM_POOL_GRAIN - 1) / MEM_POOL_GRAIN - 1)
+#define mem_is_pooled(len)	((len) <= MEM_POOL_MAX)
+
+static mem_header *mem_pool[MEM_POOL_CLASSES];
+static void *mem_pool_chunks = NULL;
+static char *mem_pool_next = NULL;
+static size_t mem_pool_left = 0;
+
+/**
+ * Take a block able to hold `len` bytes from the pools
+ */
+static mem_header *mem_pool_take(size_t len)
+{
+	int class = mem_pool_class(len);
+	size_t size = sizeof(mem_header) + (class + 1) * MEM_POOL_GRAIN;
+	mem_header *h = mem_pool[class];
+
+	/* Reuse a freed block */
+	if (h) {
+		mem_pool[class] = *(mem_header **)(h + 1);
+		return h;
+	}
+
+	/* Start a new chunk, keeping a list of them */
+	if (mem_pool_left < size) {
+		char *chunk = malloc(MEM_POOL_CHUNK);
+		if (!chunk)
+			quit("Out of Memory!");
+		*(void **)chunk = mem_pool_chunks;
+		mem_pool_chunks = chunk;
+		mem_pool_next = chunk + sizeof(mem_header) + MEM_POOL_GRAIN;
+		mem_pool_left = MEM_POOL_CHUNK - sizeof(mem_header) - MEM_POOL_GRAIN;
+	}
+
+	h = (mem_header *)mem_pool_next;
+	mem_pool_next += size;
+	mem_pool_left -= size;
+	return h;
+}
+
+/**
+ * Return a block of `len` bytes to the pools
+ */
+static void mem_pool_give(mem_header *h, size_t len)
+{
+	int class = mem_pool_class(len);
+
+	*(mem_header **)(h + 1) = mem_pool[class];
+	mem_pool[class] = h;
+}
+
+#else /* MEM_NO_POOL */
+
+#define mem_is_pooled(len)	false
+#define mem_pool_class(len)	0
+#define mem_pool_take(len)	NULL
+#define mem_pool_give(h, len)
+
+#endif /* MEM_NO_POOL */
+
+/**
+ * ------------------------------------------------------------------------
+ * Allocation
+ * ------------------------------------------------------------------------ */
+#ifdef MEM_PROFILE
+#undef mem_alloc
+#undef mem_zalloc
+#undef mem_realloc
+#undef string_make
+#define MEM_SITE_ARGS	, const char *file, int line
+#define MEM_SITE_PASS	, file, line
+#else
+#define MEM_SITE_ARGS
+#define MEM_SITE_PASS
+#endif
 
 /**
  * Allocate `len` bytes of memory.
@@ -31,61 +275,296 @@ unsigned int mem_flags = 0;
  *
  * Doesn't return on out of memory.
  */
-void *mem_alloc(size_t len)
+static void *mem_alloc_aux(size_t len MEM_SITE_ARGS)
 {
-	char *mem;
+	mem_header *h;
 
 	/* Allow allocation of "zero bytes" */
 	if (len == 0) return (NULL);
 
-	mem = malloc(len + sizeof(size_t));
-	if (!mem)
+	if (mem_is_pooled(len))
+		h = mem_pool_take(len);
+	else
+		h = malloc(sizeof(mem_header) + len);
+	if (!h)
 		quit("Out of Memory!");
-	mem += sizeof(size_t);
+	h->len = len;
+	mem_profile_alloc(h, file, line);
 	if (mem_flags & MEM_POISON_ALLOC)
-		memset(mem, 0xCC, len);
-	SZ(mem) = len;
+		memset(h + 1, 0xCC, len);
+
+	return h + 1;
+}
+
+/**
+ * Resize the block `p` to `len` bytes, allocating it if `p` is NULL.
+ */
+static void *mem_realloc_aux(void *p, size_t len MEM_SITE_ARGS)
+{
+	mem_header *h;
+	size_t old_len;
+	void *m;
+
+	/* Fail gracefully */
+	if (len == 0) return (NULL);
+	if (!p) return mem_alloc_aux(len MEM_SITE_PASS);
+
+	h = MEM_HEADER(p);
+	old_len = h->len;
+
+	/* Blocks too big for the pools go back to realloc() */
+	if (!mem_is_pooled(old_len) && !mem_is_pooled(len)) {
+		mem_profile_free(h);
+		h = realloc(h, sizeof(mem_header) + len);
+		if (!h)
+			quit("Out of Memory!");
+		h->len = len;
+		mem_profile_alloc(h, file, line);
+		return h + 1;
+	}
 
+	/* Pooled blocks may already be big enough */
+	if (mem_is_pooled(old_len) && mem_is_pooled(len) &&
+		mem_pool_class(old_len) == mem_pool_class(len)) {
+		mem_profile_free(h);
+		h->len = len;
+		mem_profile_alloc(h, file, line);
+		return p;
+	}
+
+	/* Otherwise move the contents */
+	m = mem_alloc_aux(len MEM_SITE_PASS);
+	memcpy(m, p, MIN(old_len, len));
+	mem_free(p);
+	return m;
+}
+
+#ifdef MEM_PROFILE
+
+void *mem_alloc_at(size_t len, const char *file, int line)
+{
+	return mem_alloc_aux(len, file, line);
+}
+
+void *mem_zalloc_at(size_t len, const char *file, int line)
+{
+	void *mem = mem_alloc_aux(len, file, line);
+	if (mem) memset(mem, 0, len);
 	return mem;
 }
 
+void *mem_realloc_at(void *p, size_t len, const char *file, int line)
+{
+	return mem_realloc_aux(p, len, file, line);
+}
+
+void *mem_alloc(size_t len)
+{
+	return mem_alloc_aux(len, NULL, 0);
+}
+
+void *mem_zalloc(size_t len)
+{
+	return mem_zalloc_at(len, NULL, 0);
+}
+
+void *mem_realloc(void *p, size_t len)
+{
+	return mem_realloc_aux(p, len, NULL, 0);
+}
+
+#else /* MEM_PROFILE */
+
+void *mem_alloc(size_t len)
+{
+	return mem_alloc_aux(len);
+}
+
 void *mem_zalloc(size_t len)
 {
-	void *mem = mem_alloc(len);
-	memset(mem, 0, len);
+	void *mem = mem_alloc_aux(len);
+	if (mem) memset(mem, 0, len);
 	return mem;
 }
 
+void *mem_realloc(void *p, size_t len)
+{
+	return mem_realloc_aux(p, len);
+}
+
+#endif /* MEM_PROFILE */
+
 void mem_free(void *p)
 {
+	mem_header *h;
+
 	if (!p) return;
 
+	h = MEM_HEADER(p);
+	mem_profile_free(h);
 	if (mem_flags & MEM_POISON_FREE)
-		memset(p, 0xCD, SZ(p));
-	free((char *)p - sizeof(size_t));
+		memset(p, 0xCD, h->len);
+	if (mem_is_pooled(h->len))
+		mem_pool_give(h, h->len);
+	else
+		free(h);
 }
 
-void *mem_realloc(void *p, size_t len)
+/**
+ * ------------------------------------------------------------------------
+ * Arenas
+ * ------------------------------------------------------------------------ */
+/**
+ * Alignment of blocks handed out by an arena
+ */
+#define MEM_ARENA_ALIGN	16
+
+/**
+ * A block of memory that an arena hands out pieces of
+ */
+struct mem_arena_block {
+	struct mem_arena_block *next;
+	size_t size;
+	size_t used;
+};
+
+#define MEM_ARENA_DATA(b) \
+	((char *)(b) + ((sizeof(struct mem_arena_block) + MEM_ARENA_ALIGN - 1) \
+					& ~(size_t)(MEM_ARENA_ALIGN - 1)))
+
+/**
+ * An arena: memory that is handed out by bumping a pointer, and given back all
+ * at once
+ */
+struct mem_arena {
+	struct mem_arena_block *blocks;
+	size_t block_size;
+};
+
+static struct mem_arena_block *mem_arena_block_new(size_t size)
 {
-	char *m = p;
+	struct mem_arena_block *b = malloc(MEM_ARENA_DATA((char *)0) - (char *)0
+									   + size);
+	if (!b)
+		quit("Out of Memory!");
+	b->next = NULL;
+	b->size = size;
+	b->used = 0;
+	return b;
+}
 
-	/* Fail gracefully */
-	if (len == 0) return (NULL);
+/**
+ * Make a new arena, which gets memory from the system `block_size` bytes at a
+ * time.
+ */
+struct mem_arena *mem_arena_new(size_t block_size)
+{
+	struct mem_arena *a = mem_zalloc(sizeof(*a));
+	a->block_size = block_size;
+	return a;
+}
 
-	m = realloc(m ? m - sizeof(size_t) : NULL, len + sizeof(size_t));
-	m += sizeof(size_t);
+/**
+ * Allocate `len` bytes from the arena `a`.  The memory lasts until the arena
+ * is reset or freed, and can't be freed by itself.
+ */
+void *mem_arena_alloc(struct mem_arena *a, size_t len)
+{
+	struct mem_arena_block *b = a->blocks;
+	void *mem;
 
-	/* Handle OOM */
-	if (!m) quit("Out of Memory!");
-	SZ(m) = len;
+	if (len == 0) return NULL;
+	len = (len + MEM_ARENA_ALIGN - 1) & ~(size_t)(MEM_ARENA_ALIGN - 1);
 
-	return m;
+	/* Put big requests in a block of their own, behind the current one */
+	if (len > a->block_size) {
+		struct mem_arena_block *big = mem_arena_block_new(len);
+		big->used = len;
+		if (b) {
+			big->next = b->next;
+			b->next = big;
+		} else {
+			a->blocks = big;
+		}
+		return MEM_ARENA_DATA(big);
+	}
+
+	if (!b || b->size - b->used < len) {
+		b = mem_arena_block_new(a->block_size);
+		b->next = a->blocks;
+		a->blocks = b;
+	}
+
+	mem = MEM_ARENA_DATA(b) + b->used;
+	b->used += len;
+	return mem;
+}
+
+/**
+ * Allocate `len` bytes of zeroed memory from the arena `a`.
+ */
+void *mem_arena_zalloc(struct mem_arena *a, size_t len)
+{
+	void *mem = mem_arena_alloc(a, len);
+	if (mem) memset(mem, 0, len);
+	return mem;
+}
+
+/**
+ * Give back everything allocated from the arena `a`, keeping one block for
+ * reuse.
+ */
+void mem_arena_reset(struct mem_arena *a)
+{
+	struct mem_arena_block *b = a->blocks, *next;
+	struct mem_arena_block *keep = NULL;
+
+	while (b) {
+		next = b->next;
+		if (!keep && b->size == a->block_size) {
+			keep = b;
+			keep->next = NULL;
+			keep->used = 0;
+			if (mem_flags & MEM_POISON_FREE)
+				memset(MEM_ARENA_DATA(keep), 0xCD, keep->size);
+		} else {
+			free(b);
+		}
+		b = next;
+	}
+
+	a->blocks = keep;
+}
+
+/**
+ * Free the arena `a` and everything allocated from it.
+ */
+void mem_arena_free(struct mem_arena *a)
+{
+	struct mem_arena_block *b = a->blocks, *next;
+
+	while (b) {
+		next = b->next;
+		free(b);
+		b = next;
+	}
+
+	mem_free(a);
 }
 
 /**
  * Duplicates an existing string `str`, allocating as much memory as necessary.
  */
+#ifdef MEM_PROFILE
+char *string_make(const char *str)
+{
+	return string_make_at(str, NULL, 0);
+}
+
+char *string_make_at(const char *str, const char *file, int line)
+#else
 char *string_make(const char *str)
+#endif
 {
 	char *res;
 	size_t siz;
@@ -95,7 +574,7 @@ char *string_make(const char *str)
 
 	/* Allocate space for the string (including terminator) */
 	siz = strlen(str) + 1;
-	res = mem_alloc(siz);
+	res = mem_alloc_aux(siz MEM_SITE_PASS);
 
 	/* Copy the string (with terminator) */
 	my_strcpy(res, str, siz);
@@ -16,7 +16,8 @@
 
 
 /**
- * Replacements for malloc() and friends that die on failure.
+ * Replacements for malloc() and friends that die on failure.  Small blocks
+ * are recycled through pools of fixed sizes, unless MEM_NO_POOL is defined.
  */
 void *mem_alloc(size_t len);
 void *mem_zalloc(size_t len);
@@ -27,6 +28,35 @@ char *string_make(const char *str);
 void string_free(char *str);
 char *string_append(char *s1, const char *s2);
 
+/**
+ * Arenas, for many short-lived allocations that are all given back together
+ */
+struct mem_arena;
+
+struct mem_arena *mem_arena_new(size_t block_size);
+void *mem_arena_alloc(struct mem_arena *a, size_t len);
+void *mem_arena_zalloc(struct mem_arena *a, size_t len);
+void mem_arena_reset(struct mem_arena *a);
+void mem_arena_free(struct mem_arena *a);
+
+/**
+ * Building with MEM_PROFILE defined counts the allocations made from each
+ * call site, and writes the counts out when the program exits.
+ */
+#ifdef MEM_PROFILE
+void *mem_alloc_at(size_t len, const char *file, int line);
+void *mem_zalloc_at(size_t len, const char *file, int line);
+void *mem_realloc_at(void *p, size_t len, const char *file, int line);
+char *string_make_at(const char *str, const char *file, int line);
+void mem_profile_dump(FILE *f);
+void mem_profile_dump_at_exit(void);
+
+#define mem_alloc(len)			mem_alloc_at((len), __FILE__, __LINE__)
+#define mem_zalloc(len)			mem_zalloc_at((len), __FILE__, __LINE__)
+#define mem_realloc(p, len)		mem_realloc_at((p), (len), __FILE__, __LINE__)
+#define string_make(str)		string_make_at((str), __FILE__, __LINE__)
+#endif
+
 enum {
 	MEM_POISON_ALLOC = 0x00000001,
 	MEM_POISON_FREE  = 0x00000002